@@ -46,6 +46,10 @@ namespace DD4hep {
       typedef Stack::StackEntry                           Entry;
       typedef std::map<unsigned int, TGeoPhysicalNode*>   Cache;
       typedef std::map<std::string,GlobalAlignmentCache*> SubdetectorAlignments;
+      /// Nodes to be processed keyed by (level, path) to apply parents before children
+      typedef std::map<std::pair<unsigned int,std::string>,std::pair<TGeoPhysicalNode*,Entry*> > Nodes;
+      /// Batch mode: aligned nodes pending voxel rebuild and overlap check (precision < 0: no check)
+      typedef std::vector<std::pair<TGeoPhysicalNode*,double> > Deferred;
 
     protected:
       LCDD&       m_lcdd;
@@ -60,8 +64,12 @@ namespace DD4hep {
       size_t      m_sdPathLen;
       /// Reference count
       int         m_refCount;
+      /// Batch mode: nodes aligned, but with pending voxel rebuild and overlap check
+      Deferred    m_deferred;
       /// Flag to indicate the top instance
       bool        m_top;
+      /// Flag to apply alignments in batch mode (voxels rebuilt once per commit). Default: false
+      bool        m_batch;
 
     protected:
       /// Default constructor initializing variables
@@ -78,6 +86,8 @@ namespace DD4hep {
       void apply(const std::vector<Entry*> &changes);
       /// Add a new entry to the cache. The key is the placement path
       bool insert(GlobalAlignment alignment);
+      /// Batch mode: Rebuild voxels of all touched mother volumes and run the deferred overlap checks
+      void finalizeBatch();
 
     public:
       /// Create and install a new instance tree
@@ -90,6 +100,10 @@ namespace DD4hep {
       int release();
       /// Access the section name
       const std::string& name() const   {   return m_sdPath;  }
+      /// Access the batch mode flag
+      bool batchMode() const            {   return m_batch;   }
+      /// Enable/disable batch mode. In batch mode voxels are rebuilt once per commit.
+      void setBatchMode(bool value)     {   m_batch = value;  }
       /// Close existing transaction stack and apply all alignments
       void commit(GlobalAlignmentStack& stack);
       /// Retrieve the cache section corresponding to the path of an entry.
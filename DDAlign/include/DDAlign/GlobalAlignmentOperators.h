@@ -35,7 +35,7 @@ namespace DD4hep {
       typedef GlobalAlignmentStack::StackEntry  Entry;
       typedef GlobalAlignmentCache::Cache       Cache;
       typedef std::vector<Entry*>               Entries;
-      typedef std::map<std::string,std::pair<TGeoPhysicalNode*,Entry*> > Nodes;
+      typedef GlobalAlignmentCache::Nodes       Nodes;
       GlobalAlignmentCache& cache;
       Nodes& nodes;
 
@@ -44,6 +44,10 @@ namespace DD4hep {
       GlobalAlignmentOperator(GlobalAlignmentCache& c, Nodes& n) : cache(c), nodes(n) {}
       /// Insert alignment entry
       void insert(GlobalAlignment alignment)  const;
+      /// Batch mode: register aligned node for deferred voxel rebuild and overlap check
+      void defer(TGeoPhysicalNode* node, bool check, double overlap)  const;
+      /// Access the integer node key of a placement path: sorts parents before children
+      static Nodes::key_type nodeKey(const std::string& path);
     };
 
     /// Select alignment operations according to certain criteria
@@ -54,12 +58,13 @@ namespace DD4hep {
      */
     class GlobalAlignmentSelector : public GlobalAlignmentOperator {
     public:
+      /// Index of the changes by path hash: (position in entries, entry). Hash clashes are resolved by the path
+      typedef std::multimap<unsigned int,std::pair<size_t,Entry*> > Index;
       const Entries& entries;
+      /// Changes which affect existing cache entries indexed by their path hash
+      Index index;
       /// Initializing functor constructor
-      GlobalAlignmentSelector(GlobalAlignmentCache& c, Nodes& n, const Entries& e)
-        : GlobalAlignmentOperator(c,n), entries(e)
-      {
-      }
+      GlobalAlignmentSelector(GlobalAlignmentCache& c, Nodes& n, const Entries& e);
       const GlobalAlignmentSelector& reset()   const {
         nodes.clear();
         return *this;
@@ -20,6 +20,10 @@
 
 // ROOT include files
 #include "TGeoManager.h"
+#include "TGeoVoxelFinder.h"
+
+// C/C++ include files
+#include <set>
 
 using namespace std;
 using namespace DD4hep;
@@ -41,7 +45,7 @@ DetElement _detector(DetElement child)   {
 
 /// Default constructor
 GlobalAlignmentCache::GlobalAlignmentCache(LCDD& lcdd, const string& sdPath, bool top)
-  : m_lcdd(lcdd), m_sdPath(sdPath), m_sdPathLen(sdPath.length()), m_refCount(1), m_top(top)
+  : m_lcdd(lcdd), m_sdPath(sdPath), m_sdPathLen(sdPath.length()), m_refCount(1), m_top(top), m_batch(false)
 {
 }
 
@@ -176,6 +180,7 @@ GlobalAlignmentCache* GlobalAlignmentCache::subdetectorAlignments(const string&
   SubdetectorAlignments::const_iterator i = m_detectors.find(nam);
   if ( i == m_detectors.end() )   {
     GlobalAlignmentCache* ptr = new GlobalAlignmentCache(m_lcdd,nam,false);
+    ptr->m_batch = m_batch;
     m_detectors.insert(make_pair(nam,ptr));
     return ptr;
   }
@@ -202,6 +207,7 @@ void GlobalAlignmentCache::apply(GlobalAlignmentStack& stack)    {
     DetElement det((*i).first);
     GlobalAlignmentCache* sd_cache = subdetectorAlignments(det.placement().name());
     sd_cache->apply( (*i).second );
+    sd_cache->finalizeBatch();
     (*i).second.clear();
   }
 
@@ -237,7 +243,6 @@ void GlobalAlignmentCache::apply(GlobalAlignmentStack& stack)    {
 
 /// Apply a vector of SD entries of ordered alignments to the geometry structure
 void GlobalAlignmentCache::apply(const vector<Entry*>& changes)   {
-  typedef map<string,pair<TGeoPhysicalNode*,Entry*> > Nodes;
   Nodes nodes;
   GlobalAlignmentSelector selector(*this,nodes,changes);
   for_each(m_cache.begin(),m_cache.end(),selector.reset());
@@ -248,3 +253,35 @@ void GlobalAlignmentCache::apply(const vector<Entry*>& changes)   {
   for_each(nodes.begin(),nodes.end(),GlobalAlignmentActor<node_align>(*this,nodes));
   for_each(nodes.begin(),nodes.end(),GlobalAlignmentActor<node_delete>(*this,nodes));
 }
+
+/// Batch mode: Rebuild voxels of all touched mother volumes and run the deferred overlap checks
+void GlobalAlignmentCache::finalizeBatch()   {
+  set<TGeoVolume*> mothers;
+  size_t num_checks = 0;
+  if ( m_deferred.empty() )  {
+    return;
+  }
+  for(Deferred::const_iterator i=m_deferred.begin(); i!=m_deferred.end(); ++i)  {
+    TGeoPhysicalNode* pn = (*i).first;
+    int level = pn->GetLevel();
+    if ( level > 0 ) mothers.insert(pn->GetVolume(level-1));
+  }
+  for(set<TGeoVolume*>::const_iterator i=mothers.begin(); i!=mothers.end(); ++i)  {
+    TGeoVolume* vol = *i;
+    TGeoVoxelFinder* vox = vol->GetVoxels();
+    if ( vox && vox->NeedRebuild() )  {
+      vox->Voxelize();
+      vol->FindOverlaps();
+    }
+  }
+  for(Deferred::const_iterator i=m_deferred.begin(); i!=m_deferred.end(); ++i)  {
+    if ( (*i).second >= 0e0 )  {
+      (*i).first->GetNode()->CheckOverlaps((*i).second);
+      ++num_checks;
+    }
+  }
+  printout(INFO,"GlobalAlignmentCache",
+           "Section: %s [batch] %ld node(s) aligned, %ld mother volume(s) revoxelized, %ld overlap check(s).",
+           name().c_str(), long(m_deferred.size()), long(mothers.size()), long(num_checks));
+  m_deferred.clear();
+}
@@ -20,38 +20,87 @@
 
 // C/C++ include files
 #include <stdexcept>
+#include <algorithm>
 
 using namespace std;
 using namespace DD4hep;
 using namespace DD4hep::Alignments;
 
+namespace {
+  /// One-at-time hash without final avalanche: allows to hash all path prefixes in one pass
+  inline unsigned int _hash_add(unsigned int hash, char c)   {
+    hash += c;
+    hash += (hash << 10);
+    hash ^= (hash >> 6);
+    return hash;
+  }
+  /// Final avalanche of the one-at-time hash. _hash_final(_hash_add(...)) == hash32(...)
+  inline unsigned int _hash_final(unsigned int hash)   {
+    hash += (hash << 3);
+    hash ^= (hash >> 11);
+    hash += (hash << 15);
+    return hash;
+  }
+}
+
 void GlobalAlignmentOperator::insert(GlobalAlignment alignment)  const   {
   if ( !cache.insert(alignment) )     {
     // Error
   }
 }
 
+void GlobalAlignmentOperator::defer(TGeoPhysicalNode* node, bool check, double overlap)  const   {
+  cache.m_deferred.push_back(make_pair(node, check ? overlap : -1e0));
+}
+
+GlobalAlignmentOperator::Nodes::key_type GlobalAlignmentOperator::nodeKey(const string& path)   {
+  unsigned int level = count(path.begin(),path.end(),'/');
+  return make_pair(level,path);
+}
+
+GlobalAlignmentSelector::GlobalAlignmentSelector(GlobalAlignmentCache& c, Nodes& n, const Entries& e)
+  : GlobalAlignmentOperator(c,n), entries(e)
+{
+  for(size_t i=0; i<entries.size(); ++i)   {
+    Entry* ent = entries[i];
+    if ( GlobalAlignmentStack::needsReset(*ent) || GlobalAlignmentStack::hasMatrix(*ent) )
+      index.insert(make_pair(hash32(ent->path),make_pair(i,ent)));
+  }
+}
+
 void GlobalAlignmentSelector::operator()(Entries::value_type e)  const {
   TGeoPhysicalNode* pn = 0;
-  nodes.insert(make_pair(e->path,make_pair(pn,e)));
+  nodes.insert(make_pair(nodeKey(e->path),make_pair(pn,e)));
 }
 
 void GlobalAlignmentSelector::operator()(const Cache::value_type& entry)  const {
+  if ( index.empty() )  {
+    return;
+  }
+  // Walk the path prefixes of the node once. The exact path matches any change,
+  // a parent path only a change resetting its children. The first change in
+  // the order of the entries wins.
   TGeoPhysicalNode* pn = entry.second;
-  for(Entries::const_iterator j=entries.begin(); j != entries.end(); ++j)   {
-    Entries::value_type e = (*j);
-    if ( GlobalAlignmentStack::needsReset(*e) || GlobalAlignmentStack::hasMatrix(*e) )  {
-      const char* p = pn->GetName();
-      bool reset_children = GlobalAlignmentStack::resetChildren(*e);
-      if ( reset_children && ::strstr(p,e->path.c_str()) == p )   {
-        nodes.insert(make_pair(p,make_pair(pn,e)));
-        break;
-      }
-      else if ( e->path == p )  {
-        nodes.insert(make_pair(p,make_pair(pn,e)));
-        break;
+  const char* p = pn->GetName();
+  const Index::value_type::second_type* match = 0;
+  unsigned int hash = 0;
+  for(const char* c=p; ; ++c)   {
+    if ( (*c == '/' && c != p) || *c == 0 )   {
+      pair<Index::const_iterator,Index::const_iterator> r = index.equal_range(_hash_final(hash));
+      for(Index::const_iterator i = r.first; i != r.second; ++i)   {
+        const Index::mapped_type& m = (*i).second;
+        const string& path = m.second->path;
+        if ( path.length() != size_t(c-p) || path.compare(0,path.length(),p,c-p) != 0 )
+          continue;
+        if ( (*c == 0 || GlobalAlignmentStack::resetChildren(*m.second)) && (!match || m.first < match->first) )
+          match = &m;
       }
     }
+    if ( *c == 0 ) break;
+    hash = _hash_add(hash,*c);
+  }
+  if ( match )  {
+    nodes.insert(make_pair(nodeKey(p),make_pair(pn,match->second)));
   }
 }
 
@@ -142,7 +191,13 @@ template <> void GlobalAlignmentActor<DDAlign_standard_operations::node_align>::
   else if ( delta.checkFlag(Delta::HAVE_TRANSLATION) )
     trafo = Transform3D(delta.translation);
 
-  if ( GlobalAlignmentStack::checkOverlap(e) && overlap )
+  if ( cache.batchMode() )  {
+    // Voxels are rebuilt and overlaps checked once all nodes are aligned
+    align = no_vol ? ad.align(trafo,false) : ad.align(e.path,trafo,false);
+    if ( align.isValid() )
+      defer(align.ptr(), GlobalAlignmentStack::checkOverlap(e), ovl_precision);
+  }
+  else if ( GlobalAlignmentStack::checkOverlap(e) && overlap )
     align = no_vol ? ad.align(trafo,ovl_precision,e.overlap) : ad.align(e.path,trafo,ovl_precision,e.overlap);
   else if ( GlobalAlignmentStack::checkOverlap(e) )
     align = no_vol ? ad.align(trafo,ovl_precision) : ad.align(e.path,trafo,ovl_precision);
@@ -29,6 +29,7 @@
 
 // C/C++ include files
 #include <stdexcept>
+#include <cstring>
 
 namespace DD4hep  {
 
@@ -268,13 +269,22 @@ static long setup_Alignment(lcdd_t& lcdd, const xml_h& e) {
 DECLARE_XML_DOC_READER(global_alignment,setup_Alignment)
 
 /** Basic entry point to install the alignment cache in a LCDD instance
+ *
+ *  Arguments: -batch   : Rebuild voxels and check overlaps once per commit
+ *             -nobatch : Let TGeo refresh voxels for every aligned node (default)
  *
  *  @author  M.Frank
  *  @version 1.0
  *  @date    01/04/2014
  */
-static long install_Alignment(lcdd_t& lcdd, int, char**) {
-  GlobalAlignmentCache::install(lcdd);
+static long install_Alignment(lcdd_t& lcdd, int argc, char** argv) {
+  GlobalAlignmentCache* cache = GlobalAlignmentCache::install(lcdd);
+  for(int i=0; i<argc && argv[i]; ++i)  {
+    if ( ::strcmp(argv[i],"-nobatch")==0 )
+      cache->setBatchMode(false);
+    else if ( ::strcmp(argv[i],"-batch")==0 )
+      cache->setBatchMode(true);
+  }
   return 1;
 }
 DECLARE_APPLY(DD4hep_GlobalAlignmentInstall,install_Alignment)
@@ -0,0 +1,106 @@
+//==========================================================================
+//  AIDA Detector description implementation for LCD
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Frank
+//
+//==========================================================================
+#ifndef DDCOND_CONDITIONSBINARYFORMAT_H
+#define DDCOND_CONDITIONSBINARYFORMAT_H
+
+/// Namespace for the AIDA detector description toolkit
+namespace DD4hep {
+
+  /// Namespace for the geometry part of the AIDA detector description toolkit
+  namespace Conditions {
+
+    /// Layout of binary conditions repository files
+    /**
+     *  The file is designed to be mapped into memory and used in place:
+     *  - the header
+     *  - the IOV type table
+     *  - the IOV table
+     *  - the entry table, sorted by condition key, IOV type and IOV lower bound
+     *  - the data block with names, data types and payloads (no null termination)
+     *
+     *  All offsets are relative to the begin of the file.
+     *  Files are written by the ConditionsBinaryRepositoryWriter and read
+     *  by the conditions data loader DD4hep_Conditions_binary_Loader.
+     *
+     *  \author  M.Frank
+     *  \version 1.0
+     *  \ingroup DD4HEP_CONDITIONS
+     */
+    namespace ConditionsBinaryFormat  {
+
+      /// File header
+      struct Header  {
+        char               magic[8];
+        unsigned int       version;
+        unsigned int       num_iov_types;
+        unsigned int       num_iovs;
+        unsigned int       spare;
+        unsigned long long num_entries;
+        unsigned long long iov_types;
+        unsigned long long iovs;
+        unsigned long long entries;
+        unsigned long long data;
+        unsigned long long size;
+      };
+      /// IOV type table record
+      struct IOVTypeEntry  {
+        unsigned int       id;
+        unsigned int       name_length;
+        unsigned long long name_offset;
+      };
+      /// IOV table record
+      struct IOVEntry  {
+        unsigned int       iov_type;
+        unsigned int       spare;
+        long long          lower;
+        long long          upper;
+      };
+      /// Entry table record: one per condition and IOV
+      struct Entry  {
+        unsigned long long key;
+        unsigned int       iov;
+        unsigned int       flags;
+        unsigned int       kind;
+        unsigned int       name_length;
+        unsigned int       type_length;
+        unsigned int       spare;
+        unsigned long long name_offset;
+        unsigned long long type_offset;
+        unsigned long long data_offset;
+        unsigned long long data_length;
+      };
+      /// Payload of alignment deltas
+      struct Delta  {
+        unsigned int       flags;
+        unsigned int       spare;
+        double             translation[3];
+        double             pivot[3];
+        double             rotation[3];   // Z, Y, X
+      };
+      /// Payload encodings
+      enum PayloadKind  {
+        KIND_TEXT    = 0,    // Data type and text representation bound with the OpaqueDataBinder
+        KIND_DOUBLE  = 1,    // Binary double
+        KIND_INT     = 2,    // Binary int (32 bit)
+        KIND_LONG    = 3,    // Binary long (64 bit)
+        KIND_STRING  = 4,    // Raw characters of a std::string
+        KIND_DELTA   = 5     // Binary alignment delta
+      };
+      /// Magic word identifying binary conditions files
+      static const char         MAGIC[8] = {'D','D','C','O','N','D','B','N'};
+      /// Current format version
+      static const unsigned int VERSION  = 1;
+    }
+  }        /* End namespace Conditions               */
+}          /* End namespace DD4hep                   */
+#endif     /* DDCOND_CONDITIONSBINARYFORMAT_H        */
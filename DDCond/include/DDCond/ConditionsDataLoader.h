@@ -61,12 +61,16 @@ namespace DD4hep {
       ConditionsManager m_mgr;
       /// Property: input data source definitions
       Sources           m_sources;
+      /// Flag to leave the registration of loaded conditions to the caller
+      bool              m_deferRegistration = false;
 
     protected:
       /// Queue update to manager.
       //Condition queueUpdate(Entry* data);
       /// Push update to manager.
       void pushUpdates();
+      /// Register a loaded condition to its IOV pool. If deferred only attach the pool.
+      void registerCondition(ConditionsPool* pool, Condition cond);
 
     public:
       /// Default constructor
@@ -75,6 +79,11 @@ namespace DD4hep {
       virtual ~ConditionsDataLoader();
       /// Add data source definition to loader
       void addSource(const std::string& source, const iov_type& iov);
+      /// Leave the registration of loaded, not yet ACTIVE conditions to the caller.
+      /** If supported, load_many may also be called concurrently.
+       *  Returns false if the loader does not support deferred registration.
+       */
+      virtual bool deferRegistration(bool value);
       /// Load  a condition set given the conditions key according to their validity
       virtual size_t load_single(key_type         key,
                                  const iov_type&  req_validity,
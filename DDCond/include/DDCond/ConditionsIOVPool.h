@@ -18,6 +18,7 @@
 
 // C/C++ include files
 #include <map>
+#include <vector>
 
 /// Namespace for the AIDA detector description toolkit
 namespace DD4hep {
@@ -42,15 +43,67 @@ namespace DD4hep {
       typedef ConditionsPool*              Element;
       typedef std::map<IOV::Key, Element > Elements;      
 
-      /// Container of IOV dependent conditions pools
-      Elements elements;
+    protected:
+      /// Container of IOV dependent conditions pools. Only modified by insert and clean
+      Elements      m_elements;
+
+    public:
+      /// Read access to the container of IOV dependent conditions pools
+      const Elements& elements;
       const IOVType* type;
+
+    protected:
+      /// Node of the interval index over the IOV keys of the pools
+      /** The nodes are sorted by IOV key and form an implicit balanced
+       *  binary tree: the root of the range [lo,hi) is at (lo+hi)/2.
+       *  Each node carries the largest upper IOV bound of its subtree,
+       *  which allows to prune subtrees without any match.
+       *  The age of a pool is derived on access from the selection cycle
+       *  of this container and the cycle stamped into the pool.
+       */
+      struct Node  {
+        /// IOV key of the pool
+        IOV::Key              key;
+        /// Largest upper IOV bound within the subtree rooted at this node
+        IOV::Key_second_type  max_upper;
+        /// Reference to the conditions pool
+        Element               pool;
+      };
+      typedef std::vector<Node> Index;
+
+      /// Interval index over the elements
+      Index         m_index;
+      /// Counter of aging selections. The age of a pool is m_cycle - pool->age_stamp
+      long long int m_cycle = 0;
+      /// Modification counter of the elements
+      unsigned long m_modifications = 0;
+      /// Value of the modification counter when the index was built
+      unsigned long m_indexed = 0;
+
+      /// Rebuild the interval index from the elements
+      void buildIndex();
+      /// Rebuild the index if the elements were modified since the last build
+      void checkIndex()  {  if ( m_indexed != m_modifications ) buildIndex(); }
+      /// Recursively visit all nodes, which contain the IOV range 'req'
+      template <typename PROC>
+      void scanContaining(const IOV::Key& req, size_t lo, size_t hi, PROC& proc);
+      /// Recursively visit all nodes with either edge within the IOV range 'req'
+      template <typename PROC>
+      void scanOverlapping(const IOV::Key& req, size_t lo, size_t hi, PROC& proc);
       
     public:
       /// Default constructor
       ConditionsIOVPool(const IOVType* type);
+      /// Inhibit copy constructor
+      ConditionsIOVPool(const ConditionsIOVPool& copy) = delete;
       /// Default destructor
       virtual ~ConditionsIOVPool();
+      /// Inhibit assignment
+      ConditionsIOVPool& operator=(const ConditionsIOVPool& copy) = delete;
+      /// Add a new pool for the given IOV key. Returns the existing pool if present
+      Element insert(const IOV::Key& key, Element pool);
+      /// Reset the age of a pool without selecting it
+      void touch(Element pool);
       /// Retrieve  a condition set given the key according to their validity
       size_t select(Condition::key_type key, const Condition::iov_type& req_validity, RangeConditions& result);
       /// Retrieve  a condition set given the key according to their validity
@@ -74,6 +74,8 @@ namespace DD4hep {
       bool                   m_doLoad = true;
       /// Property: Flag to indicate if unloaded items should be saved to the slice (or not)
       bool                   m_doOutputUnloaded = false;
+      /// Property: Flag to refresh user pools incrementally on IOV transitions (or not)
+      bool                   m_doIncremental = false;
 
       /// Register callback listener object
       void registerCallee(Listeners& listeners, const Listener& callee, bool add);
@@ -98,6 +100,9 @@ namespace DD4hep {
       /// Access to flag to indicate if unloaded items should be saved to the slice (or not)
       bool doOutputUnloaded()  const        {  return m_doOutputUnloaded;  }
 
+      /// Access to flag to indicate if user pools are refreshed incrementally
+      bool doIncrementalUpdate()  const     {  return m_doIncremental;     }
+
       /// Listener invocation when a condition is registered to the cache
       void onRegister(Condition condition);
 
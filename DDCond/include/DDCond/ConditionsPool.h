@@ -68,8 +68,10 @@ namespace DD4hep {
       const IOVType*   iovType;
       /// The IOV of the conditions hosted
       IOV*             iov;
-      /// Aging value
-      int              age_value;
+      /// Selection cycle counter of the IOV pool holding this pool (0 if not held)
+      const long long int* age_cycle;
+      /// Value of the selection cycle when the pool was last selected
+      long long int    age_stamp;
 
     public:
       /// Listener invocation when a condition is registered to the cache
@@ -84,6 +86,12 @@ namespace DD4hep {
       virtual ~ConditionsPool();
       /// Print pool basics
       void print(const std::string& opt)   const;
+      /// Aging value: number of selections of the IOV pool since this pool was last selected
+      int age()  const  {
+        return age_cycle ? int(*age_cycle - age_stamp) : int(AGE_NONE);
+      }
+      /// Flag if insertions and selections may be executed concurrently without external lock
+      virtual bool isConcurrent()  const   {  return false;  }
       /// Total entry count
       virtual size_t size()  const = 0;
       /// Full cleanup of all managed conditions.
@@ -157,6 +165,8 @@ namespace DD4hep {
       const IOV& validity() const    {  return m_iov;  }
       /// Access the interval of validity for this user pool
       const IOV* validityPtr() const {  return &m_iov; }
+      /// Flag if the content is refreshed incrementally and may contain derived conditions of older IOVs
+      virtual bool isIncremental() const  {  return false;  }
       /// Print pool content
       virtual void print(const std::string& opt) const = 0;
       /// Total entry count
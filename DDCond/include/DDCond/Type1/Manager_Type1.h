@@ -134,7 +134,7 @@ namespace DD4hep {
       /// Access conditions multi IOV pool by iov type
       ConditionsIOVPool* iovPool(const IOVType& type)  const  final;
 
-      /// Register new condition with the conditions store. Unlocked version, not multi-threaded
+      /// Register new condition with the conditions store. Unlocked version: the update pool is not locked
       virtual bool registerUnlocked(ConditionsPool* pool, Condition cond)  final;
 
       /// Clean conditions, which are above the age limit.
@@ -14,6 +14,8 @@
 // Framework include files
 #include "DDCond/ConditionsDataLoader.h"
 #include "DDCond/ConditionsManagerObject.h"
+#include "DDCond/ConditionsPool.h"
+#include "DD4hep/objects/ConditionsInterna.h"
 #include "DD4hep/Handle.inl"
 #include "DD4hep/Printout.h"
 
@@ -39,6 +41,21 @@ void ConditionsDataLoader::addSource(const string& source, const IOV& iov)   {
   m_sources.push_back(make_pair(source,iov));
 }
 
+/// Leave the registration of loaded, not yet ACTIVE conditions to the caller.
+bool ConditionsDataLoader::deferRegistration(bool /* value */)   {
+  return false;
+}
+
+/// Register a loaded condition to its IOV pool. If deferred only attach the pool.
+void ConditionsDataLoader::registerCondition(ConditionsPool* pool, Condition cond)   {
+  if ( m_deferRegistration )  {
+    cond->pool = pool;
+    cond->iov  = pool->iov;
+    return;
+  }
+  m_mgr.registerUnlocked(pool, cond);
+}
+
 /// Queue update to manager.
 //Condition ConditionsDataLoader::queueUpdate(Entry* data)   {
 //  return m_mgr->__queue_update(data);
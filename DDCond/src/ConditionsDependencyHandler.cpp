@@ -55,6 +55,10 @@ Condition ConditionsDependencyHandler::get(Condition::key_type key)  const  {
       m_pool.remove(key);
       return do_callback(*dep);
     }
+    /// Not scheduled for re-computation: an incrementally refreshed pool kept
+    /// the derived condition on purpose, because none of its inputs changed.
+    if ( m_pool.isIncremental() && (obj->flags&Condition::DERIVED) )
+      return c;
   }
   Dependencies::const_iterator i = m_dependencies.find(key);
   if ( i != m_dependencies.end() )   {
@@ -18,11 +18,14 @@
 #include "DD4hep/objects/ConditionsInterna.h"
 #include "DDCond/ConditionsDataLoader.h"
 
+// C/C++ include files
+#include <algorithm>
+
 using namespace DD4hep;
 using namespace DD4hep::Conditions;
 
 /// Default constructor
-ConditionsIOVPool::ConditionsIOVPool(const IOVType* typ) : type(typ)  {
+ConditionsIOVPool::ConditionsIOVPool(const IOVType* typ) : elements(m_elements), type(typ)  {
   InstanceCount::increment(this);
 }
 
@@ -32,16 +35,101 @@ ConditionsIOVPool::~ConditionsIOVPool()  {
   InstanceCount::decrement(this);
 }
 
+/// Add a new pool for the given IOV key. Returns the existing pool if present
+ConditionsIOVPool::Element ConditionsIOVPool::insert(const IOV::Key& key, Element pool)  {
+  Elements::const_iterator i = m_elements.find(key);
+  if ( i != m_elements.end() )  {
+    return (*i).second;
+  }
+  pool->age_cycle = &m_cycle;
+  pool->age_stamp = m_cycle;
+  m_elements.insert(make_pair(key,pool));
+  ++m_modifications;
+  return pool;
+}
+
+/// Reset the age of a pool without selecting it
+void ConditionsIOVPool::touch(Element pool)   {
+  if ( pool->age_cycle == &m_cycle ) pool->age_stamp = m_cycle;
+}
+
+/// Rebuild the interval index from the elements
+void ConditionsIOVPool::buildIndex()   {
+  m_index.clear();
+  m_index.reserve(m_elements.size());
+  m_indexed = m_modifications;
+  for(const auto& i : m_elements )  {
+    Node n;
+    n.key       = i.first;
+    n.max_upper = i.first.second;
+    n.pool      = i.second;
+    m_index.push_back(n);
+  }
+  // Propagate the largest upper bound bottom-up through the implicit tree
+  struct Builder  {
+    Index& idx;
+    Builder(Index& i) : idx(i) {}
+    IOV::Key_second_type operator()(size_t lo, size_t hi)  {
+      size_t mid = (lo+hi)/2;
+      Node&  n   = idx[mid];
+      if ( lo < mid ) n.max_upper = std::max(n.max_upper, (*this)(lo, mid));
+      if ( mid+1 < hi ) n.max_upper = std::max(n.max_upper, (*this)(mid+1, hi));
+      return n.max_upper;
+    }
+  };
+  if ( !m_index.empty() )  {
+    Builder builder(m_index);
+    builder(0, m_index.size());
+  }
+}
+
+/// Recursively visit all nodes, which contain the IOV range 'req'
+template <typename PROC>
+void ConditionsIOVPool::scanContaining(const IOV::Key& req, size_t lo, size_t hi, PROC& proc)  {
+  while ( lo < hi )  {
+    size_t mid = (lo+hi)/2;
+    Node&  n   = m_index[mid];
+    // No interval in this subtree reaches up to the end of the requested range
+    if ( n.max_upper < req.second ) return;
+    scanContaining(req, lo, mid, proc);
+    // Keys are sorted by their lower bound: everything right of here starts too late
+    if ( n.key.first > req.first ) return;
+    if ( n.key.second >= req.second ) proc(n);
+    lo = mid+1;
+  }
+}
+
+/// Recursively visit all nodes with either edge within the IOV range 'req'
+template <typename PROC>
+void ConditionsIOVPool::scanOverlapping(const IOV::Key& req, size_t lo, size_t hi, PROC& proc)  {
+  while ( lo < hi )  {
+    size_t mid = (lo+hi)/2;
+    Node&  n   = m_index[mid];
+    if ( n.max_upper < req.first ) return;
+    scanOverlapping(req, lo, mid, proc);
+    if ( n.key.first > req.second ) return;
+    const IOV::Key& k = n.key;
+    if ( IOV::key_is_contained(k,req) )
+      // IOV test contained in key. Take it!
+      proc(n);
+    else if ( IOV::key_overlaps_lower_end(k,req) )
+      // IOV overlap on test on the lower end of key
+      proc(n);
+    else if ( IOV::key_overlaps_higher_end(k,req) )
+      // IOV overlap of test on the higher end of key
+      proc(n);
+    lo = mid+1;
+  }
+}
+
 size_t ConditionsIOVPool::select(Condition::key_type key, const Condition::iov_type& req_validity, RangeConditions& result)
 {
   if ( !elements.empty() )  {
     size_t len = result.size();
     const IOV::Key req_key = req_validity.key(); // 16 bytes => better copy!
-    for(Elements::const_iterator i=elements.begin(); i!=elements.end(); ++i)  {
-      if ( IOV::key_contains_range((*i).first, req_key) )  {
-        (*i).second->select(key, result);
-      }
-    }
+    auto proc = [key,&result](Node& n)  {  n.pool->select(key, result);  };
+    checkIndex();
+    scanContaining(req_key, 0, m_index.size(), proc);
     return result.size() - len;
   }
   return 0;
@@ -51,18 +139,9 @@ size_t ConditionsIOVPool::selectRange(Condition::key_type key, const Condition::
 {
   size_t len = result.size();
   const IOV::Key range = req_validity.key();
-  for(Elements::const_iterator i=elements.begin(); i!=elements.end(); ++i)  {
-    const IOV::Key& k = (*i).first;
-    if ( IOV::key_is_contained(k,range) )
-      // IOV test contained in key. Take it!
-      (*i).second->select(key, result);
-    else if ( IOV::key_overlaps_lower_end(k,range) )
-      // IOV overlap on test on the lower end of key
-      (*i).second->select(key, result);
-    else if ( IOV::key_overlaps_higher_end(k,range) )
-      // IOV overlap of test on the higher end of key
-      (*i).second->select(key, result);
-  }
+  auto proc = [key,&result](Node& n)  {  n.pool->select(key, result);  };
+  checkIndex();
+  scanOverlapping(range, 0, m_index.size(), proc);
   return result.size() - len;
 }
 
@@ -70,9 +149,9 @@ size_t ConditionsIOVPool::selectRange(Condition::key_type key, const Condition::
 int ConditionsIOVPool::clean(int max_age)   {
   Elements rest;
   int count = 0;
-  for(Elements::const_iterator i=elements.begin(); i!=elements.end(); ++i)  {
+  for(Elements::const_iterator i=m_elements.begin(); i!=m_elements.end(); ++i)  {
     ConditionsPool* pool = (*i).second;
-    if ( pool->age_value >= max_age )   {
+    if ( pool->age() >= max_age )   {
       count += pool->size();
       pool->print("Remove");
       delete pool;
@@ -80,7 +159,10 @@ int ConditionsIOVPool::clean(int max_age)   {
     else
       rest.insert(make_pair(pool->iov->keyData,pool));
   }
-  elements = rest;
+  m_elements = rest;
+  ++m_modifications;
+  m_index.clear();
+  buildIndex();
   return count;
 }
 
@@ -92,16 +174,14 @@ size_t ConditionsIOVPool::select(const IOV&        req_validity,
   size_t num_selected = 0;
   if ( !elements.empty() )  {
     const IOV::Key req_key = req_validity.key(); // 16 bytes => better copy!
-    for(Elements::const_iterator i=elements.begin(); i!=elements.end(); ++i)  {
-      ConditionsPool* pool = (*i).second;
-      if ( !IOV::key_contains_range((*i).first, req_key) )  {
-        ++pool->age_value;
-        continue;
-      }
-      cond_validity.iov_intersection((*i).first);
-      num_selected += pool->select_all(valid);
-      pool->age_value = 0;
-    }
+    const long long int cycle = ++m_cycle;       // All pools not selected age by one
+    auto proc = [&](Node& n)  {
+      cond_validity.iov_intersection(n.key);
+      num_selected += n.pool->select_all(valid);
+      n.pool->age_stamp = cycle;
+    };
+    checkIndex();
+    scanContaining(req_key, 0, m_index.size(), proc);
   }
   return num_selected;
 }
@@ -114,16 +194,14 @@ size_t ConditionsIOVPool::select(const IOV&              req_validity,
   size_t num_selected = 0;
   if ( !elements.empty() )  {
     const IOV::Key req_key = req_validity.key(); // 16 bytes => better copy!
-    for(const auto& i : elements )  {
-      ConditionsPool* pool = i.second;
-      if ( !IOV::key_contains_range(i.first, req_key) )  {
-        ++pool->age_value;
-        continue;
-      }
-      cond_validity.iov_intersection(i.first);
-      num_selected += pool->select_all(predicate_processor);
-      pool->age_value = 0;
-    }
+    const long long int cycle = ++m_cycle;
+    auto proc = [&](Node& n)  {
+      cond_validity.iov_intersection(n.key);
+      num_selected += n.pool->select_all(predicate_processor);
+      n.pool->age_stamp = cycle;
+    };
+    checkIndex();
+    scanContaining(req_key, 0, m_index.size(), proc);
   }
   return num_selected;
 }
@@ -136,17 +214,15 @@ size_t ConditionsIOVPool::select(const IOV& req_validity,
   size_t num_selected = 0;
   if ( !elements.empty() )   {
     const IOV::Key req_key = req_validity.key(); // 16 bytes => better copy!
-    for(const auto& i : elements )  {
-      ConditionsPool* pool = i.second;
-      if ( !IOV::key_contains_range(i.first, req_key) )  {
-        ++pool->age_value;
-        continue;
-      }
-      cond_validity.iov_intersection(i.first);
-      valid[i.first] = pool;
-      pool->age_value = 0;
+    const long long int cycle = ++m_cycle;
+    auto proc = [&](Node& n)  {
+      cond_validity.iov_intersection(n.key);
+      valid[n.key] = n.pool;
+      n.pool->age_stamp = cycle;
       ++num_selected;
-    }
+    };
+    checkIndex();
+    scanContaining(req_key, 0, m_index.size(), proc);
   }
   return num_selected;
 }
@@ -52,6 +52,7 @@ ConditionsManagerObject::ConditionsManagerObject(LCDD& ref_lcdd)
   InstanceCount::increment(this);
   declareProperty("LoadConditions",           m_doLoad);
   declareProperty("OutputUnloadedConditions", m_doOutputUnloaded);
+  declareProperty("IncrementalUpdate",        m_doIncremental);
 }
 
 /// Default destructor
@@ -27,7 +27,7 @@ DD4HEP_INSTANTIATE_HANDLE_NAMED(ConditionsPool);
 
 /// Default constructor
 ConditionsPool::ConditionsPool(ConditionsManager mgr)
-  : NamedObject(), m_manager(mgr), iovType(0), iov(0), age_value(AGE_NONE)
+  : NamedObject(), m_manager(mgr), iovType(0), iov(0), age_cycle(0), age_stamp(0)
 {
   InstanceCount::increment(this);
 }
@@ -41,7 +41,7 @@ ConditionsPool::~ConditionsPool()   {
 /// Print pool basics
 void ConditionsPool::print(const string& opt)   const  {
   printout(INFO,"ConditionsPool","+++ %s Conditions for pool with IOV: %-32s age:%3d [%4d entries]",
-	   opt.c_str(), iov->str().c_str(), age_value, size());
+	   opt.c_str(), iov->str().c_str(), age(), size());
 }
 
 /// Listener invocation when a condition is registered to the cache
@@ -157,7 +157,7 @@ namespace  {
     }
     bool operator()(Condition::Object* c)  const  {
       if ( 0 == (c->flags&Condition::DERIVED) )   {
-        slice->insert(ConditionKey(c->name,c->hash),ConditionsSlice::loadInfo(c->address));
+        slice->insert(ConditionKey(c->name,c->hash),ConditionsSlice::loadInfo(c->address.str()));
         return true;
       }
       //DD4hep::printout(DD4hep::INFO,"Slice","++ Ignore dependent condition: %s",c->name.c_str());
@@ -180,7 +180,7 @@ ConditionsSlice*
 DD4hep::Conditions::createSlice(ConditionsManager mgr, const IOVType& typ)  {
   dd4hep_ptr<ConditionsSlice> slice(new ConditionsSlice(mgr));
   Conditions::ConditionsIOVPool* iovPool = mgr.iovPool(typ);
-  Conditions::ConditionsIOVPool::Elements& pools = iovPool->elements;
+  const Conditions::ConditionsIOVPool::Elements& pools = iovPool->elements;
   for_each(begin(pools),end(pools),SliceOper(slice.get()));
   return slice.release();
 }
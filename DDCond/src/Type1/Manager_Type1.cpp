@@ -187,6 +187,8 @@ void Manager_Type1::initialize()  {
 
 /// Register new IOV type if it does not (yet) exist.
 pair<bool, const IOVType*> Manager_Type1::registerIOVType(size_t iov_type, const string& iov_name)   {
+  // Loaders may register concurrently (see ConditionsMultiLoader)
+  dd4hep_lock_t lock(m_poolLock);
   if ( iov_type<m_iovTypes.size() )  {
     IOVType& typ = m_iovTypes[iov_type];
     bool eq_type = typ.type == iov_type;
@@ -229,8 +231,8 @@ const IOVType* Manager_Type1::iovType (const string& iov_name) const   {
 /// Register IOV with type and key
 ConditionsPool* Manager_Type1::registerIOV(const IOVType& typ, IOV::Key key)   {
   // IOV read and checked. Now register it, but always locked!
-  ConditionsIOVPool* pool = m_rawPool[typ.type];
   dd4hep_lock_t lock(m_poolLock);
+  ConditionsIOVPool* pool = m_rawPool[typ.type];
   if ( !pool )  {
     m_rawPool[typ.type] = pool = new ConditionsIOVPool(&typ);
   }
@@ -244,7 +246,7 @@ ConditionsPool* Manager_Type1::registerIOV(const IOVType& typ, IOV::Key key)   {
   iov->type      = typ.type;
   iov->keyData   = key;
   cond_pool->iov = iov;
-  pool->elements.insert(make_pair(key,cond_pool));
+  pool->insert(key,cond_pool);
   return cond_pool;
 }
 
@@ -253,12 +255,21 @@ ConditionsIOVPool* Manager_Type1::iovPool(const IOVType& iov_type)  const    {
   return m_rawPool[iov_type.type];
 }
 
-/// Register new condition with the conditions store. Unlocked version, not multi-threaded
+/// Register new condition with the conditions store. Unlocked version: the update pool is not locked
 bool Manager_Type1::registerUnlocked(ConditionsPool* pool, Condition cond)   {
   if ( pool && cond.isValid() )  {
+    // The update pool is not touched. Only protect against concurrent loaders.
     cond->pool = pool;
     cond->iov  = pool->iov;
     cond->setFlag(Condition::ACTIVE);
+    if ( pool->isConcurrent() )  {
+      pool->insert(cond);
+      if ( m_onRegister.empty() ) return true;
+      dd4hep_lock_t lock(m_poolLock);
+      __callListeners(m_onRegister, &ConditionsListener::onRegisterCondition, cond);
+      return true;
+    }
+    dd4hep_lock_t lock(m_poolLock);
     pool->insert(cond);
     __callListeners(m_onRegister, &ConditionsListener::onRegisterCondition, cond);
     return true;
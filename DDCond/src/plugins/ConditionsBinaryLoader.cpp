@@ -0,0 +1,391 @@
+//==========================================================================
+//  AIDA Detector description implementation for LCD
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//  \author  Markus Frank
+//  \date    2016-02-02
+//  \version 1.0
+//
+//==========================================================================
+#ifndef DD4HEP_CONDITIONS_BINARYCONDITONSLOADER_H
+#define DD4HEP_CONDITIONS_BINARYCONDITONSLOADER_H
+
+// Framework include files
+#include "DDCond/ConditionsDataLoader.h"
+#include "DDCond/ConditionsBinaryFormat.h"
+
+// C/C++ include files
+#include <mutex>
+
+/// Namespace for the AIDA detector description toolkit
+namespace DD4hep {
+
+  /// Namespace for the geometry part of the AIDA detector description toolkit
+  namespace Conditions  {
+
+    /// Conditions loader reading binary conditions repositories mapped into memory
+    /**
+     *  The files are written by the plugin DD4hep_ConditionsBinaryRepositoryWriter.
+     *  Each data source is mapped into memory when first needed. Conditions are
+     *  located by binary search in the entry table, which is sorted by key.
+     *  Only the conditions which are actually requested are materialized.
+     *
+     *  \author   M.Frank
+     *  \version  1.0
+     *  \ingroup  DD4HEP_CONDITIONS
+     */
+    class ConditionsBinaryLoader : public ConditionsDataLoader   {
+      typedef ConditionsBinaryFormat::Entry Entry;
+
+      /// Memory mapped repository file
+      struct File  {
+        std::string                                   path;
+        size_t                                        size     = 0;
+        const char*                                   base     = 0;
+        const ConditionsBinaryFormat::Header*         header   = 0;
+        const ConditionsBinaryFormat::IOVTypeEntry*   types    = 0;
+        const ConditionsBinaryFormat::IOVEntry*       iovs     = 0;
+        const Entry*                                  begin    = 0;
+        const Entry*                                  end      = 0;
+      };
+      typedef std::vector<File*> Files;
+
+      /// Mapped files in the order of the data sources
+      Files      m_files;
+      /// Protection of the file list
+      std::mutex m_lock;
+
+      /// Map all data sources not yet mapped
+      void open_sources();
+      /// Map single file into memory
+      File* open(const std::string& path);
+      /// Create (or access if already registered) the condition of a file entry
+      Condition load(const File& file, const Entry& entry);
+      /// Select entries of one key and add the matching conditions to the result
+      size_t select(key_type key, const iov_type& req_validity, bool range, RangeConditions& conditions);
+
+    public:
+      /// Default constructor
+      ConditionsBinaryLoader(LCDD& lcdd, ConditionsManager mgr, const std::string& nam);
+      /// Default destructor
+      virtual ~ConditionsBinaryLoader();
+      /// Leave the registration of loaded conditions to the caller. Supported.
+      virtual bool deferRegistration(bool value)  {  m_deferRegistration = value; return true; }
+      /// Load  a condition set given a Detector Element and the conditions name according to their validity
+      virtual size_t load_single(key_type key,
+                                 const iov_type& req_validity,
+                                 RangeConditions& conditions);
+      /// Load  a condition set given a Detector Element and the conditions name according to their validity
+      virtual size_t load_range( key_type key,
+                                 const iov_type& req_validity,
+                                 RangeConditions& conditions);
+      /// Optimized update using conditions slice data
+      virtual size_t load_many(  const iov_type& req_validity,
+                                 RequiredItems&  work,
+                                 LoadedItems&    loaded,
+                                 iov_type&       conditions_validity);
+    };
+  }    /* End namespace Conditions                   */
+}      /* End namespace DD4hep                       */
+#endif /* DD4HEP_CONDITIONS_BINARYCONDITONSLOADER_H  */
+
+//#include "ConditionsBinaryLoader.h"
+#include "DD4hep/Printout.h"
+#include "DD4hep/Factories.h"
+#include "DD4hep/AlignmentData.h"
+#include "DD4hep/OpaqueDataBinder.h"
+#include "DD4hep/objects/ConditionsInterna.h"
+#include "DDCond/ConditionsManager.h"
+#include "DDCond/ConditionsSlice.h"
+#include "DDCond/ConditionsPool.h"
+
+// C/C++ include files
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Forward declartions
+using std::string;
+using namespace DD4hep;
+using namespace DD4hep::Conditions;
+namespace BF = DD4hep::Conditions::ConditionsBinaryFormat;
+
+namespace {
+  void* create_loader(DD4hep::Geometry::LCDD& lcdd, int argc, char** argv)   {
+    const char* name = argc>0 ? argv[0] : "BinaryLoader";
+    ConditionsManagerObject* mgr = (ConditionsManagerObject*)(argc>0 ? argv[1] : 0);
+    return new ConditionsBinaryLoader(lcdd,ConditionsManager(mgr),name);
+  }
+  /// Ordering of the entry table
+  struct EntryKey  {
+    bool operator()(const BF::Entry& e, Condition::key_type k) const  { return e.key < k; }
+    bool operator()(Condition::key_type k, const BF::Entry& e) const  { return k < e.key; }
+  };
+  /// Check if a block [offset, offset+length] lies inside the data block of the file
+  bool _in_data(const BF::Header* h, unsigned long long offset, unsigned long long length)  {
+    return offset >= h->data && offset <= h->size && length <= h->size - offset;
+  }
+  /// Check the header and all records of a mapped file. Returns 0 or the reason of the failure
+  const char* _check_file(const BF::Header* h, size_t size)   {
+    typedef unsigned long long ull;
+    if ( ::memcmp(h->magic, BF::MAGIC, sizeof(h->magic)) != 0 )
+      return "bad magic word";
+    else if ( h->version != BF::VERSION )
+      return "unsupported version";
+    else if ( h->size != size || h->data > size )
+      return "file size does not match the header";
+    else if ( h->iov_types < sizeof(BF::Header) || h->iov_types > h->data ||
+              h->num_iov_types > (h->data-h->iov_types)/sizeof(BF::IOVTypeEntry) ||
+              h->iov_types + h->num_iov_types*sizeof(BF::IOVTypeEntry) > h->iovs )
+      return "IOV type table overlaps the IOV table";
+    else if ( h->iovs > h->data ||
+              h->num_iovs > (h->data-h->iovs)/sizeof(BF::IOVEntry) ||
+              h->iovs + h->num_iovs*sizeof(BF::IOVEntry) > h->entries )
+      return "IOV table overlaps the entry table";
+    else if ( h->entries > h->data ||
+              h->num_entries > (h->data-h->entries)/sizeof(BF::Entry) )
+      return "entry table overlaps the data block";
+    const char*             base  = (const char*)h;
+    const BF::IOVTypeEntry* types = (const BF::IOVTypeEntry*)(base + h->iov_types);
+    const BF::IOVEntry*     iovs  = (const BF::IOVEntry*)(base + h->iovs);
+    const BF::Entry*        e     = (const BF::Entry*)(base + h->entries);
+    for(unsigned int i=0; i<h->num_iov_types; ++i)  {
+      if ( !_in_data(h, types[i].name_offset, types[i].name_length) )
+        return "IOV type name outside the data block";
+    }
+    for(unsigned int i=0; i<h->num_iovs; ++i)  {
+      const BF::IOVTypeEntry* t = std::find_if(types, types+h->num_iov_types,
+                                               [&](const BF::IOVTypeEntry& x) { return x.id == iovs[i].iov_type; });
+      if ( t == types+h->num_iov_types )
+        return "IOV with unknown IOV type";
+    }
+    for(ull i=0; i<h->num_entries; ++i, ++e)  {
+      if ( e->iov >= h->num_iovs )
+        return "entry with invalid IOV index";
+      else if ( !_in_data(h, e->name_offset, e->name_length) )
+        return "entry name outside the data block";
+      else if ( !_in_data(h, e->type_offset, e->type_length) )
+        return "entry type outside the data block";
+      else if ( !_in_data(h, e->data_offset, e->data_length) )
+        return "entry data outside the data block";
+      switch(e->kind)  {
+      case BF::KIND_DOUBLE:
+        if ( e->data_length != sizeof(double) ) return "double payload with bad length";
+        break;
+      case BF::KIND_INT:
+        if ( e->data_length != sizeof(int) ) return "int payload with bad length";
+        break;
+      case BF::KIND_LONG:
+        if ( e->data_length != sizeof(long long) ) return "long payload with bad length";
+        break;
+      case BF::KIND_DELTA:
+        if ( e->data_length != sizeof(BF::Delta) ) return "alignment delta payload with bad length";
+        break;
+      case BF::KIND_TEXT:
+      case BF::KIND_STRING:
+        break;
+      default:
+        return "entry with unknown payload encoding";
+      }
+    }
+    return 0;
+  }
+}
+DECLARE_LCDD_CONSTRUCTOR(DD4hep_Conditions_binary_Loader,create_loader)
+
+/// Standard constructor, initializes variables
+ConditionsBinaryLoader::ConditionsBinaryLoader(LCDD& lcdd, ConditionsManager mgr, const string& nam)
+: ConditionsDataLoader(lcdd, mgr, nam)
+{
+}
+
+/// Default Destructor
+ConditionsBinaryLoader::~ConditionsBinaryLoader() {
+  for(File* f : m_files)  {
+    if ( f->base ) ::munmap((void*)f->base, f->size);
+    delete f;
+  }
+  m_files.clear();
+}
+
+/// Map single file into memory
+ConditionsBinaryLoader::File* ConditionsBinaryLoader::open(const string& path)  {
+  struct stat buff;
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if ( fd == -1 || ::fstat(fd, &buff) == -1 )  {
+    if ( fd != -1 ) ::close(fd);
+    except("ConditionsBinaryLoader","++ Failed to open binary conditions file %s [%s]",
+           path.c_str(), ::strerror(errno));
+  }
+  size_t len = buff.st_size;
+  void*  mem = len >= sizeof(BF::Header) ? ::mmap(0, len, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+  ::close(fd);
+  if ( mem == MAP_FAILED )  {
+    except("ConditionsBinaryLoader","++ Failed to map binary conditions file %s [%s]",
+           path.c_str(), len < sizeof(BF::Header) ? "File too small" : ::strerror(errno));
+  }
+  File* f     = new File();
+  f->path     = path;
+  f->size     = len;
+  f->base     = (const char*)mem;
+  f->header   = (const BF::Header*)mem;
+  const BF::Header* h = f->header;
+  // Check all records once: afterwards the entries are used without further checks
+  const char* err = _check_file(h, len);
+  if ( err )   {
+    ::munmap(mem, len);
+    delete f;
+    except("ConditionsBinaryLoader","++ The file %s is no valid binary conditions file: %s.",
+           path.c_str(), err);
+  }
+  f->types    = (const BF::IOVTypeEntry*)(f->base + h->iov_types);
+  f->iovs     = (const BF::IOVEntry*)(f->base + h->iovs);
+  f->begin    = (const BF::Entry*)(f->base + h->entries);
+  f->end      = f->begin + h->num_entries;
+  // The data are accessed randomly following the requests of the conditions slices
+  ::madvise(mem, len, MADV_RANDOM);
+  printout(DEBUG,"ConditionsBinaryLoader","++ Mapped %lld conditions from %s",
+           h->num_entries, path.c_str());
+  return f;
+}
+
+/// Map all data sources not yet mapped
+void ConditionsBinaryLoader::open_sources()  {
+  std::lock_guard<std::mutex> lock(m_lock);
+  while ( m_files.size() < m_sources.size() )
+    m_files.push_back(open(m_sources[m_files.size()].first));
+}
+
+/// Create (or access if already registered) the condition of a file entry
+Condition ConditionsBinaryLoader::load(const File& file, const Entry& e)   {
+  const BF::IOVEntry&     i = file.iovs[e.iov];
+  const BF::IOVTypeEntry* t = std::find_if(file.types, file.types+file.header->num_iov_types,
+                                           [&i](const BF::IOVTypeEntry& x) { return x.id == i.iov_type; });
+  if ( t == file.types+file.header->num_iov_types )  {
+    except("ConditionsBinaryLoader","++ Unknown IOV type %d in file %s",
+           int(i.iov_type), file.path.c_str());
+  }
+  const IOVType*  typ  = m_mgr.registerIOVType(t->id,string(file.base+t->name_offset,t->name_length)).second;
+  ConditionsPool* pool = m_mgr.registerIOV(*typ, IOV::Key(i.lower,i.upper));
+  Condition       cond = pool->exists(e.key);
+
+  // Another slice may already have requested this condition
+  if ( cond.isValid() )
+    return cond;
+
+  const char* data = file.base + e.data_offset;
+  string      type(file.base+e.type_offset, e.type_length);
+  cond = Condition(string(file.base+e.name_offset, e.name_length), type);
+  cond->hash    = e.key;
+  cond->flags   = e.flags & ~Condition::ACTIVE;
+  cond->address = file.path;
+  switch(e.kind)   {
+  case BF::KIND_DOUBLE:
+    cond.bind<double>() = *(const double*)data;
+    break;
+  case BF::KIND_INT:
+    cond.bind<int>() = *(const int*)data;
+    break;
+  case BF::KIND_LONG:
+    cond.bind<long>() = *(const long long*)data;
+    break;
+  case BF::KIND_STRING:
+    cond.bind<string>().assign(data, e.data_length);
+    break;
+  case BF::KIND_DELTA:  {
+    const BF::Delta&   d     = *(const BF::Delta*)data;
+    Alignments::Delta& delta = cond.bind<Alignments::Delta>();
+    delta.flags = d.flags;
+    delta.translation.SetCoordinates(d.translation);
+    delta.pivot.SetComponents(d.pivot[0],d.pivot[1],d.pivot[2]);
+    delta.rotation.SetComponents(d.rotation[0],d.rotation[1],d.rotation[2]);
+    break;
+  }
+  case BF::KIND_TEXT:
+    cond->value = string(data, e.data_length);
+    OpaqueDataBinder::bind_sequence(cond, type, cond->value);
+    break;
+  default:
+    except("ConditionsBinaryLoader","++ Unknown payload encoding %d of condition %s in file %s",
+           int(e.kind), cond.name(), file.path.c_str());
+  }
+  registerCondition(pool, cond);
+  return cond;
+}
+
+/// Select entries of one key and add the matching conditions to the result
+size_t ConditionsBinaryLoader::select(key_type key,
+                                      const iov_type& req,
+                                      bool range,
+                                      RangeConditions& conditions)
+{
+  size_t len = conditions.size();
+  unsigned int req_type = req.iovType ? req.iovType->type : req.type;
+  open_sources();
+  for(const File* f : m_files)  {
+    auto r = std::equal_range(f->begin, f->end, key, EntryKey());
+    for(const Entry* e = r.first; e != r.second; ++e)  {
+      const BF::IOVEntry& i = f->iovs[e->iov];
+      if ( i.iov_type != req_type )
+        continue;
+      else if ( range && (i.lower > req.keyData.second || i.upper < req.keyData.first) )
+        continue;
+      else if ( !range && (i.lower > req.keyData.first || i.upper < req.keyData.second) )
+        continue;
+      conditions.push_back(load(*f, *e));
+      // Single requests: the first source defining the condition has precedence
+      if ( !range ) return conditions.size()-len;
+    }
+  }
+  return conditions.size()-len;
+}
+
+/// Load  a condition set given a Detector Element and the conditions name according to their validity
+size_t ConditionsBinaryLoader::load_single(key_type key,
+                                           const iov_type& req_validity,
+                                           RangeConditions& conditions)
+{
+  return select(key, req_validity, false, conditions);
+}
+
+/// Load  a condition set given a Detector Element and the conditions name according to their validity
+size_t ConditionsBinaryLoader::load_range(key_type key,
+                                          const iov_type& req_validity,
+                                          RangeConditions& conditions)
+{
+  return select(key, req_validity, true, conditions);
+}
+
+/// Optimized update using conditions slice data
+size_t ConditionsBinaryLoader::load_many(const iov_type& req_validity,
+                                         RequiredItems&  work,
+                                         LoadedItems&    loaded,
+                                         iov_type&       conditions_validity)
+{
+  size_t          len = loaded.size();
+  RangeConditions found;
+
+  open_sources();
+  found.reserve(1);
+  for(const auto& i : work )  {
+    ConditionsDescriptor* d = i.second;
+    if ( d && d->dependency )
+      continue;
+    found.clear();
+    if ( select(i.first, req_validity, false, found) > 0 )  {
+      Condition c = found.front();
+      conditions_validity.iov_intersection(*c->iov);
+      loaded.insert(std::make_pair(i.first,c));
+    }
+  }
+  return loaded.size()-len;
+}
@@ -0,0 +1,307 @@
+//==========================================================================
+//  AIDA Detector description implementation for LCD
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Frank
+//
+//==========================================================================
+#ifndef DDCOND_CONDITIONSCONCURRENTPOOL_H
+#define DDCOND_CONDITIONSCONCURRENTPOOL_H
+
+// Framework include files
+#include "DD4hep/Printout.h"
+#include "DD4hep/objects/ConditionsInterna.h"
+
+#include "DDCond/ConditionsPool.h"
+#include "DDCond/ConditionsSelectors.h"
+
+// C/C++ include files
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <vector>
+
+/// Namespace for the AIDA detector description toolkit
+namespace DD4hep {
+
+  /// Namespace for the geometry part of the AIDA detector description toolkit
+  namespace Conditions {
+
+    /// Conditions collection for a given IOV type supporting concurrent access
+    /**
+     *  The conditions are kept in a sharded hash table:
+     *  - Lookups and selections do not lock. Bucket chains are published
+     *    with release semantics and never modified once visible.
+     *  - Insertions lock only the shard of the condition key.
+     *  - When a shard grows, a new table with new chains is published.
+     *    The replaced table stays valid for readers still using it and
+     *    is released together with the pool content in clear().
+     *
+     *  Hence several loaders may register conditions while other
+     *  threads select. clear() however requires exclusive access.
+     *
+     *  \author  M.Frank
+     *  \version 1.0
+     *  \ingroup DD4HEP_CONDITIONS
+     */
+    class ConditionsConcurrentPool : public ConditionsPool   {
+    public:
+      typedef ConditionsPool::key_type key_type;
+
+    protected:
+      /// Hash chain entry. Immutable once published.
+      struct Node  {
+        key_type           key;
+        Condition::Object* object;
+        Node*              next;
+      };
+      /// Hash table of one shard
+      struct Table  {
+        size_t mask;
+        std::unique_ptr<std::atomic<Node*>[]> buckets;
+        /// Initializing constructor. The number of buckets must be a power of 2
+        Table(size_t num_buckets);
+        /// Default destructor. Deletes all chain entries
+        ~Table();
+      };
+      /// Shard of the pool: writers are serialized by the shard lock
+      struct Shard  {
+        std::mutex                          lock;
+        std::atomic<Table*>                 table;
+        std::vector<std::unique_ptr<Table> > retired;
+        size_t                              count = 0;
+        Shard() : table(0) {}
+      };
+      enum { NUM_SHARDS = 64, SHARD_SHIFT = 58, INITIAL_BUCKETS = 16 };
+
+      /// The shards
+      Shard               m_shards[NUM_SHARDS];
+      /// Total number of entries
+      std::atomic<size_t> m_count;
+
+      /// Mix the condition key to select the shard and bucket
+      static unsigned long long mix(key_type key)   {
+        unsigned long long h = key;
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+      }
+      /// Lookup entry in a table
+      static Node* lookup(const Table* t, unsigned long long h, key_type key)  {
+        for(Node* n = t->buckets[h&t->mask].load(std::memory_order_acquire); n; n = n->next)
+          if ( n->key == key ) return n;
+        return 0;
+      }
+      /// Register a new condition. Returns the already present condition on failure.
+      Condition::Object* add(Condition::Object* c);
+      /// Find condition by key
+      Condition::Object* find(key_type key)  const;
+      /// Helper function to loop over the conditions container and apply a functor
+      template <typename R,typename T> size_t loop(R& result, T functor) const {
+        size_t len = result.size();
+        for(const Shard& s : m_shards)  {
+          const Table* t = s.table.load(std::memory_order_acquire);
+          for(size_t i=0; i<=t->mask; ++i)
+            for(Node* n = t->buckets[i].load(std::memory_order_acquire); n; n = n->next)
+              functor(n->object);
+        }
+        return result.size() - len;
+      }
+
+    public:
+      /// Default constructor
+      ConditionsConcurrentPool(ConditionsManager mgr);
+
+      /// Default destructor
+      virtual ~ConditionsConcurrentPool();
+
+      /// The pool supports concurrent insertions and selections
+      virtual bool isConcurrent() const  final  {
+        return true;
+      }
+
+      /// Total entry count
+      virtual size_t size()  const  final  {
+        return m_count.load(std::memory_order_relaxed);
+      }
+
+      /// Register a new condition to this pool
+      virtual bool insert(Condition condition)  final    {
+        Condition::Object* present = add(condition.access());
+        if ( !present ) return true;
+        printout(ERROR,"ConcurrentPool","ConditionsClash: %s %08llX <> %08llX %s",
+                 present->name.c_str(), present->hash, condition.key(), condition.name());
+        return false;
+      }
+
+      /// Register a new condition to this pool. May overload for performance reasons.
+      virtual void insert(RangeConditions& new_entries)  final   {
+        for( Condition c : new_entries )
+          add(c.access());
+      }
+
+      /// Full cleanup of all managed conditions. Requires exclusive access.
+      virtual void clear()  final;
+
+      /// Check if a condition exists in the pool
+      virtual Condition exists(Condition::key_type key)  const  final   {
+        return find(key);
+      }
+
+      /// Select the conditions matching the DetElement and the conditions name
+      virtual size_t select(Condition::key_type key, RangeConditions& result)  final  {
+        Condition::Object* o = find(key);
+        if ( o ) result.push_back(o);
+        return o ? 1 : 0;
+      }
+
+      /// Select the conditons, used also by the DetElement of the condition
+      virtual size_t select_all(const ConditionsSelect& result)  final
+      {  return loop(result, Operators::operatorWrapper(result));      }
+
+      /// Select the conditons, used also by the DetElement of the condition
+      virtual size_t select_all(RangeConditions& result)  final
+      {  return loop(result, Operators::sequenceSelect(result));       }
+
+      /// Select the conditons, used also by the DetElement of the condition
+      virtual size_t select_all(ConditionsPool& result)  final
+      {  return loop(result, Operators::poolSelect(result));           }
+    };
+  }    /* End namespace Conditions               */
+}      /* End namespace DD4hep                   */
+#endif /* DDCOND_CONDITIONSCONCURRENTPOOL_H      */
+
+//==========================================================================
+//  AIDA Detector description implementation for LCD
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Frank
+//
+//==========================================================================
+
+// Framework include files
+//#include "DDCond/ConditionsConcurrentPool.h"
+#include "DD4hep/InstanceCount.h"
+
+using namespace DD4hep::Conditions;
+
+/// Initializing constructor. The number of buckets must be a power of 2
+ConditionsConcurrentPool::Table::Table(size_t num_buckets)
+  : mask(num_buckets-1), buckets(new std::atomic<Node*>[num_buckets])
+{
+  for(size_t i=0; i<num_buckets; ++i) buckets[i].store(0, std::memory_order_relaxed);
+}
+
+/// Default destructor. Deletes all chain entries
+ConditionsConcurrentPool::Table::~Table()   {
+  for(size_t i=0; i<=mask; ++i)  {
+    for(Node* n = buckets[i].load(std::memory_order_relaxed); n; )  {
+      Node* nxt = n->next;
+      delete n;
+      n = nxt;
+    }
+  }
+}
+
+/// Default constructor
+ConditionsConcurrentPool::ConditionsConcurrentPool(ConditionsManager mgr)
+  : ConditionsPool(mgr), m_count(0)
+{
+  for(Shard& s : m_shards)
+    s.table.store(new Table(INITIAL_BUCKETS), std::memory_order_release);
+  InstanceCount::increment(this);
+}
+
+/// Default destructor
+ConditionsConcurrentPool::~ConditionsConcurrentPool()  {
+  clear();
+  for(Shard& s : m_shards)
+    delete s.table.load(std::memory_order_acquire);
+  InstanceCount::decrement(this);
+}
+
+/// Register a new condition. Returns the already present condition on failure.
+Condition::Object* ConditionsConcurrentPool::add(Condition::Object* c)   {
+  unsigned long long h = mix(c->hash);
+  Shard& s = m_shards[h >> SHARD_SHIFT];
+  std::lock_guard<std::mutex> lock(s.lock);
+  Table* t = s.table.load(std::memory_order_relaxed);
+  Node* present = lookup(t, h, c->hash);
+  if ( present )  {
+    return present->object;
+  }
+  if ( s.count > 2*(t->mask+1) )  {
+    // Grow: copy the chains into a new table. Readers may still use the old one.
+    Table* nt = new Table(4*(t->mask+1));
+    for(size_t i=0; i<=t->mask; ++i)  {
+      for(Node* n = t->buckets[i].load(std::memory_order_relaxed); n; n = n->next)  {
+        std::atomic<Node*>& b = nt->buckets[mix(n->key)&nt->mask];
+        b.store(new Node{n->key, n->object, b.load(std::memory_order_relaxed)}, std::memory_order_relaxed);
+      }
+    }
+    s.table.store(nt, std::memory_order_release);
+    s.retired.emplace_back(t);
+    t = nt;
+  }
+  std::atomic<Node*>& bucket = t->buckets[h&t->mask];
+  bucket.store(new Node{c->hash, c, bucket.load(std::memory_order_relaxed)}, std::memory_order_release);
+  ++s.count;
+  m_count.fetch_add(1, std::memory_order_relaxed);
+  return 0;
+}
+
+/// Find condition by key
+Condition::Object* ConditionsConcurrentPool::find(key_type key)  const   {
+  unsigned long long h = mix(key);
+  const Shard& s = m_shards[h >> SHARD_SHIFT];
+  Node* n = lookup(s.table.load(std::memory_order_acquire), h, key);
+  return n ? n->object : 0;
+}
+
+/// Full cleanup of all managed conditions. Requires exclusive access.
+void ConditionsConcurrentPool::clear()   {
+  for(Shard& s : m_shards)  {
+    std::lock_guard<std::mutex> lock(s.lock);
+    Table* t = s.table.load(std::memory_order_relaxed);
+    if ( s.count > 0 )  {
+      auto remove = Operators::poolRemove(*this);
+      for(size_t i=0; i<=t->mask; ++i)
+        for(Node* n = t->buckets[i].load(std::memory_order_relaxed); n; n = n->next)
+          remove(n->object);
+      s.table.store(new Table(INITIAL_BUCKETS), std::memory_order_release);
+      delete t;
+    }
+    s.retired.clear();
+    s.count = 0;
+  }
+  m_count.store(0, std::memory_order_relaxed);
+}
+
+#include "DD4hep/Factories.h"
+namespace {
+  ConditionsManager _mgr(int argc, char** argv)  {
+    if ( argc > 0 )  {
+      ConditionsManagerObject* m = (ConditionsManagerObject*)argv[0];
+      return m;
+    }
+    DD4hep::except("ConditionsConcurrentPool","++ Insufficient arguments: arg[0] = ConditionManager!");
+    return ConditionsManager(0);
+  }
+  /// Create a conditions pool supporting concurrent insertions and selections
+  void* create_concurrent_pool(DD4hep::Geometry::LCDD&, int argc, char** argv)
+  {  return new ConditionsConcurrentPool(_mgr(argc,argv));  }
+}
+DECLARE_LCDD_CONSTRUCTOR(DD4hep_ConditionsConcurrentPool, create_concurrent_pool)
@@ -30,17 +30,47 @@ namespace DD4hep {
 
     /// Implementation of a stack of conditions assembled before application
     /** 
+     *  Each data source is served by its own loader instance.
+     *  If several sources deliver the same condition, the source configured
+     *  first takes precedence.
+     *
+     *  Requests for many conditions are split into slices, which are
+     *  processed concurrently. Each slice queries the sources in the order
+     *  of their priority and passes only the conditions still missing to
+     *  the next source. Hence conditions of lower priority sources are
+     *  never loaded if a source of higher priority delivers them.
+     *  The loaders leave the registration of new conditions to the caller
+     *  thread, which registers them once all slices are merged.
+     *  Loaders which do not support deferred registration are executed
+     *  sequentially by the caller thread.
+     *
+     *  Properties:
+     *  - NumThreads: Maximal number of worker threads (default: number of cores).
+     *                Values smaller than 2 disable concurrent loading.
+     *
      *  \author   M.Frank
      *  \version  1.0
      *  \ingroup  DD4HEP_CONDITIONS
      */
     class ConditionsMultiLoader : public ConditionsDataLoader   {
-      typedef std::map<std::string, ConditionsDataLoader*> Loaders;
       typedef std::map<std::string, ConditionsDataLoader*> OpenSources;
+      /// Accumulated load statistics per data source: calls, conditions and time in seconds
+      struct Timing  {
+        long   calls = 0, items = 0;
+        double seconds = 0e0;
+      };
+      typedef std::map<std::string, Timing>                Timings;
+      /// Loaders of the requested sources in the order of their priority
+      typedef std::vector<std::pair<std::string,ConditionsDataLoader*> > Chain;
+      struct Task;
 
-      Loaders m_loaders;
       OpenSources m_openSources;
+      Timings m_timings;
+      /// Property: Maximal number of worker threads
+      int m_numThreads;
       ConditionsDataLoader* load_source(const std::string& nam,const iov_type& req_validity);
+      /// Execute the load tasks using a set of worker threads
+      void execute(std::vector<Task>& tasks);
 
     public:
       /// Default constructor
@@ -56,14 +86,10 @@ namespace DD4hep {
                                  const iov_type& req_validity,
                                  RangeConditions& conditions);
       /// Optimized update using conditions slice data
-      virtual size_t load_many(  const iov_type& /* req_validity */,
-                                 RequiredItems&  /* work         */,
-                                 LoadedItems&    /* loaded       */,
-                                 iov_type&       /* conditions_validity */)
-      {
-        except("ConditionsLoader","+++ update: Invalid call!");
-        return 0;
-      }
+      virtual size_t load_many(  const iov_type& req_validity,
+                                 RequiredItems&  work,
+                                 LoadedItems&    loaded,
+                                 iov_type&       conditions_validity);
     };
   }     /* End namespace Geometry                     */
 }       /* End namespace DD4hep                       */
@@ -88,12 +114,60 @@ namespace DD4hep {
 #include "DD4hep/Printout.h"
 #include "DD4hep/Factories.h"
 #include "DD4hep/PluginCreators.h"
+#include "DD4hep/objects/ConditionsInterna.h"
 #include "DDCond/ConditionsManager.h"
 
+// C/C++ include files
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <exception>
+
 // Forward declartions
 using std::string;
+using namespace DD4hep;
 using namespace DD4hep::Conditions;
 
+/// Work item of one slice of a load_many call
+struct ConditionsMultiLoader::Task  {
+  /// Loaders of the data sources in the order of their priority
+  const Chain*                 chain;
+  const Condition::iov_type*   req_validity;
+  /// Conditions of this slice not yet found
+  RequiredItems                work;
+  LoadedItems                  loaded;
+  Condition::iov_type          validity;
+  /// Statistics per data source
+  std::vector<Timing>          timing;
+  std::exception_ptr           error;
+  Task(const Chain& c, const Condition::iov_type& req, const Condition::iov_type& v)
+    : chain(&c), req_validity(&req), validity(v), timing(c.size())  {}
+  /// Query the sources in order. Each source only sees the conditions still missing
+  void operator()()  {
+    try  {
+      for(size_t i=0; i < chain->size() && !work.empty(); ++i)  {
+        LoadedItems found;
+        auto start = std::chrono::steady_clock::now();
+        (*chain)[i].second->load_many(*req_validity, work, found, validity);
+        std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+        Timing& t = timing[i];
+        ++t.calls;
+        t.items   += found.size();
+        t.seconds += d.count();
+        if ( !found.empty() )  {
+          auto done = [&found](const RequiredItems::value_type& w) { return found.count(w.first) > 0; };
+          work.erase(std::remove_if(work.begin(), work.end(), done), work.end());
+          loaded.insert(found.begin(), found.end());
+        }
+      }
+    }
+    catch(...)  {
+      error = std::current_exception();
+    }
+  }
+};
+
 namespace {
   void* create_loader(DD4hep::Geometry::LCDD& lcdd, int argc, char** argv)   {
     const char* name = argc>0 ? argv[0] : "MULTILoader";
@@ -107,10 +181,18 @@ DECLARE_LCDD_CONSTRUCTOR(DD4hep_Conditions_multi_Loader,create_loader)
 ConditionsMultiLoader::ConditionsMultiLoader(LCDD& lcdd, ConditionsManager mgr, const string& nam) 
 : ConditionsDataLoader(lcdd, mgr, nam)
 {
+  m_numThreads = std::thread::hardware_concurrency();
+  declareProperty("NumThreads", m_numThreads);
 }
 
 /// Default Destructor
 ConditionsMultiLoader::~ConditionsMultiLoader() {
+  for(const auto& t : m_timings)  {
+    printout(INFO,"ConditionsMultiLoader",
+             "++ %-32s %6ld calls %8ld conditions loaded in %9.3f ms [%7.3f ms/call]",
+             t.first.c_str(), t.second.calls, t.second.items, t.second.seconds*1e3,
+             t.second.seconds*1e3/double(t.second.calls ? t.second.calls : 1));
+  }
 } 
 
 ConditionsDataLoader* 
@@ -123,24 +205,17 @@ ConditionsMultiLoader::load_source(const std::string& nam,
     if ( idx == string::npos )   {
       except("ConditionsMultiLoader","Invalid data source specification: "+nam);
     }
+    // Every source has its own loader: loaders query all their sources.
     string ident = nam.substr(0,idx);
-    Loaders::iterator ild = m_loaders.find(ident);
-    ConditionsDataLoader* loader = 0;
-    if ( ild == m_loaders.end() )  {
-      string typ = "DD4hep_Conditions_"+ident+"_Loader";
-      string fac = ident+"_ConditionsDataLoader";
-      const void* argv[] = {fac.c_str(), m_mgr.ptr(), 0};
-      loader = createPlugin<ConditionsDataLoader>(typ,m_lcdd,2,argv);
-      if ( !loader )  {
-        except("ConditionsMultiLoader",
-               "Failed to create conditions loader of type: "+typ+" to read:"+nam);
-      }
-    }
-    else  {
-      loader = (*ild).second;
+    string typ = "DD4hep_Conditions_"+ident+"_Loader";
+    string fac = ident+"_ConditionsDataLoader";
+    const void* argv[] = {fac.c_str(), m_mgr.ptr(), 0};
+    ConditionsDataLoader* loader = createPlugin<ConditionsDataLoader>(typ,m_lcdd,2,argv);
+    if ( !loader )  {
+      except("ConditionsMultiLoader",
+             "Failed to create conditions loader of type: "+typ+" to read:"+nam);
     }
     loader->addSource(nam.substr(idx+1),req_validity);
-    m_loaders[ident] = loader;
     m_openSources[nam] = loader;
     return loader;
   }
@@ -186,3 +261,107 @@ size_t ConditionsMultiLoader::load_single(key_type key,
   }
   return conditions.size() - len;
 }
+
+/// Execute the load tasks using a set of worker threads
+void ConditionsMultiLoader::execute(std::vector<Task>& tasks)   {
+  size_t num_threads = std::min(tasks.size(), size_t(m_numThreads > 0 ? m_numThreads : 1));
+  if ( num_threads < 2 )  {
+    for(auto& t : tasks) t();
+    return;
+  }
+  std::atomic<size_t>      next(0);
+  std::vector<std::thread> workers;
+  auto worker = [&tasks, &next]()  {
+    for(size_t i = next++; i < tasks.size(); i = next++)
+      tasks[i]();
+  };
+  workers.reserve(num_threads-1);
+  try  {
+    for(size_t i=1; i < num_threads; ++i)
+      workers.emplace_back(worker);
+  }
+  catch(const std::exception& e)  {
+    // Continue with the threads we got: the remaining tasks are picked up by the others
+    printout(WARNING,"ConditionsMultiLoader","++ Failed to start worker thread: %s",e.what());
+  }
+  worker();
+  for(auto& w : workers) w.join();
+}
+
+/// Optimized update using conditions slice data
+size_t ConditionsMultiLoader::load_many(const iov_type& req_validity,
+                                        RequiredItems&  work,
+                                        LoadedItems&    loaded,
+                                        iov_type&       conditions_validity)
+{
+  enum { MIN_SLICE = 64 };
+  size_t len = loaded.size();
+  bool   concurrent = m_numThreads > 1;
+  Chain  chain;
+  // Collect the loaders of all sources in the order of their priority.
+  // Loader creation is not thread safe: this is done by the caller.
+  for(Sources::const_iterator i=m_sources.begin(); i != m_sources.end(); ++i)  {
+    const IOV& iov = (*i).second;
+    if ( iov.type == req_validity.type )  {
+      if ( IOV::key_partially_contained(iov.keyData,req_validity.keyData) )  {
+        const string& nam = (*i).first;
+        ConditionsDataLoader* loader = load_source(nam, req_validity);
+        chain.push_back(std::make_pair(nam,loader));
+      }
+    }
+  }
+  if ( chain.empty() || work.empty() )
+    return 0;
+  // Concurrent execution requires that all loaders leave the registration to us
+  for(auto& c : chain)
+    concurrent = c.second->deferRegistration(true) && concurrent;
+  if ( !concurrent )  {
+    for(auto& c : chain) c.second->deferRegistration(false);
+  }
+  // Split the request into slices. Each slice is processed by one task
+  size_t num_slices = concurrent ? std::min(size_t(m_numThreads), (work.size()+MIN_SLICE-1)/MIN_SLICE) : 1;
+  size_t slice_len  = (work.size()+num_slices-1)/num_slices;
+  std::vector<Task> tasks;
+  tasks.reserve(num_slices);
+  for(size_t i=0; i < work.size(); i += slice_len)  {
+    tasks.emplace_back(chain, req_validity, conditions_validity);
+    tasks.back().work.assign(work.begin()+i, work.begin()+std::min(i+slice_len,work.size()));
+  }
+  execute(tasks);
+  for(auto& c : chain)
+    c.second->deferRegistration(false);
+
+  for(auto& t : tasks)  {
+    if ( t.error )  {
+      // Conditions not registered are owned by nobody: drop them
+      for(auto& tt : tasks)  {
+        for(auto& l : tt.loaded)  {
+          Condition::Object* o = l.second.ptr();
+          if ( concurrent && o && !(o->flags&Condition::ACTIVE) ) delete o;
+        }
+      }
+      std::rethrow_exception(t.error);
+    }
+  }
+  // Merge the slices and register the new conditions. The slices are disjoint.
+  for(auto& t : tasks)  {
+    if ( !t.loaded.empty() )  {
+      conditions_validity.iov_intersection(t.validity);
+      for(auto& l : t.loaded)  {
+        Condition::Object* o = l.second.ptr();
+        if ( concurrent && !(o->flags&Condition::ACTIVE) )
+          m_mgr.registerUnlocked(o->pool, l.second);
+      }
+      loaded.insert(t.loaded.begin(), t.loaded.end());
+    }
+    for(size_t i=0; i < chain.size(); ++i)  {
+      Timing& timing = m_timings[chain[i].first];
+      timing.calls   += t.timing[i].calls;
+      timing.items   += t.timing[i].items;
+      timing.seconds += t.timing[i].seconds;
+    }
+  }
+  printout(DEBUG,"ConditionsMultiLoader","++ %8ld conditions loaded from %ld sources in %ld slices",
+           long(loaded.size()-len), long(chain.size()), long(tasks.size()));
+  return loaded.size() - len;
+}
@@ -19,6 +19,8 @@
 #include "DDCond/ConditionsManager.h"
 
 // C/C++ include files
+#include <map>
+#include <vector>
 
 /// Namespace for the AIDA detector description toolkit
 namespace DD4hep {
@@ -66,6 +68,53 @@ namespace DD4hep {
       /// Write the XML document structure to a file.
       long write(XML::Document doc, const std::string& output)   const;
     };
+
+    /// Writer of binary conditions repositories. See DDCond/ConditionsBinaryFormat.h for the layout.
+    /**
+     *  Conditions are collected from one or several conditions slices
+     *  in the same way as by the XML repository writer. Each condition is
+     *  stored with its own interval of validity, hence snapshots of 
+     *  several IOVs may be merged into one file.
+     *
+     *  \author  M.Frank
+     *  \version 1.0
+     *  \ingroup DD4HEP_CONDITIONS
+     */
+    class ConditionsBinaryRepositoryWriter  {
+    public:
+      /// Collected condition record
+      struct Record  {
+        Condition::key_type key;
+        unsigned int        iov;
+        unsigned int        flags;
+        unsigned int        kind;
+        std::string         name, type, data;
+      };
+      typedef std::pair<unsigned int,std::pair<long long,long long> > IOVKey;
+
+    protected:
+      /// Collected condition records
+      std::vector<Record>                 m_records;
+      /// IOV types by identifier
+      std::map<unsigned int,std::string>  m_iovTypes;
+      /// IOV table
+      std::map<IOVKey,unsigned int>       m_iovs;
+
+      /// Add single condition to the records. Returns false if the data type is not supported
+      bool add(Condition c);
+
+    public:
+      /// Default constructor
+      ConditionsBinaryRepositoryWriter() = default;
+      /// Default destructor. 
+      virtual ~ConditionsBinaryRepositoryWriter() = default;
+      /// Collect the conditions of a slice
+      size_t collect(ConditionsSlice& slice);
+      /// Collect the conditions of a slice attached to a detector element and its children
+      size_t collect(ConditionsSlice& slice, DetElement detector);
+      /// Write the collected conditions to a file
+      long write(const std::string& output)  const;
+    };
     
   }        /* End namespace Conditions                          */
 }          /* End namespace DD4hep                              */
@@ -99,15 +148,23 @@ namespace DD4hep {
 #include "DDCond/ConditionsTags.h"
 #include "DDCond/ConditionsSlice.h"
 #include "DDCond/ConditionsManagerObject.h"
+#include "DDCond/ConditionsBinaryFormat.h"
 
 // C/C++ include files
 #include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <unistd.h>
 #include <sstream>
 #include <list>
 #include <set>
 
 using std::string;
 using std::stringstream;
+using std::vector;
+using std::make_pair;
 using namespace DD4hep;
 using namespace DD4hep::Conditions;
 using Geometry::RotationZYX;
@@ -397,6 +454,211 @@ long ConditionsXMLRepositoryWriter::write(XML::Document doc, const string& outpu
   return ret;
 }
 
+/// Add single condition to the records. Returns false if the data type is not supported
+bool ConditionsBinaryRepositoryWriter::add(Condition c)   {
+  namespace BF = ConditionsBinaryFormat;
+  const Condition::Object* o   = c.ptr();
+  const IOV*               iov = o->iov;
+  ReferenceBitMask<Condition::mask_type> msk(c->flags);
+  Record rec;
+
+  if ( !iov || !iov->iovType )
+    return false;
+  rec.key   = o->hash;
+  rec.flags = o->flags;
+  rec.name  = o->name;
+  rec.type  = o->type;
+  if ( msk.isSet(Condition::ALIGNMENT) )  {
+    const Alignments::Delta& delta = c.get<Alignments::Delta>();
+    BF::Delta d;
+    ::memset(&d,0,sizeof(d));
+    d.flags = delta.flags;
+    delta.translation.GetCoordinates(d.translation);
+    delta.pivot.GetComponents(d.pivot[0],d.pivot[1],d.pivot[2]);
+    delta.rotation.GetComponents(d.rotation[0],d.rotation[1],d.rotation[2]);
+    rec.kind = BF::KIND_DELTA;
+    rec.data.assign((const char*)&d,sizeof(d));
+  }
+  else  {
+    const OpaqueData&     data = c.data();
+    const std::type_info& typ  = data.typeInfo();
+    const string&         dtyp = data.dataType();
+    if ( typ == typeid(double) )  {
+      double v = c.get<double>();
+      rec.kind = BF::KIND_DOUBLE;
+      rec.data.assign((const char*)&v,sizeof(v));
+    }
+    else if ( typ == typeid(int) )  {
+      int v = c.get<int>();
+      rec.kind = BF::KIND_INT;
+      rec.data.assign((const char*)&v,sizeof(v));
+    }
+    else if ( typ == typeid(long) )  {
+      long long v = c.get<long>();
+      rec.kind = BF::KIND_LONG;
+      rec.data.assign((const char*)&v,sizeof(v));
+    }
+    else if ( typ == typeid(string) )  {
+      rec.kind = BF::KIND_STRING;
+      rec.data = c.get<string>();
+    }
+    else if ( typ == typeid(float) )  {
+      rec.kind = BF::KIND_TEXT;
+      rec.data = data.str();
+      rec.type = "float";
+    }
+    else  {
+      // Sequences are stored as text and bound like the XML repository parser does
+      static const char* seqs[] = { "::vector<", "::list<", "::set<" };
+      static const char* tags[] = { "vector",    "list",    "set"    };
+      size_t idx = string::npos, idq = string::npos, len = 0, i = 0;
+      for( ; i < 3; ++i )  {
+        len = ::strlen(seqs[i]);
+        if ( (idx=dtyp.find(seqs[i])) != string::npos ) break;
+      }
+      if ( idx == string::npos || (idq=dtyp.find(',',idx+len)) == string::npos )
+        return false;
+      string val_type = dtyp.substr(idx+len,idq-idx-len);
+      if ( val_type.find("basic_string<") != string::npos ) val_type = "string";
+      rec.kind = BF::KIND_TEXT;
+      rec.type = string(tags[i])+"["+val_type+"]";
+      rec.data = data.str();
+    }
+  }
+  unsigned int typ_id = iov->iovType->type;
+  IOVKey k(typ_id,make_pair((long long)iov->keyData.first,(long long)iov->keyData.second));
+  auto ii = m_iovs.insert(make_pair(k,(unsigned int)m_iovs.size()));
+  m_iovTypes[typ_id] = iov->iovType->name;
+  rec.iov = (*ii.first).second;
+  m_records.push_back(rec);
+  return true;
+}
+
+/// Collect the conditions of a slice
+size_t ConditionsBinaryRepositoryWriter::collect(ConditionsSlice& slice)   {
+  return collect(slice, slice.manager->lcdd().world());
+}
+
+/// Collect the conditions of a slice attached to a detector element and its children
+size_t ConditionsBinaryRepositoryWriter::collect(ConditionsSlice& slice, DetElement detector)   {
+  size_t count = 0;
+  if ( detector.isValid() )  {
+    if ( detector.hasConditions() )   {
+      DetConditions det(detector);
+      Container     cont = det.conditions();
+      for(const auto& k : cont.keys() )   {
+        if ( k.first == k.second.first )  {
+          Condition c = cont.get(k.first,*slice.pool);
+          if ( c.isValid() && add(c) )
+            ++count;
+          else if ( c.isValid() )
+            printout(ERROR,"Writer","++ Unconverted condition: %s [%s]",
+                     c.name(), c.data().dataType().c_str());
+        }
+      }
+    }
+    for (const auto& i : detector.children())
+      count += collect(slice,i.second);
+  }
+  return count;
+}
+
+/// Write the collected conditions to a file
+long ConditionsBinaryRepositoryWriter::write(const string& output)  const  {
+  namespace BF = ConditionsBinaryFormat;
+  vector<const Record*>    recs;
+  vector<unsigned int>     rank(m_iovs.size());
+  vector<BF::IOVTypeEntry> types;
+  vector<BF::IOVEntry>     iovs(m_iovs.size());
+  vector<BF::Entry>        entries;
+  string                   data;
+  BF::Header               hdr;
+
+  unsigned int cnt = 0;
+  for(const auto& i : m_iovs) rank[i.second] = cnt++;
+  // Snapshots of several IOV values may contain the same condition with the same IOV.
+  // The IOV index is unique for (IOV type, lower, upper): keep the first record of each.
+  std::set<std::pair<Condition::key_type,unsigned int> > written;
+  for(const auto& r : m_records)  {
+    if ( written.insert(make_pair(r.key,r.iov)).second )
+      recs.push_back(&r);
+  }
+  // Sort by key, IOV type and lower IOV bound: the loader uses binary search on this order
+  std::stable_sort(recs.begin(), recs.end(), [&rank](const Record* a, const Record* b)  {
+      if ( a->key != b->key ) return a->key < b->key;
+      return rank[a->iov] < rank[b->iov];
+    });
+  ::memset(&hdr,0,sizeof(hdr));
+  hdr.num_iov_types = m_iovTypes.size();
+  hdr.num_iovs      = m_iovs.size();
+  hdr.num_entries   = recs.size();
+  hdr.iov_types     = sizeof(hdr);
+  hdr.iovs          = hdr.iov_types + hdr.num_iov_types*sizeof(BF::IOVTypeEntry);
+  hdr.entries       = hdr.iovs      + hdr.num_iovs*sizeof(BF::IOVEntry);
+  hdr.data          = hdr.entries   + hdr.num_entries*sizeof(BF::Entry);
+  ::memcpy(hdr.magic,BF::MAGIC,sizeof(hdr.magic));
+  hdr.version = BF::VERSION;
+
+  for(const auto& t : m_iovTypes)  {
+    BF::IOVTypeEntry e;
+    e.id          = t.first;
+    e.name_offset = hdr.data + data.length();
+    e.name_length = t.second.length();
+    data += t.second;
+    types.push_back(e);
+  }
+  for(const auto& i : m_iovs)  {
+    BF::IOVEntry& e = iovs[i.second];
+    e.iov_type = i.first.first;
+    e.spare    = 0;
+    e.lower    = i.first.second.first;
+    e.upper    = i.first.second.second;
+  }
+  for(const Record* r : recs)  {
+    BF::Entry e;
+    ::memset(&e,0,sizeof(e));
+    e.key         = r->key;
+    e.iov         = r->iov;
+    e.flags       = r->flags;
+    e.kind        = r->kind;
+    e.name_offset = hdr.data + data.length();
+    e.name_length = r->name.length();
+    data += r->name;
+    e.type_offset = hdr.data + data.length();
+    e.type_length = r->type.length();
+    data += r->type;
+    // Keep binary payloads aligned
+    while ( data.length()%sizeof(double) ) data += '\0';
+    e.data_offset = hdr.data + data.length();
+    e.data_length = r->data.length();
+    data += r->data;
+    entries.push_back(e);
+  }
+  hdr.size = hdr.data + data.length();
+
+  string tmp = output + ".tmp";
+  FILE* f = ::fopen(tmp.c_str(),"wb");
+  if ( !f )  {
+    except("Writer","++ Failed to open binary conditions file %s [%s]",
+           tmp.c_str(), ::strerror(errno));
+  }
+  bool ok = 1 == ::fwrite(&hdr,sizeof(hdr),1,f);
+  ok = ok && types.size()   == ::fwrite(types.data(),  sizeof(BF::IOVTypeEntry),types.size(),f);
+  ok = ok && iovs.size()    == ::fwrite(iovs.data(), sizeof(BF::IOVEntry),    iovs.size(),f);
+  ok = ok && entries.size() == ::fwrite(entries.data(),sizeof(BF::Entry),       entries.size(),f);
+  ok = ok && data.length()  == ::fwrite(data.c_str(),1,data.length(),f);
+  ok = (0 == ::fclose(f)) && ok;
+  if ( !ok || 0 != ::rename(tmp.c_str(),output.c_str()) )  {
+    ::unlink(tmp.c_str());
+    except("Writer","++ Failed to write binary conditions file %s [%s]",
+           output.c_str(), ::strerror(errno));
+  }
+  printout(INFO,"Writer","++ Successfully wrote %ld conditions with %ld IOVs to binary file: %s",
+           long(entries.size()), long(iovs.size()), output.c_str());
+  return 1;
+}
+// ======================================================================================
+
 /// Basic entry point to read alignment conditions files
 /**
  *  \author  M.Frank
@@ -482,3 +744,57 @@ static long write_repository_manager(lcdd_t& lcdd, int argc, char** argv)  {
 }
 DECLARE_APPLY(DD4hep_ConditionsXMLManagerWriter,write_repository_manager)
 // ======================================================================================
+/// Basic entry point to write binary conditions repositories
+/**
+ *  Several IOV values may be given: the conditions of all 
+ *  corresponding slices are merged into one file.
+ *
+ *  \author  M.Frank
+ *  \version 1.0
+ *  \date    01/04/2014
+ */
+static long write_binary_repository(lcdd_t& lcdd, int argc, char** argv)  {
+  ConditionsManager manager  =  ConditionsManager::from(lcdd);
+  const IOVType*    iovtype  =  0;
+  vector<long>      iovvalues;
+  string            output;
+
+  for(int i=0; i<argc; ++i)  {
+    if ( ::strncmp(argv[i],"-iov_type",7) == 0 )
+      iovtype = manager.iovType(argv[++i]);
+    else if ( ::strncmp(argv[i],"-iov_value",7) == 0 )
+      iovvalues.push_back(::atol(argv[++i]));
+    else if ( ::strncmp(argv[i],"-output",4) == 0 && argc>i+1)
+      output = argv[++i];
+    else if ( ::strncmp(argv[i],"-help",2) == 0 )  {
+      printout(ALWAYS,"Plugin-Help","Usage: DD4hep_ConditionsBinaryRepositoryWriter --opt [--opt]       ");
+      printout(ALWAYS,"Plugin-Help","  -output    <string>   Output file name.                             ");
+      printout(ALWAYS,"Plugin-Help","  -iov_type  <string>   IOV type to be selected.                      ");
+      printout(ALWAYS,"Plugin-Help","  -iov_value <string>   IOV value to create the conditions snapshot.  ");
+      printout(ALWAYS,"Plugin-Help","                        May be repeated to merge several snapshots.   ");
+      ::exit(EINVAL);
+    }
+  }
+  if ( 0 == iovtype )
+    except("ConditionsPrepare","++ Unknown IOV type supplied.");
+  if ( iovvalues.empty() )
+    except("ConditionsPrepare",
+           "++ Unknown IOV value supplied for iov type %s.",iovtype->str().c_str());
+  if ( output.empty() )
+    except("ConditionsPrepare","++ No output file name supplied.");
+
+  ConditionsBinaryRepositoryWriter writer;
+  for(long iovvalue : iovvalues)  {
+    IOV iov(iovtype,iovvalue);
+    dd4hep_ptr<ConditionsSlice> slice(Conditions::createSlice(manager,*iovtype));
+    ConditionsManager::Result cres = manager.prepare(iov, *slice);
+    printout(INFO,"Conditions",
+             "++ Selected conditions: %7ld conditions (S:%ld,L:%ld,C:%ld,M:%ld) for IOV:%-12s",
+             cres.total(), cres.selected, cres.loaded, cres.computed, cres.missing,
+             iov.str().c_str());
+    writer.collect(*slice);
+  }
+  return writer.write(output);
+}
+DECLARE_APPLY(DD4hep_ConditionsBinaryRepositoryWriter,write_binary_repository)
+// ======================================================================================
@@ -18,6 +18,8 @@
 
 // C/C++ include files
 #include <map>
+#include <set>
+#include <vector>
 #include <unordered_map>
 
 /// Namespace for the AIDA detector description toolkit
@@ -45,23 +47,63 @@ namespace DD4hep {
     template<typename MAPPING> 
     class ConditionsMappedUserPool : public UserPool    {
       typedef MAPPING Mapping;
+      typedef std::pair<IOV::Key_first_type,key_type>       Bound;
+      typedef std::pair<key_type,Condition::Object*>        Pending;
       Mapping               m_conditions;
       /// IOV Pool as data source
       ConditionsIOVPool*    m_iovPool = 0;
       /// The loader to access non-existing conditions
       ConditionsDataLoader* m_loader = 0;
 
+      /** Bookkeeping for the incremental refresh on IOV transitions  */
+      /// Flag to indicate that the bookkeeping is valid for the current content
+      bool                  m_incremental = false;
+      /// Slice the bookkeeping was built for and its size
+      const ConditionsSlice* m_slice = 0;
+      size_t                m_sliceConditions = 0, m_sliceDerived = 0;
+      /// IOV pools covering the IOV of the last preparation
+      ConditionsIOVPool::Elements m_pools;
+      /// Lower and upper IOV bounds of the non-derived conditions
+      std::set<Bound>       m_lower, m_upper;
+      /// Derived conditions in the pool and the IOV pools hosting them
+      std::unordered_map<Condition::Object*,ConditionsPool*> m_derivedOwner;
+      /// Reference count of the IOV pools hosting derived conditions of this pool
+      std::map<ConditionsPool*,size_t> m_derivedPools;
+      /// Derived conditions inserted, which were not yet registered to an IOV pool
+      std::vector<Pending>  m_pendingDerived;
+      /// Reverse dependency map of the derived conditions of the slice
+      std::unordered_map<key_type,std::vector<key_type> > m_dependents;
+
       /// Internal helper to find conditions
       Condition::Object* i_findCondition(key_type key)  const;
 
       /// Internal insertion helper
       bool i_insert(Condition::Object* o);
+      /// Internal removal helper
+      void i_erase(typename Mapping::iterator i);
+      /// Incremental refresh: add a condition to the bookkeeping
+      void i_track(Condition::Object* o);
+      /// Incremental refresh: remove a condition from the bookkeeping
+      void i_untrack(Condition::Object* o);
+      /// Incremental refresh: account derived conditions registered since the last call
+      void i_resolvePending();
+      /// Incremental refresh: drop the bookkeeping. Next preparation is a full one
+      void i_resetIncremental();
+      /// Incremental refresh: build the bookkeeping after a full preparation
+      void i_buildIncremental(const ConditionsSlice& slice);
+      /// Incremental refresh: only replace the expired conditions. False if not applicable
+      bool i_prepareIncremental(const IOV&       required,
+                                ConditionsSlice& slice,
+                                void*            user_param,
+                                Result&          result);
 
     public:
       /// Default constructor
       ConditionsMappedUserPool(ConditionsManager mgr, ConditionsIOVPool* pool);
       /// Default destructor
       virtual ~ConditionsMappedUserPool();
+      /// Flag if the content is refreshed incrementally
+      virtual bool isIncremental() const  {  return m_incremental;  }
       /// Print pool content
       virtual void print(const std::string& opt)   const;
       /// Total entry count
@@ -205,9 +247,96 @@ ConditionsMappedUserPool<MAPPING>::i_insert(Condition::Object* o)   {
            ret ? "Successfully inserted" : "FAILED to insert",
            o->hash, o->name.c_str());
 #endif
+  if ( ret && m_incremental ) i_track(o);
   return ret;
 }
 
+template<typename MAPPING> inline void
+ConditionsMappedUserPool<MAPPING>::i_erase(typename MAPPING::iterator i)   {
+  if ( m_incremental ) i_untrack((*i).second);
+  m_conditions.erase(i);
+}
+
+/// Incremental refresh: add a condition to the bookkeeping
+template<typename MAPPING> void
+ConditionsMappedUserPool<MAPPING>::i_track(Condition::Object* o)   {
+  if ( o->flags&Condition::DERIVED )  {
+    // Derived conditions are registered to their IOV pool only after the insertion
+    m_pendingDerived.push_back(make_pair(o->hash,o));
+  }
+  else if ( o->iov )  {
+    m_lower.insert(make_pair(o->iov->keyData.first,o->hash));
+    m_upper.insert(make_pair(o->iov->keyData.second,o->hash));
+  }
+}
+
+/// Incremental refresh: remove a condition from the bookkeeping
+template<typename MAPPING> void
+ConditionsMappedUserPool<MAPPING>::i_untrack(Condition::Object* o)   {
+  if ( o->flags&Condition::DERIVED )  {
+    auto i = m_derivedOwner.find(o);
+    if ( i != m_derivedOwner.end() )  {
+      auto j = m_derivedPools.find((*i).second);
+      if ( j != m_derivedPools.end() && 0 == --(*j).second )
+        m_derivedPools.erase(j);
+      m_derivedOwner.erase(i);
+    }
+  }
+  else if ( o->iov )  {
+    m_lower.erase(make_pair(o->iov->keyData.first,o->hash));
+    m_upper.erase(make_pair(o->iov->keyData.second,o->hash));
+  }
+}
+
+/// Incremental refresh: account derived conditions registered since the last call
+template<typename MAPPING> void
+ConditionsMappedUserPool<MAPPING>::i_resolvePending()   {
+  for( const auto& p : m_pendingDerived )  {
+    // Only touch objects still owned: removed ones may already be deleted
+    Condition::Object* o = i_findCondition(p.first);
+    if ( o == p.second && o->pool && m_derivedOwner.insert(make_pair(o,o->pool)).second )
+      ++m_derivedPools[o->pool];
+  }
+  m_pendingDerived.clear();
+}
+
+/// Incremental refresh: drop the bookkeeping. Next preparation is a full one
+template<typename MAPPING> void
+ConditionsMappedUserPool<MAPPING>::i_resetIncremental()   {
+  m_incremental = false;
+  m_slice = 0;
+  m_pools.clear();
+  m_lower.clear();
+  m_upper.clear();
+  m_derivedOwner.clear();
+  m_derivedPools.clear();
+  m_pendingDerived.clear();
+  m_dependents.clear();
+}
+
+/// Incremental refresh: build the bookkeeping after a full preparation
+template<typename MAPPING> void
+ConditionsMappedUserPool<MAPPING>::i_buildIncremental(const ConditionsSlice& slice)   {
+  ConditionsIOVPool::Elements pools;
+  pools.swap(m_pools);
+  i_resetIncremental();
+  pools.swap(m_pools);
+  m_incremental = true;
+  for( const auto& i : m_conditions )
+    i_track(i.second);
+  i_resolvePending();
+  for( const auto& i : slice.derived() )  {
+    const ConditionDependency* dep = i.second->dependency;
+    if ( dep )  {
+      for( const auto& k : dep->dependencies )
+        m_dependents[k.hash].push_back(i.first);
+    }
+  }
+  m_slice           = &slice;
+  m_sliceConditions = slice.conditions().size();
+  m_sliceDerived    = slice.derived().size();
+}
+
 /// Total entry count
 template<typename MAPPING>
 size_t ConditionsMappedUserPool<MAPPING>::size()  const  {
@@ -233,6 +362,7 @@ template<typename MAPPING>
 void ConditionsMappedUserPool<MAPPING>::clear()   {
   m_iov = IOV(0);
   m_conditions.clear();
+  i_resetIncremental();
 }
 
 /// Check a condition for existence
@@ -280,7 +410,7 @@ template<typename MAPPING>
 bool ConditionsMappedUserPool<MAPPING>::remove(key_type hash_key)    {
   typename MAPPING::iterator i = m_conditions.find(hash_key);
   if ( i != m_conditions.end() ) {
-    m_conditions.erase(i);
+    i_erase(i);
     return true;
   }
   return false;
@@ -306,13 +436,13 @@ size_t ConditionsMappedUserPool<MAPPING>::compute(const Dependencies& deps,
           if ( IOV::key_is_contained(m_iov.keyData,c->iov->keyData) )  {
             /// This condition is no longer valid. remove it!
             /// This condition will be added again by the handler.
-            m_conditions.erase(j);
+            i_erase(j);
             missing.push_back(i.second.get());
           }
           continue;
         }
         else  {
-          m_conditions.erase(j);
+          i_erase(j);
         }
       }
       missing.push_back(i.second.get());      
@@ -340,6 +470,140 @@ namespace {
   { return make_pair(e.second->key.hash,e.second->dependency); }
 }
 
+/// Incremental refresh: only replace the expired conditions. False if not applicable
+/**
+ *  Conditions whose validity still covers the required IOV are kept.
+ *  Expired conditions are replaced from the IOV pools, which newly cover
+ *  the required IOV, or loaded. Derived conditions are recomputed only
+ *  if they depend directly or indirectly on a replaced condition.
+ */
+template<typename MAPPING> bool
+ConditionsMappedUserPool<MAPPING>::i_prepareIncremental(const IOV&       required,
+                                                        ConditionsSlice& slice,
+                                                        void*            user_param,
+                                                        Result&          result)
+{
+  typedef std::vector<pair<Condition::key_type,ConditionsDescriptor*> > _Missing;
+  const auto& slice_cond = slice.conditions();
+  const auto& slice_calc = slice.derived();
+  if ( !m_incremental || m_slice != &slice || m_iov.iovType != required.iovType )
+    return false;
+  else if ( m_sliceConditions != slice_cond.size() || m_sliceDerived != slice_calc.size() )
+    return false;
+
+  auto&  slice_miss_cond = slice.missingConditions();
+  auto&  slice_miss_calc = slice.missingDerivations();
+  bool   do_output_miss  = m_manager->doOutputUnloaded();
+  const  IOV::Key req    = required.keyData;
+  IOV    pool_iov(required.iovType);
+  ConditionsIOVPool::Elements pools, added;
+  set<key_type> changed, recompute;
+
+  slice_miss_cond.clear();
+  slice_miss_calc.clear();
+  i_resolvePending();
+  pool_iov.reset().invert();
+  m_iovPool->select(required, pools, pool_iov);
+  // IOV pools hosting derived conditions we keep must not be cleaned
+  for( const auto& p : m_derivedPools )
+    m_iovPool->touch(p.first);
+
+  // Non-derived conditions, which no longer cover the required IOV
+  for( auto i=m_lower.upper_bound(Bound(req.first,~0ULL)); i != m_lower.end(); ++i )
+    changed.insert((*i).second);
+  for( auto i=m_upper.begin(); i != m_upper.end() && (*i).first < req.second; ++i )
+    changed.insert((*i).second);
+  for( key_type k : changed )  {
+    typename MAPPING::iterator j = m_conditions.find(k);
+    if ( j != m_conditions.end() ) i_erase(j);
+  }
+  // Derived conditions depending on them: the dependency closure
+  vector<key_type> todo(changed.begin(), changed.end());
+  while( !todo.empty() )  {
+    auto d = m_dependents.find(todo.back());
+    todo.pop_back();
+    if ( d == m_dependents.end() ) continue;
+    for( key_type k : (*d).second )
+      if ( recompute.insert(k).second ) todo.push_back(k);
+  }
+  for( key_type k : recompute )  {
+    typename MAPPING::iterator j = m_conditions.find(k);
+    if ( j != m_conditions.end() ) i_erase(j);
+  }
+  // Pick up the content of IOV pools, which newly cover the required IOV
+  set_difference(pools.begin(), pools.end(), m_pools.begin(), m_pools.end(),
+                 inserter(added, added.end()), pools.value_comp());
+  if ( !added.empty() )  {
+    RangeConditions fresh;
+    for( const auto& p : added )
+      p.second->select_all(fresh);
+    for( Condition& c : fresh )
+      i_insert(c.ptr());
+  }
+  m_pools.swap(pools);
+  m_iov = pool_iov;
+
+  result.loaded   = 0;
+  result.computed = 0;
+  result.missing  = 0;
+  //
+  // Load the expired conditions of the slice, which are not covered by the IOV pools
+  //
+  _Missing cond_missing;
+  for( key_type k : changed )  {
+    auto s = slice_cond.find(k);
+    if ( s != slice_cond.end() && !i_findCondition(k) ) cond_missing.push_back(*s);
+  }
+  if ( !cond_missing.empty() )  {
+    ConditionsDataLoader::LoadedItems loaded;
+    m_loader->load_many(required, cond_missing, loaded, pool_iov);
+    for( const auto& l : loaded )  {
+      Condition::Object* o = l.second.ptr();
+      if ( i_insert(o) )  {
+        m_iov.iov_intersection(o->iov->key());
+        if ( o->pool && o->pool->iov && IOV::key_contains_range(o->pool->iov->keyData,req) )
+          m_pools.insert(make_pair(o->pool->iov->keyData,o->pool));
+        ++result.loaded;
+      }
+    }
+    for( const auto& m : cond_missing )  {
+      if ( !i_findCondition(m.first) )  {
+        ++result.missing;
+        if ( do_output_miss ) slice_miss_cond.insert(m);
+      }
+    }
+  }
+  //
+  // Recompute the derived conditions along the dependency closure
+  //
+  _Missing calc_missing;
+  for( key_type k : recompute )  {
+    auto s = slice_calc.find(k);
+    if ( s != slice_calc.end() && !i_findCondition(k) ) calc_missing.push_back(*s);
+  }
+  if ( !calc_missing.empty() )  {
+    ConditionsDependencyCollection deps(calc_missing.begin(), calc_missing.end(), _to_dep);
+    ConditionsDependencyHandler handler(m_manager, *this, deps, user_param);
+    for( const auto& i : deps )  {
+      const ConditionDependency* d = i.second.get();
+      if ( !i_findCondition(d->key()) ) handler(d);
+    }
+    result.computed = handler.num_callback;
+    for( const auto& m : calc_missing )  {
+      if ( !i_findCondition(m.first) )  {
+        ++result.missing;
+        if ( do_output_miss ) slice_miss_calc.insert(m);
+      }
+    }
+  }
+  result.selected = m_conditions.size() - result.loaded - result.computed;
+  printout(DEBUG,"UserPool","Incremental refresh: %ld expired, %ld loaded, %ld recomputed.",
+           long(changed.size()), long(result.loaded), long(result.computed));
+  // Anything missing: the next preparation has to retry from scratch
+  if ( result.missing > 0 ) i_resetIncremental();
+  return true;
+}
+
 template<typename MAPPING> UserPool::Result
 ConditionsMappedUserPool<MAPPING>::prepare(const IOV&              required, 
                                            ConditionsSlice&        slice,
@@ -352,6 +616,7 @@ ConditionsMappedUserPool<MAPPING>::prepare(const IOV&              required,
   auto&  slice_miss_calc = slice.missingDerivations();
   bool   do_load         = m_manager->doLoadConditions();
   bool   do_output_miss  = m_manager->doOutputUnloaded();
+  bool   do_incremental  = do_load && m_manager->doIncrementalUpdate();
   IOV    pool_iov(required.iovType);
   Result result;
 
@@ -361,11 +626,23 @@ ConditionsMappedUserPool<MAPPING>::prepare(const IOV&              required,
   static mutex lock;
   lock_guard<mutex> guard(lock);
 
+  if ( do_incremental && i_prepareIncremental(required, slice, user_param, result) )  {
+    return result;
+  }
+  i_resetIncremental();
   m_conditions.clear();
   slice_miss_cond.clear();
   slice_miss_calc.clear();
   pool_iov.reset().invert();
-  m_iovPool->select(required, Operators::mapConditionsSelect(m_conditions), pool_iov);
+  if ( do_incremental )  {
+    // Remember the selected IOV pools for the next incremental refresh
+    m_iovPool->select(required, m_pools, pool_iov);
+    for( const auto& p : m_pools )
+      p.second->select_all(Operators::mapConditionsSelect(m_conditions));
+  }
+  else  {
+    m_iovPool->select(required, Operators::mapConditionsSelect(m_conditions), pool_iov);
+  }
   m_iov = pool_iov;
   _Missing cond_missing(slice_cond.size()+m_conditions.size());
   _Missing calc_missing(slice_calc.size()+m_conditions.size());
@@ -454,6 +731,9 @@ ConditionsMappedUserPool<MAPPING>::prepare(const IOV&              required,
       copy(begin(calc_missing), last_calc, inserter(slice_miss_calc, slice_miss_calc.begin()));
     }
   }
+  if ( do_incremental && result.missing == 0 )  {
+    i_buildIncremental(slice);
+  }
   return result;
 }
 
@@ -475,6 +755,7 @@ ConditionsMappedUserPool<MAPPING>::load(const IOV&              required,
   static mutex lock;
   lock_guard<mutex> guard(lock);
 
+  i_resetIncremental();
   m_conditions.clear();
   slice_miss_cond.clear();
   pool_iov.reset().invert();
@@ -547,6 +828,7 @@ ConditionsMappedUserPool<MAPPING>::compute(const IOV&              required,
   static mutex lock;
   lock_guard<mutex> guard(lock);
 
+  i_resetIncremental();
   slice_miss_calc.clear();
   _Missing calc_missing(slice_calc.size()+m_conditions.size());
   _Missing::iterator last_calc = set_difference(begin(slice_calc),   end(slice_calc),
@@ -227,6 +227,7 @@ template class DD4hep::Handle<TNamed>;
 
 #pragma link C++ class DD4hep::Conditions::Condition+;
 #pragma link C++ class vector<DD4hep::Conditions::Condition>+;
+#pragma link C++ class DD4hep::Conditions::Interna::InternedString-;
 #pragma link C++ class DD4hep::Conditions::Interna::ConditionObject+;
 #pragma link C++ class DD4hep::Handle<DD4hep::Conditions::Interna::ConditionObject>+;
 
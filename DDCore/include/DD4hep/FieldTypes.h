@@ -41,6 +41,8 @@ namespace DD4hep {
       ConstantField() : direction() {  }
       /// Call to access the field components at a given location
       virtual void fieldComponents(const double* /* pos */, double* field);
+      /// Call to access the field components at n locations
+      virtual void batchFieldComponents(size_t n, const double* /* pos */, double* field);
     };
 
     /// Implementation object of a solenoidal magnetic field.
@@ -65,6 +67,8 @@ namespace DD4hep {
       SolenoidField();
       /// Call to access the field components at a given location
       virtual void fieldComponents(const double* pos, double* field);
+      /// Call to access the field components at n locations
+      virtual void batchFieldComponents(size_t n, const double* pos, double* field);
     };
 
     /// Implementation object of a dipole magnetic field.
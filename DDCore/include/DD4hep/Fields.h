@@ -70,6 +70,13 @@ namespace DD4hep {
 	 *  field vector in order to allow for superposition of the fields.
 	 */
         virtual void fieldComponents(const double* pos, double* field) = 0;
+
+        /** Compute the field components at n locations (pos[3*n], field[3*n]).
+         *  As for fieldComponents the values are added to the field vectors.
+         *  The default implementation loops over the single point call.
+         *  Overwrite if the field can be computed more efficiently in bulk.
+         */
+        virtual void batchFieldComponents(size_t n, const double* pos, double* field);
       };
 
       /// Default constructor
@@ -105,6 +112,9 @@ namespace DD4hep {
       /// Returns the 3 field components (x, y, z).
       void value(const double* pos, double* val) const;
 
+      /// Adds the 3 field components (x, y, z) at n positions: pos[3*n], val[3*n].
+      void values(size_t n, const double* pos, double* val) const;
+
       /// Access to properties container
       Properties& properties() const;
     };
@@ -235,6 +245,12 @@ namespace DD4hep {
       /// Returns the 3 electric (val[0]-val[2]) and magnetic field components (val[3]-val[5]).
       void electromagneticField(const double* pos, double* val) const;
 
+      /// Returns the 3 electric field components at n positions: pos[3*n], field[3*n]
+      void electricFields(size_t n, const double* pos, double* field) const;
+
+      /// Returns the 3 magnetic field components at n positions: pos[3*n], field[3*n]
+      void magneticFields(size_t n, const double* pos, double* field) const;
+
       /// Access to properties container
       Properties& properties() const;
     };
@@ -142,6 +142,43 @@ namespace DD4hep {
 #endif
   };
 
+#if !defined(DD4HEP_ROOT_VERSION_5)
+  /// Pre-resolved typed handle to a plugin factory
+  /**
+   *  The factory is looked up once by name in the plugin registry.
+   *  Invocations call the creator directly without any further
+   *  string lookup or library access:
+   *
+   *  PluginFactory<long(Geometry::LCDD*,int,char**)> f("MyPlugin");
+   *  if ( f.isValid() ) f(&lcdd, argc, argv);
+   *
+   *  Invoking an invalid handle returns 0 like PluginService::Create.
+   *
+   *  \author  M.Frank
+   *  \version 1.0
+   *  \ingroup DD4HEP
+   */
+  template <typename SIGNATURE> class PluginFactory;
+  template <typename R, typename... Args> class PluginFactory<R(Args...)>  {
+  public:
+    typedef R (*function_t)(Args...);
+  private:
+    /// Resolved creator function
+    PluginService::FuncPointer<function_t> m_creator;
+  public:
+    /// Default constructor: invalid handle
+    PluginFactory() {}
+    /// Initializing constructor: resolves the factory by name
+    PluginFactory(const std::string& id) : m_creator(PluginService::getCreator(id,typeid(R(Args...)))) {}
+    /// Check if the factory could be resolved
+    bool isValid() const                {  return m_creator.fptr.ptr != 0;  }
+    /// Invoke the factory
+    R operator()(Args... args) const  {
+      return m_creator.fptr.ptr ? (*m_creator.fptr.fcn)(std::forward<Args>(args)...) : 0;
+    }
+  };
+#endif
+
   /// Factory template for the plugin mechanism
   template <typename SIGNATURE> class PluginRegistry {
   public:
@@ -90,6 +90,8 @@ namespace DD4hep {
       VolumeID volumeID(const CellID& cellID) const;
       /// Calculates the neighbours of the given cell ID and adds them to the list of neighbours
       void neighbours(const CellID& cellID, std::set<CellID>& neighbours) const;
+      /// Calculates the neighbours of the given cell ID into a caller buffer. Returns the number of neighbours
+      size_t neighbours(const CellID& cellID, CellID* buffer, size_t maxNeighbours) const;
       /** \brief Returns a vector<double> of the cellDimensions of the given cell ID
        *  in natural order of dimensions, e.g., dx/dy/dz, or dr/r*dPhi
        *
@@ -30,6 +30,10 @@
 
 // C/C++ include files
 #include <map>
+#include <iosfwd>
+
+// Forward declarations
+class TBuffer;
 
 /// Namespace for the AIDA detector description toolkit
 namespace DD4hep {
@@ -83,6 +87,65 @@ namespace DD4hep {
       class ConditionContainer;
       class ConditionObject;
       
+      /// Immutable string, which shares the text with all other strings of equal content
+      /**
+       *  Condition addresses, validities and comments are mostly identical
+       *  for large numbers of conditions. The text is kept once in a process
+       *  wide table and the object only holds a reference to it. The table
+       *  entries are never released: the table only grows with the number 
+       *  of distinct texts. Copies and the empty string do not access the
+       *  table at all.
+       *
+       *  The text is streamed by value. It is re-interned when read back.
+       *
+       *  \author  M.Frank
+       *  \version 1.0
+       *  \ingroup DD4HEP_CONDITIONS
+       */
+      class InternedString  {
+        /// Reference to the text in the string table. NULL for the empty string
+        const std::string* m_text = 0;
+        /// Access the table entry corresponding to a given text
+        static const std::string* intern(const std::string& text);
+        /// Access the empty text
+        static const std::string& null_text();
+      public:
+        /// Default constructor: empty string
+        InternedString() = default;
+        /// Initializing constructor
+        InternedString(const std::string& text) : m_text(intern(text))   {}
+        /// Initializing constructor
+        InternedString(const char* text) : m_text(text && *text ? intern(text) : 0) {}
+        /// Copy constructor
+        InternedString(const InternedString& copy) = default;
+        /// Assignment operator
+        InternedString& operator=(const InternedString& copy) = default;
+        /// Assignment from string
+        InternedString& operator=(const std::string& text)
+        {  m_text = intern(text); return *this;                             }
+        /// Assignment from character string
+        InternedString& operator=(const char* text)
+        {  m_text = text && *text ? intern(text) : 0; return *this;         }
+        /// Access the text
+        const std::string& str() const          {  return m_text ? *m_text : null_text(); }
+        /// Automatic conversion to the text
+        operator const std::string&() const     {  return str();            }
+        /// Access the text as character string
+        const char* c_str() const               {  return m_text ? m_text->c_str() : "";  }
+        /// Length of the text
+        size_t length() const                   {  return m_text ? m_text->length() : 0;  }
+        /// Check for empty text
+        bool empty() const                      {  return m_text == 0;      }
+        /// Equality: Identical texts share the table entry
+        bool operator==(const InternedString& c) const { return m_text == c.m_text; }
+        /// Inequality
+        bool operator!=(const InternedString& c) const { return m_text != c.m_text; }
+        /// ROOT I/O: stream the text and re-intern it on reading
+        void Streamer(TBuffer& buff);
+      };
+      /// Output of interned strings
+      std::ostream& operator<<(std::ostream& os, const InternedString& s);
+
       /// The data class behind a conditions handle.
       /**
        *  See ConditionsInterna.cpp for the implementation.
@@ -104,12 +167,12 @@ namespace DD4hep {
 
         /// Condition value (in string form)
         std::string     value;
-        /// Condition validity (in string form)
-        std::string     validity;
-        /// Condition address
-        std::string     address;
-        /// Comment string
-        std::string     comment;
+        /// Condition validity (in string form). Shared between conditions
+        InternedString  validity;
+        /// Condition address. Shared between conditions
+        InternedString  address;
+        /// Comment string. Shared between conditions
+        InternedString  comment;
         /// Data block
         OpaqueDataBlock data;
         /// Reference to conditions pool
@@ -128,6 +191,10 @@ namespace DD4hep {
         ConditionObject(const std::string& nam,const std::string& tit="");
         /// Standard Destructor
         virtual ~ConditionObject();
+        /// Allocation from the slab allocator of condition objects
+        static void* operator new(size_t size);
+        /// Release memory to the slab allocator of condition objects
+        static void operator delete(void* ptr, size_t size);
         /// Data offset from the opaque data block pointer to the condition
         static size_t offset();
         /// Move data content: 'from' will be reset to NULL
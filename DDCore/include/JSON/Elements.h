@@ -102,10 +102,9 @@ namespace DD4hep {
      */
     class NodeList {
     public:
-      typedef std::pair<JsonElement::second_type::assoc_iterator,JsonElement::second_type::assoc_iterator> iter_t;
       std::string    m_tag;
       JsonElement*   m_node;
-      mutable iter_t m_ptr;
+      mutable JsonElement* m_ptr;
 
       /// Copy constructor
       NodeList(const NodeList& l);
@@ -198,6 +197,7 @@ namespace DD4hep {
     };
 
 #define INLINE inline
+    // Numbers and booleans were converted by the parser: no need for the expression evaluator
     template <> INLINE Attribute Handle_t::attr<Attribute>(const char* tag_value) const {
       return attr_ptr(tag_value);
     }
@@ -207,23 +207,28 @@ namespace DD4hep {
     }
 
     template <> INLINE bool Handle_t::attr<bool>(const char* tag_value) const {
-      return _toBool(attr_value(tag_value));
+      Attribute a = attr_ptr(tag_value);
+      return a->type == JsonElement::JSON_TRUE || (a->type != JsonElement::JSON_FALSE && _toBool(a->text));
     }
 
     template <> INLINE int Handle_t::attr<int>(const char* tag_value) const {
-      return _toInt(attr_value(tag_value));
+      Attribute a = attr_ptr(tag_value);
+      return a->type == JsonElement::JSON_NUMBER ? int(a->number) : _toInt(a->text);
     }
     
     template <> INLINE long Handle_t::attr<long>(const char* tag_value) const {
-      return _toLong(attr_value(tag_value));
+      Attribute a = attr_ptr(tag_value);
+      return a->type == JsonElement::JSON_NUMBER ? long(a->number) : _toLong(a->text);
     }
 
     template <> INLINE float Handle_t::attr<float>(const char* tag_value) const {
-      return _toFloat(attr_value(tag_value));
+      Attribute a = attr_ptr(tag_value);
+      return a->type == JsonElement::JSON_NUMBER ? float(a->number) : _toFloat(a->text);
     }
 
     template <> INLINE double Handle_t::attr<double>(const char* tag_value) const {
-      return _toDouble(attr_value(tag_value));
+      Attribute a = attr_ptr(tag_value);
+      return a->type == JsonElement::JSON_NUMBER ? double(a->number) : _toDouble(a->text);
     }
 
     template <> INLINE std::string Handle_t::attr<std::string>(const char* tag_value) const {
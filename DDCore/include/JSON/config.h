@@ -13,9 +13,10 @@
 #ifndef DD4HEP_DDCORE_JSON_CONFIG_H
 #define DD4HEP_DDCORE_JSON_CONFIG_H
 
-#define DD4HEP_USE_BOOST_JSON 1
-
-#include "boost/property_tree/ptree.hpp"
+// C/C++ include files
+#include <memory>
+#include <string>
+#include <vector>
 
 /// Namespace for the AIDA detector description toolkit
 namespace DD4hep {
@@ -23,12 +24,69 @@ namespace DD4hep {
   /// Namespace for the AIDA detector description toolkit supporting JSON utilities
   namespace JSON {
 
-    typedef char                                    XmlChar;
-    typedef boost::property_tree::ptree             ptree;
-    typedef boost::property_tree::ptree             JsonDocument;
-    typedef boost::property_tree::ptree::value_type JsonAttr;
-    typedef boost::property_tree::ptree::value_type JsonElement;
+    typedef char XmlChar;
+
+    /// Node of a parsed JSON document
+    /**
+     *  Objects, arrays and values are all represented by nodes.
+     *  Object members are children tagged with the member name,
+     *  array items are children with an empty tag. Values keep
+     *  their text representation; numbers are in addition converted
+     *  at parse time.
+     *  Nodes and strings are owned by the JsonDocument.
+     *
+     *  \author  M.Frank
+     *  \version 1.0
+     *  \ingroup DD4HEP_JSON
+     */
+    class JsonElement  {
+    public:
+      /// Value types
+      enum Type { JSON_NULL=0, JSON_FALSE, JSON_TRUE, JSON_NUMBER, JSON_STRING, JSON_ARRAY, JSON_OBJECT };
+      /// Node tag: object member name (empty for array items)
+      const char*  tag;
+      /// Text of the value (empty for objects and arrays)
+      const char*  text;
+      /// Numeric value (only valid for type JSON_NUMBER)
+      double       number;
+      /// First child node
+      JsonElement* child;
+      /// Next sibling
+      JsonElement* next;
+      /// Previous sibling
+      JsonElement* prev;
+      /// Value type
+      unsigned int type;
+      /// Number of children
+      unsigned int numChildren;
+    };
+    typedef JsonElement JsonAttr;
+
+    /// Parsed JSON document. The document is the root node and owns all memory.
+    /**
+     *  Nodes are allocated in blocks. Strings are not copied: they are
+     *  unescaped and terminated in place in the document buffer.
+     *
+     *  \author  M.Frank
+     *  \version 1.0
+     *  \ingroup DD4HEP_JSON
+     */
+    class JsonDocument : public JsonElement  {
+      /// Document text, modified in place by the parser
+      std::vector<char> m_buffer;
+      /// Node blocks
+      std::vector<std::unique_ptr<JsonElement[]> > m_blocks;
+      /// Number of used nodes in the last block
+      size_t m_used;
+    public:
+      /// Initializing constructor. Parses the document text.
+      JsonDocument(const std::string& name, std::vector<char>&& data);
+      /// Default destructor
+      ~JsonDocument();
+      /// Allocate a new node
+      JsonElement* allocate();
+    };
 
-  }       /* End namespace JSON              */
+}       /* End namespace JSON              */
 }         /* End namespace DD4hep            */
 #endif    /* DD4HEP_DDCORE_JSON_CONFIG_H  */
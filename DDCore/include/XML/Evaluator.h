@@ -231,6 +231,12 @@ namespace XmlTools {
      */
     void clear();
 
+    /**
+     * Returns a counter, which changes whenever the dictionary changes.
+     * Allows clients to cache evaluation results.
+     */
+    unsigned long generation() const;
+
     /**
      * Sets standard mathematical functions and constants.
      */
@@ -20,12 +20,126 @@
 #include "DD4hep/objects/DetectorInterna.h"
 #include "DD4hep/objects/ConditionsInterna.h"
 
+// ROOT include files
+#include "TBuffer.h"
+#include "TString.h"
+
+// C/C++ include files
+#include <mutex>
+#include <vector>
+#include <ostream>
+#include <unordered_set>
+
 using namespace std;
 using namespace DD4hep::Conditions;
 
 DD4HEP_INSTANTIATE_HANDLE_NAMED(Interna::ConditionObject);
 DD4HEP_INSTANTIATE_HANDLE_NAMED(Interna::ConditionContainer);
 
+namespace {
+
+  /// Process wide table of interned condition strings
+  class StringTable  {
+    mutex                 lock;
+    unordered_set<string> texts;
+  public:
+    /// Access the table entry of a given text. Entries are stable: nodes never move
+    const string* intern(const string& text)  {
+      lock_guard<mutex> guard(lock);
+      return &(*texts.insert(text).first);
+    }
+  };
+
+  /// Slab allocator for objects of a fixed size
+  /** Memory is taken from the system in slabs of many objects and
+   *  released objects are kept in a free list for re-use.
+   *  Slabs are never returned to the system.
+   */
+  class ObjectSlab  {
+    enum { SLAB_ENTRIES = 1024 };
+    mutex          lock;
+    size_t         size;
+    void*          free_list = 0;
+    vector<char*>  slabs;
+  public:
+    ObjectSlab(size_t sz) : size(sz < sizeof(void*) ? sizeof(void*) : sz) {}
+    void* allocate()  {
+      lock_guard<mutex> guard(lock);
+      if ( !free_list )  {
+        char* slab = (char*)::operator new(size*SLAB_ENTRIES);
+        slabs.push_back(slab);
+        for(size_t i=0; i<SLAB_ENTRIES; ++i)  {
+          void* p = slab + (SLAB_ENTRIES-1-i)*size;
+          *(void**)p = free_list;
+          free_list = p;
+        }
+      }
+      void* p = free_list;
+      free_list = *(void**)p;
+      return p;
+    }
+    void release(void* p)  {
+      lock_guard<mutex> guard(lock);
+      *(void**)p = free_list;
+      free_list = p;
+    }
+  };
+
+  /// Global string table. Never deleted: conditions may be destroyed at image exit
+  StringTable& string_table()  {
+    static StringTable* table = new StringTable();
+    return *table;
+  }
+
+  /// Global slab of condition objects. Never deleted for the same reason
+  ObjectSlab& condition_slab()  {
+    static ObjectSlab* slab = new ObjectSlab(sizeof(Interna::ConditionObject));
+    return *slab;
+  }
+}
+
+/// Access the table entry corresponding to a given text
+const string* Interna::InternedString::intern(const string& text)   {
+  return text.empty() ? 0 : string_table().intern(text);
+}
+
+/// Access the empty text
+const string& Interna::InternedString::null_text()   {
+  static const string empty_text;
+  return empty_text;
+}
+
+/// ROOT I/O: stream the text and re-intern it on reading
+void Interna::InternedString::Streamer(TBuffer& buff)   {
+  if ( buff.IsReading() )  {
+    TString text;
+    buff.ReadTString(text);
+    m_text = intern(string(text.Data(),text.Length()));
+    return;
+  }
+  TString text(c_str(),length());
+  buff.WriteTString(text);
+}
+
+/// Output of interned strings
+ostream& DD4hep::Conditions::Interna::operator<<(ostream& os, const InternedString& s)  {
+  return os << s.str();
+}
+
+/// Allocation from the slab allocator of condition objects
+void* Interna::ConditionObject::operator new(size_t size)   {
+  // Sub-classes have a different size and use the standard heap
+  if ( size != sizeof(ConditionObject) ) return ::operator new(size);
+  return condition_slab().allocate();
+}
+
+/// Release memory to the slab allocator of condition objects
+void Interna::ConditionObject::operator delete(void* ptr, size_t size)   {
+  if ( !ptr ) return;
+  else if ( size != sizeof(ConditionObject) ) ::operator delete(ptr);
+  else condition_slab().release(ptr);
+}
+
 /// Default constructor
 Interna::ConditionObject::ConditionObject()
   : NamedObject(), value(), validity(), address(), comment(),
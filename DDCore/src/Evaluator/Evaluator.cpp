@@ -47,6 +47,7 @@ namespace {
     pchar    thePosition;
     int      theStatus;
     double   theResult;
+    unsigned long theGeneration;
   };
 
   union FCN {
@@ -574,6 +575,7 @@ static void setItem(const char * prefix, const char * name,
 
   string item_name = prefix + string(pointer,n);
   dic_type::iterator iter = (s->theDictionary).find(item_name);
+  ++s->theGeneration;
   if (iter != (s->theDictionary).end()) {
     iter->second = item;
     if (item_name == name) {
@@ -598,6 +600,7 @@ namespace XmlTools {
     s->thePosition   = 0;
     s->theStatus     = OK;
     s->theResult     = 0.0;
+    s->theGeneration = 0;
   }
 
   //---------------------------------------------------------------------------
@@ -686,6 +689,7 @@ namespace XmlTools {
     item.expression = value;
     item.function = 0;
     item.variable = 0;
+    ++s->theGeneration;
     //std::cout << " ++++++++++++++++++++++++++++ Saving env:" << name << " = " << value << std::endl;
     if (iter != (s->theDictionary).end()) {
       iter->second = item;
@@ -789,6 +793,7 @@ namespace XmlTools {
     if (n == 0) return;
     Struct * s = reinterpret_cast<Struct*>(p);
     (s->theDictionary).erase(string(pointer,n));
+    ++s->theGeneration;
   }
 
   //---------------------------------------------------------------------------
@@ -799,6 +804,7 @@ namespace XmlTools {
     if (n == 0) return;
     Struct * s = reinterpret_cast<Struct*>(p);
     (s->theDictionary).erase(sss[npar]+string(pointer,n));
+    ++s->theGeneration;
   }
 
   //---------------------------------------------------------------------------
@@ -809,6 +815,12 @@ namespace XmlTools {
     s->thePosition   = 0;
     s->theStatus     = OK;
     s->theResult     = 0.0;
+    ++s->theGeneration;
+  }
+
+  //---------------------------------------------------------------------------
+  unsigned long Evaluator::generation() const {
+    return reinterpret_cast<Struct*>(p)->theGeneration;
   }
 
   //---------------------------------------------------------------------------
@@ -34,6 +34,16 @@ void ConstantField::fieldComponents(const double* /* pos */, double* field) {
   field[2] += direction.Z();
 }
 
+/// Call to access the field components at n locations
+void ConstantField::batchFieldComponents(size_t n, const double* /* pos */, double* field) {
+  const double dx = direction.X(), dy = direction.Y(), dz = direction.Z();
+  for (size_t i = 0; i < n; ++i, field += 3)  {
+    field[0] += dx;
+    field[1] += dy;
+    field[2] += dz;
+  }
+}
+
 /// Initializing constructor
 SolenoidField::SolenoidField()
   : innerField(0), outerField(0), minZ(-INFINITY), maxZ(INFINITY), innerRadius(0), outerRadius(INFINITY) {
@@ -53,6 +63,20 @@ void SolenoidField::fieldComponents(const double* pos, double* field) {
   }
 }
 
+/// Call to access the field components at n locations
+void SolenoidField::batchFieldComponents(size_t n, const double* pos, double* field) {
+  // Branch-free formulation of fieldComponents to allow vectorization.
+  // The radius is compared like in fieldComponents: comparing the squared radius
+  // with the squared boundaries gives different results close to the boundaries.
+  for (size_t i = 0; i < n; ++i)  {
+    const double* p = pos + 3*i;
+    double radius = std::sqrt(p[0] * p[0] + p[1] * p[1]);
+    bool   in_z   = p[2] > minZ && p[2] < maxZ;
+    double b      = radius < innerRadius ? innerField : (radius < outerRadius ? outerField : 0.0);
+    field[3*i+2] += in_z ? b : 0.0;
+  }
+}
+
 /// Initializing constructor
 DipoleField::DipoleField()
   : zmax(INFINITY), zmin(-INFINITY), rmax(INFINITY) {
@@ -15,6 +15,9 @@
 #include "DD4hep/Fields.h"
 #include "DD4hep/InstanceCount.h"
 
+// C/C++ include files
+#include <algorithm>
+
 using namespace std;
 using namespace DD4hep::Geometry;
 
@@ -28,6 +31,14 @@ namespace {
   void calculate_combined_field(vector<CartesianField>& v, const double* pos, double* field) {
     for (const auto& i : v ) i.value(pos, field);
   }
+  void calculate_combined_fields(const CartesianField& f, vector<CartesianField>& v,
+                                 size_t n, const double* pos, double* field) {
+    std::fill(field, field + 3*n, 0e0);
+    if ( f.isValid() )
+      f.values(n, pos, field);
+    else
+      for (const auto& i : v ) i.values(n, pos, field);
+  }
 }
 
 /// Default constructor
@@ -46,6 +57,12 @@ const char* CartesianField::type() const {
   return m_element->GetTitle();
 }
 
+/// Compute the field components at n locations. Default: loop over the single point call
+void CartesianField::Object::batchFieldComponents(size_t n, const double* pos, double* field) {
+  for (size_t i = 0; i < n; ++i, pos += 3, field += 3)
+    fieldComponents(pos, field);
+}
+
 /// Does the field change the energy of charged particles?
 bool CartesianField::changesEnergy() const {
   return ELECTRIC == (fieldType() & ELECTRIC);
@@ -71,6 +88,11 @@ void CartesianField::value(const double* pos, double* val) const {
   data<Object>()->fieldComponents(pos, val);
 }
 
+/// Adds the 3 field components (x, y, z) at n positions.
+void CartesianField::values(size_t n, const double* pos, double* val) const {
+  data<Object>()->batchFieldComponents(n, pos, val);
+}
+
 /// Default constructor
 OverlayedField::Object::Object()
   : type(0), electric(), magnetic() {
@@ -147,3 +169,15 @@ void OverlayedField::electromagneticField(const double* pos, double* field) cons
   calculate_combined_field(o->electric_components, pos, field);
   calculate_combined_field(o->magnetic_components, pos, field + 3);
 }
+
+/// Returns the 3 electric field components at n positions
+void OverlayedField::electricFields(size_t n, const double* pos, double* field) const {
+  Object* o = data<Object>();
+  calculate_combined_fields(o->electric, o->electric_components, n, pos, field);
+}
+
+/// Returns the 3 magnetic field components at n positions
+void OverlayedField::magneticFields(size_t n, const double* pos, double* field) const {
+  Object* o = data<Object>();
+  calculate_combined_fields(o->magnetic, o->magnetic_components, n, pos, field);
+}
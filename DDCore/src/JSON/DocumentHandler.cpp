@@ -15,13 +15,267 @@
 #include "JSON/DocumentHandler.h"
 
 // C/C++ include files
-#include "boost/property_tree/json_parser.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
 #include <memory>
 #include <stdexcept>
 
 using namespace std;
 using namespace DD4hep::JSON;
 
+namespace {
+
+  /// Number of nodes allocated at once
+  static const size_t NODE_BLOCK_SIZE = 1024;
+  /// Maximal nesting depth of objects and arrays
+  static const int    MAX_DEPTH       = 512;
+
+  /// In-place recursive descent JSON parser
+  /**
+   *  Strings are unescaped and null terminated in the document buffer.
+   *  Since escape sequences are never shorter than their expansion,
+   *  the output never overtakes the input.
+   */
+  class JsonParser  {
+    JsonDocument* doc;
+    const string& name;
+    char*         begin;
+    char*         ptr;
+
+    [[noreturn]] void error(const char* msg)  const  {
+      size_t line = 1, col = 1;
+      for(const char* p=begin; p<ptr; ++p)  {
+        if ( *p == '\n' ) { ++line; col = 1; } else ++col;
+      }
+      char text[256];
+      ::snprintf(text,sizeof(text),":%ld:%ld: ",long(line),long(col));
+      throw runtime_error("JsonParser: "+name+text+msg);
+    }
+    void skip_white()  {
+      while( *ptr == ' ' || *ptr == '\n' || *ptr == '\t' || *ptr == '\r' ) ++ptr;
+    }
+    /// Parse hex digits of a \u escape sequence
+    unsigned int hex4()  {
+      unsigned int v = 0;
+      for(int i=0; i<4; ++i, ++ptr)  {
+        char c = *ptr;
+        v <<= 4;
+        if      ( c >= '0' && c <= '9' ) v |= c-'0';
+        else if ( c >= 'a' && c <= 'f' ) v |= c-'a'+10;
+        else if ( c >= 'A' && c <= 'F' ) v |= c-'A'+10;
+        else error("Invalid unicode escape sequence");
+      }
+      return v;
+    }
+    /// Parse string starting after the opening quote. Returns the unescaped string.
+    const char* string_value()  {
+      char* start = ptr;
+      char* out   = ptr;
+      for(;;)  {
+        char c = *ptr;
+        if ( c == '"' )  {
+          ++ptr;
+          *out = 0;
+          return start;
+        }
+        else if ( c == 0 )  {
+          error("Unterminated string");
+        }
+        else if ( c != '\\' )  {
+          *out++ = *ptr++;
+          continue;
+        }
+        switch( *++ptr )  {
+        case '"':  *out++ = '"';  break;
+        case '\\': *out++ = '\\'; break;
+        case '/':  *out++ = '/';  break;
+        case 'b':  *out++ = '\b'; break;
+        case 'f':  *out++ = '\f'; break;
+        case 'n':  *out++ = '\n'; break;
+        case 'r':  *out++ = '\r'; break;
+        case 't':  *out++ = '\t'; break;
+        case 'u':  {
+          ++ptr;
+          unsigned int cp = hex4();
+          if ( cp >= 0xD800 && cp <= 0xDBFF )  {
+            if ( ptr[0] != '\\' || ptr[1] != 'u' ) error("Invalid unicode surrogate pair");
+            ptr += 2;
+            unsigned int lo = hex4();
+            if ( lo < 0xDC00 || lo > 0xDFFF ) error("Invalid unicode surrogate pair");
+            cp = 0x10000 + ((cp-0xD800)<<10) + (lo-0xDC00);
+          }
+          if ( cp < 0x80 )  {
+            *out++ = char(cp);
+          }
+          else if ( cp < 0x800 )  {
+            *out++ = char(0xC0 | (cp>>6));
+            *out++ = char(0x80 | (cp&0x3F));
+          }
+          else if ( cp < 0x10000 )  {
+            *out++ = char(0xE0 | (cp>>12));
+            *out++ = char(0x80 | ((cp>>6)&0x3F));
+            *out++ = char(0x80 | (cp&0x3F));
+          }
+          else  {
+            *out++ = char(0xF0 | (cp>>18));
+            *out++ = char(0x80 | ((cp>>12)&0x3F));
+            *out++ = char(0x80 | ((cp>>6)&0x3F));
+            *out++ = char(0x80 | (cp&0x3F));
+          }
+          continue;
+        }
+        default:
+          error("Invalid escape sequence");
+        }
+        ++ptr;
+      }
+    }
+    /// Parse number. The text is null terminated once the following token was inspected.
+    char* number_value(JsonElement* e)  {
+      char* start = ptr;
+      if ( *ptr == '-' ) ++ptr;
+      if ( *ptr == '0' ) ++ptr;
+      else if ( *ptr >= '1' && *ptr <= '9' ) while( *ptr >= '0' && *ptr <= '9' ) ++ptr;
+      else error("Invalid number");
+      if ( *ptr == '.' )  {
+        if ( !(*++ptr >= '0' && *ptr <= '9') ) error("Invalid number");
+        while( *ptr >= '0' && *ptr <= '9' ) ++ptr;
+      }
+      if ( *ptr == 'e' || *ptr == 'E' )  {
+        ++ptr;
+        if ( *ptr == '+' || *ptr == '-' ) ++ptr;
+        if ( !(*ptr >= '0' && *ptr <= '9') ) error("Invalid number");
+        while( *ptr >= '0' && *ptr <= '9' ) ++ptr;
+      }
+      e->type   = JsonElement::JSON_NUMBER;
+      e->text   = start;
+      e->number = ::strtod(start, 0);
+      return ptr;
+    }
+    /// Parse a literal (true, false, null)
+    void literal(JsonElement* e, const char* text, size_t len, unsigned int typ)  {
+      if ( ::strncmp(ptr, text, len) != 0 ) error("Invalid literal");
+      ptr += len;
+      e->type = typ;
+      e->text = text;
+    }
+    /// Append a new child node
+    JsonElement* add_child(JsonElement* parent, JsonElement*& last, const char* tag)  {
+      JsonElement* e = doc->allocate();
+      e->tag = tag;
+      e->prev = last;
+      if ( last ) last->next = e;
+      else parent->child = e;
+      last = e;
+      ++parent->numChildren;
+      return e;
+    }
+    /// Parse the value of a node. Returns the location to be null terminated after the next token.
+    char* value(JsonElement* e, int depth)  {
+      skip_white();
+      switch( *ptr )  {
+      case '{':  ++ptr; object(e, depth+1); return 0;
+      case '[':  ++ptr; array(e, depth+1);  return 0;
+      case '"':
+        ++ptr;
+        e->type = JsonElement::JSON_STRING;
+        e->text = string_value();
+        return 0;
+      case 't':  literal(e, "true",  4, JsonElement::JSON_TRUE);  return 0;
+      case 'f':  literal(e, "false", 5, JsonElement::JSON_FALSE); return 0;
+      case 'n':  literal(e, "null",  4, JsonElement::JSON_NULL);  return 0;
+      default:
+        return number_value(e);
+      }
+    }
+    /// Parse object members after the opening brace
+    void object(JsonElement* e, int depth)  {
+      JsonElement* last = 0;
+      if ( depth > MAX_DEPTH ) error("Maximal nesting depth exceeded");
+      e->type = JsonElement::JSON_OBJECT;
+      skip_white();
+      if ( *ptr == '}' ) { ++ptr; return; }
+      for(;;)  {
+        skip_white();
+        if ( *ptr != '"' ) error("Expected member name");
+        ++ptr;
+        const char* tag = string_value();
+        skip_white();
+        if ( *ptr != ':' ) error("Expected ':'");
+        ++ptr;
+        char* term = value(add_child(e, last, tag), depth);
+        skip_white();
+        char c = *ptr;
+        if ( term ) *term = 0;
+        if ( c == ',' ) { ++ptr; continue; }
+        if ( c == '}' ) { ++ptr; return;   }
+        error("Expected ',' or '}'");
+      }
+    }
+    /// Parse array items after the opening bracket
+    void array(JsonElement* e, int depth)  {
+      JsonElement* last = 0;
+      if ( depth > MAX_DEPTH ) error("Maximal nesting depth exceeded");
+      e->type = JsonElement::JSON_ARRAY;
+      skip_white();
+      if ( *ptr == ']' ) { ++ptr; return; }
+      for(;;)  {
+        char* term = value(add_child(e, last, ""), depth);
+        skip_white();
+        char c = *ptr;
+        if ( term ) *term = 0;
+        if ( c == ',' ) { ++ptr; continue; }
+        if ( c == ']' ) { ++ptr; return;   }
+        error("Expected ',' or ']'");
+      }
+    }
+  public:
+    /// Initializing constructor
+    JsonParser(JsonDocument* d, const string& n, char* text)
+      : doc(d), name(n), begin(text), ptr(text) {}
+    /// Parse the document: top level object or array
+    void parse()  {
+      skip_white();
+      if ( *ptr == '{' )      { ++ptr; object(doc, 0); }
+      else if ( *ptr == '[' ) { ++ptr; array(doc, 0);  }
+      else error("Expected '{' or '['");
+      skip_white();
+      if ( *ptr != 0 ) error("Garbage after end of document");
+    }
+  };
+}
+
+/// Initializing constructor. Parses the document text.
+JsonDocument::JsonDocument(const string& nam, vector<char>&& data)
+  : JsonElement(), m_buffer(std::move(data)), m_used(NODE_BLOCK_SIZE)
+{
+  size_t len = m_buffer.size();
+  // Terminate the document text and keep the document name as tag of the root node
+  m_buffer.push_back(0);
+  m_buffer.insert(m_buffer.end(), nam.begin(), nam.end());
+  m_buffer.push_back(0);
+  tag  = &m_buffer[len+1];
+  text = "";
+  JsonParser(this, nam, &m_buffer[0]).parse();
+}
+
+/// Default destructor
+JsonDocument::~JsonDocument()   {
+}
+
+/// Allocate a new node
+JsonElement* JsonDocument::allocate()   {
+  if ( m_used == NODE_BLOCK_SIZE )  {
+    m_blocks.emplace_back(new JsonElement[NODE_BLOCK_SIZE]);
+    m_used = 0;
+  }
+  JsonElement* e = &m_blocks.back()[m_used++];
+  ::memset(e, 0, sizeof(JsonElement));
+  e->text = "";
+  return e;
+}
+
 /// Default constructor
 DocumentHandler::DocumentHandler()  {
 }
@@ -30,20 +284,26 @@ DocumentHandler::DocumentHandler()  {
 DocumentHandler::~DocumentHandler()   {
 }
 
-/// Load XML file and parse it.
+/// Load JSON file and parse it.
 Document DocumentHandler::load(const string& fname) const   {
   string fn = fname;
   if ( fname.find("://") != string::npos ) fn = fname.substr(fname.find("://")+3);
-  //string cmd = "cat "+fn;
-  //::printf("\n\n+++++ Dump json file: %s\n\n\n",fn.c_str());
-  //::system(cmd.c_str());
-  unique_ptr<JsonElement> doc(new JsonElement(fn, ptree()));
-  boost::property_tree::read_json(fn,doc->second);
-  return doc.release();
+  unique_ptr<FILE,int(*)(FILE*)> file(::fopen(fn.c_str(),"rb"), ::fclose);
+  if ( !file )  {
+    throw runtime_error("DocumentHandler: Failed to open JSON file "+fn);
+  }
+  vector<char> text;
+  char buff[16384];
+  for(size_t len; (len=::fread(buff,1,sizeof(buff),file.get())) > 0; )
+    text.insert(text.end(), buff, buff+len);
+  if ( ::ferror(file.get()) )  {
+    throw runtime_error("DocumentHandler: Failed to read JSON file "+fn);
+  }
+  return new JsonDocument(fn, std::move(text));
 }
 
-/// Parse a standalong XML string into a document.
+/// Parse a standalong JSON string into a document.
 Document DocumentHandler::parse(const char* doc_string, size_t length) const   {
-  if ( doc_string && length ) {}
-  throw runtime_error("Bla");
+  vector<char> text(doc_string, doc_string+length);
+  return new JsonDocument("<string>", std::move(text));
 }
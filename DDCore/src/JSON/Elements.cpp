@@ -20,6 +20,7 @@
 // C/C++ include files
 #include <iostream>
 #include <stdexcept>
+#include <cstring>
 #include <cstdio>
 #include <map>
 
@@ -42,39 +43,52 @@ namespace {
 
 namespace {
 
-  // This should ensure we are not passing temporaries of std::string and then
-  // returning the "const char*" content calling .c_str()
-  const ptree::data_type& value_data(const ptree& entry)  {
-    return entry.data();
+  /// Compare node tag to tag name
+  inline bool tag_match(const JsonElement* e, const char* tag)  {
+    return e->tag[0] == tag[0] && ::strcmp(e->tag, tag) == 0;
+  }
+
+  /// Access the first matching node starting at the given node in forward direction
+  inline JsonElement* match_forward(JsonElement* e, const string& tag)  {
+    if ( tag == "*" ) return e;
+    for(const char* t=tag.c_str(); e; e=e->next)
+      if ( tag_match(e, t) ) return e;
+    return 0;
+  }
+
+  /// Access the first matching node starting at the given node in backward direction
+  inline JsonElement* match_backward(JsonElement* e, const string& tag)  {
+    if ( tag == "*" ) return e;
+    for(const char* t=tag.c_str(); e; e=e->prev)
+      if ( tag_match(e, t) ) return e;
+    return 0;
   }
 
   JsonElement* node_first(JsonElement* e, const char* tag) {
     if ( e )  {
-      string t(tag);
-      if ( t == "*" )  {
-        ptree::iterator i = e->second.begin();
-        return i != e->second.end() ? &(*i) : 0;
-      }
-      ptree::assoc_iterator i = e->second.find(t);
-      return i != e->second.not_found() ? &(*i) : 0;
+      if ( tag[0] == '*' && tag[1] == 0 ) return e->child;
+      for(JsonElement* c=e->child; c; c=c->next)
+        if ( tag_match(c, tag) ) return c;
     }
     return 0;
   }
 
   size_t node_count(JsonElement* e, const string& t) {
-    return e ? (t=="*" ? e->second.size() : e->second.count(t)) : 0;
+    size_t n = 0;
+    if ( e )  {
+      if ( t == "*" ) return e->numChildren;
+      for(JsonElement* c=e->child; c; c=c->next)
+        if ( tag_match(c, t.c_str()) ) ++n;
+    }
+    return n;
   }
 
   Attribute attribute_node(JsonElement* n, const char* t)  {
-    if ( n )  {
-      auto i = n->second.find(t);
-      return i != n->second.not_found() ? &(*i) : 0;
-    }
-    return 0;
+    return node_first(n, t);
   }
 
   const char* attribute_value(Attribute a) {
-    return value_data(a->second).c_str();
+    return a->text;
   }
 }
 
@@ -291,31 +305,17 @@ NodeList::~NodeList() {
 
 /// Reset the nodelist
 JsonElement* NodeList::reset() {
-  if ( m_tag == "*" )
-    m_ptr = make_pair(m_node->second.ordered_begin(), m_node->second.not_found());
-  else
-    m_ptr = m_node->second.equal_range(m_tag);
-  if ( m_ptr.first != m_ptr.second )
-    return &(*m_ptr.first);
-  return 0;
+  return m_ptr = m_node ? match_forward(m_node->child, m_tag) : 0;
 }
 
 /// Advance to next element
 JsonElement* NodeList::next() const {
-  if ( m_ptr.first != m_ptr.second )  {
-    m_ptr.first = ++m_ptr.first;
-    if ( m_ptr.first != m_ptr.second ) return &(*m_ptr.first);
-  }
-  return 0;
+  return m_ptr = m_ptr ? match_forward(m_ptr->next, m_tag) : 0;
 }
 
 /// Go back to previous element
 JsonElement* NodeList::previous() const {
-  if ( m_ptr.first != m_ptr.second )  {
-    m_ptr.first = --m_ptr.first;
-    if ( m_ptr.first != m_ptr.second ) return &(*m_ptr.first);
-  }
-  return 0;
+  return m_ptr = m_ptr ? match_backward(m_ptr->prev, m_tag) : 0;
 }
 
 /// Assignment operator
@@ -330,17 +330,17 @@ NodeList& NodeList::operator=(const NodeList& l) {
 
 /// Unicode text access to the element's tag. This must be wrong ....
 const char* Handle_t::rawTag() const {
-  return m_node->first.c_str();
+  return m_node->tag;
 }
 
 /// Unicode text access to the element's text
 const char* Handle_t::rawText() const {
-  return value_data(m_node->second).c_str();
+  return m_node->text;
 }
 
 /// Unicode text access to the element's value
 const char* Handle_t::rawValue() const {
-  return value_data(m_node->second).c_str();
+  return m_node->text;
 }
 
 /// Access attribute pointer by the attribute's unicode name (no exception thrown if not present)
@@ -357,10 +357,8 @@ bool Handle_t::hasAttr(const char* tag_value) const {
 vector<Attribute> Handle_t::attributes() const {
   vector < Attribute > attrs;
   if (m_node) {
-    for(ptree::iterator i=m_node->second.begin(); i!=m_node->second.end(); ++i)  {
-      Attribute a = &(*i);
-      attrs.push_back(a);
-    }
+    for(JsonElement* c=m_node->child; c; c=c->next)
+      attrs.push_back(c);
   }
   return attrs;
 }
@@ -416,7 +414,7 @@ Attribute Handle_t::attr_ptr(const char* t) const {
 /// Access attribute name (throws exception if not present)
 const char* Handle_t::attr_name(const Attribute a) const {
   if (a) {
-    return a->first.c_str();
+    return a->tag;
   }
   throw runtime_error("Attempt to access invalid XML attribute object!");
 }
@@ -450,7 +448,7 @@ Handle_t Document::root() const   {
 DocumentHolder& DocumentHolder::assign(DOC d)   {
   if ( m_doc )   {
     printout(DEBUG,"DocumentHolder","+++ Release JSON document....");
-    delete m_doc;
+    delete static_cast<JsonDocument*>(m_doc);
   }
   m_doc = d;
   return *this;
@@ -498,7 +496,7 @@ void Collection_t::throw_loop_exception(const exception& e) const {
 void Collection_t::operator++() const {
   while (m_node) {
     m_node = m_children.next();
-    if (m_node && m_node->second.size() > 0 )
+    if (m_node && m_node->numChildren > 0 )
       return;
   }
 }
@@ -506,7 +504,7 @@ void Collection_t::operator++() const {
 void Collection_t::operator--() const {
   while (m_node) {
     m_node = m_children.previous();
-    if (m_node && m_node->second.size() > 0 )
+    if (m_node && m_node->numChildren > 0 )
       return;
   }
 }
@@ -531,9 +529,9 @@ void DD4hep::JSON::dumpTree(const JsonElement* elt)   {
   struct Dump {
     void operator()(const JsonElement* e, const string& tag)   const  {
       string t = tag+"   ";
-      printout(INFO,"DumpTree","+++ %s %s: %s",tag.c_str(), e->first.c_str(), e->second.data().c_str());
-      for(auto i=e->second.begin(); i!=e->second.end(); ++i)
-        (*this)(&(*i), t);
+      printout(INFO,"DumpTree","+++ %s %s: %s",tag.c_str(), e->tag, e->text);
+      for(const JsonElement* c=e->child; c; c=c->next)
+        (*this)(c, t);
     }
   } _dmp;
   _dmp(elt," ");
@@ -82,6 +82,11 @@ void Segmentation::neighbours(const CellID& cell, std::set<CellID>& nb) const  {
   data<Object>()->segmentation->neighbours(cell, nb);
 }
 
+/// Calculates the neighbours of the given cell ID into a caller buffer. Returns the number of neighbours
+size_t Segmentation::neighbours(const CellID& cell, CellID* buffer, size_t max_neighbours) const  {
+  return data<Object>()->segmentation->neighbours(cell, buffer, max_neighbours);
+}
+
 /** \brief Returns a vector<double> of the cellDimensions of the given cell ID
  *  in natural order of dimensions, e.g., dx/dy/dz, or dr/r*dPhi
  *
@@ -22,6 +22,7 @@
 #include <stdexcept>
 #include <cstdio>
 #include <map>
+#include <unordered_map>
 
 using namespace std;
 using namespace DD4hep::XML;
@@ -181,16 +182,6 @@ namespace {
   }
 }
 
-/// Convert XML char to std::string
-string DD4hep::XML::_toString(const XmlChar *toTranscode) {
-  char *buff = XmlString::transcode(toTranscode);
-  string tmp(buff == 0 ? "" : buff);
-  XmlString::release(&buff);
-  if ( tmp.length()<3 ) return tmp;
-  if ( !(tmp[0] == '$' && tmp[1] == '{') ) return tmp;
-  tmp = _checkEnviron(tmp);
-  return tmp;
-}
 #endif
 
 namespace {
@@ -204,14 +195,131 @@ namespace {
   int node_type(XmlNode* n) {return Xml(n).n->getNodeType();}
   int node_type(Handle_t n) {return Xml(n.ptr()).n->getNodeType();}
 #endif
+
+  /// Cache of converted XML values
+  /**
+   *  Compact descriptions and detector constructors read the same attribute
+   *  values many times. Values are identified by their raw text, hence
+   *  equal values of different attributes or temporary buffers share one
+   *  entry and entries never refer to released documents.
+   *  The transcoded (UTF-8) text and the evaluated number are reused as
+   *  long as the dictionary of the expression evaluator did not change.
+   *  Values of the form ${...} may be resolved from the process environment,
+   *  whose changes (::setenv) are not seen by the evaluator: they are
+   *  converted and evaluated on every access.
+   */
+  class ValueCache  {
+  public:
+    enum { CAST_INT = 1, CAST_LONG = 2 };
+    /// Cached conversions of one raw value
+    struct Entry  {
+      string        text;
+      double        number     = 0e0;
+      unsigned long generation = 0;
+      bool          evaluated  = false;
+      /// No casts and leading blanks: all numeric conversions evaluate the same expression
+      bool          plain      = false;
+      /// Environment reference: never reused
+      bool          environ    = false;
+    };
+  private:
+    /// Entries are keyed by the bytes of the raw value
+    typedef unordered_map<string,Entry> Entries;
+    static const size_t MAX_ENTRIES = 65536;
+    Entries m_entries;
+    /// Key buffer re-used for lookups
+    string  m_key;
+
+    /// Convert raw value to string and resolve environment references
+    static string convert(const XmlChar* value, bool& environ)   {
+#ifdef DD4HEP_USE_TINYXML
+      string tmp(value);
+#else
+      char* buff = XmlString::transcode(value);
+      string tmp(buff == 0 ? "" : buff);
+      XmlString::release(&buff);
+#endif
+      environ = tmp.length() >= 3 && tmp[0] == '$' && tmp[1] == '{';
+      return environ ? _checkEnviron(tmp) : tmp;
+    }
+  public:
+    /// Access the up-to-date cache entry of a raw value
+    Entry& get(const XmlChar* value)  {
+      unsigned long gen = eval.generation();
+      m_key.assign((const char*)value, XmlString::length(value)*sizeof(XmlChar));
+      Entries::iterator i = m_entries.find(m_key);
+      if ( i == m_entries.end() )  {
+        // Bound the memory: distinct values beyond the limit start a new cache
+        if ( m_entries.size() >= MAX_ENTRIES ) m_entries.clear();
+        i = m_entries.insert(make_pair(m_key,Entry())).first;
+        i->second.generation = gen+1;  // Force the conversion
+      }
+      Entry& e = i->second;
+      if ( e.generation != gen || e.environ )  {
+        e.text = convert(value, e.environ);
+        e.plain = !e.environ && e.text[0] != ' ' &&
+          e.text.find("(int)")  == string::npos &&
+          e.text.find("(long)") == string::npos;
+        e.generation = gen;
+        e.evaluated  = false;
+      }
+      return e;
+    }
+    /// Evaluate raw value as number. Casts are removed as requested.
+    double number(const XmlChar* value, int casts)  {
+      Entry& e = get(value);
+      if ( e.evaluated ) return e.number;
+      string s = e.text;
+      if ( casts&CAST_INT )  {
+        size_t idx = s.find("(int)");
+        if (idx != string::npos)
+          s.erase(idx, 5);
+      }
+      if ( casts&CAST_LONG )  {
+        size_t idx = s.find("(long)");
+        if (idx != string::npos)
+          s.erase(idx, 6);
+      }
+      if ( casts )  {
+        while (s[0] == ' ')
+          s.erase(0, 1);
+      }
+      double result = eval.evaluate(s.c_str());
+      if (eval.status() != XmlTools::Evaluator::OK) {
+        cerr << s << ": ";
+        eval.print_error();
+        throw runtime_error("DD4hep: Severe error during expression evaluation of " + s);
+      }
+      if ( e.plain )  {
+        e.number = result;
+        e.evaluated = true;
+      }
+      return result;
+    }
+  };
+
+  /// Access to the value cache. Each thread uses its own cache.
+  ValueCache& value_cache()  {
+    static thread_local ValueCache cache;
+    return cache;
+  }
 }
 
 string DD4hep::XML::_toString(Attribute attr) {
   if (attr)
-    return _toString(attribute_value(attr));
+    return value_cache().get(attribute_value(attr)).text;
   return "";
 }
 
+#ifndef DD4HEP_USE_TINYXML
+/// Convert XML char to std::string
+string DD4hep::XML::_toString(const XmlChar *toTranscode) {
+  if ( toTranscode )
+    return value_cache().get(toTranscode).text;
+  return "";
+}
+#endif
+
 template <typename T> static inline string __to_string(T value, const char* fmt) {
   char text[128];
   ::snprintf(text, sizeof(text), fmt, value);
@@ -278,78 +386,35 @@ string DD4hep::XML::_ptrToString(const void* v, const char* fmt) {
 
 long DD4hep::XML::_toLong(const XmlChar* value) {
   if (value) {
-    string s = _toString(value);
-    size_t idx = s.find("(int)");
-    if (idx != string::npos)
-      s.erase(idx, 5);
-    idx = s.find("(long)");
-    if (idx != string::npos)
-      s.erase(idx, 6);
-    while (s[0] == ' ')
-      s.erase(0, 1);
-    double result = eval.evaluate(s.c_str());
-    if (eval.status() != XmlTools::Evaluator::OK) {
-      cerr << s << ": ";
-      eval.print_error();
-      throw runtime_error("DD4hep: Severe error during expression evaluation of " + s);
-    }
-    return (long) result;
+    return (long) value_cache().number(value, ValueCache::CAST_INT|ValueCache::CAST_LONG);
   }
   return -1;
 }
 
 int DD4hep::XML::_toInt(const XmlChar* value) {
   if (value) {
-    string s = _toString(value);
-    size_t idx = s.find("(int)");
-    if (idx != string::npos)
-      s.erase(idx, 5);
-    while (s[0] == ' ')
-      s.erase(0, 1);
-    double result = eval.evaluate(s.c_str());
-    if (eval.status() != XmlTools::Evaluator::OK) {
-      cerr << s << ": ";
-      eval.print_error();
-      throw runtime_error("DD4hep: Severe error during expression evaluation of " + s);
-    }
-    return (int) result;
+    return (int) value_cache().number(value, ValueCache::CAST_INT);
   }
   return -1;
 }
 
 bool DD4hep::XML::_toBool(const XmlChar* value) {
   if (value) {
-    string s = _toString(value);
-    return s == "true";
+    return value_cache().get(value).text == "true";
   }
   return false;
 }
 
 float DD4hep::XML::_toFloat(const XmlChar* value) {
   if (value) {
-    string s = _toString(value);
-    double result = eval.evaluate(s.c_str());
-
-    if (eval.status() != XmlTools::Evaluator::OK) {
-      cerr << s << ": ";
-      eval.print_error();
-      throw runtime_error("DD4hep: Severe error during expression evaluation of " + s);
-    }
-    return (float) result;
+    return (float) value_cache().number(value, 0);
   }
   return 0.0;
 }
 
 double DD4hep::XML::_toDouble(const XmlChar* value) {
   if (value) {
-    string s = _toString(value);
-    double result = eval.evaluate(s.c_str());
-    if (eval.status() != XmlTools::Evaluator::OK) {
-      cerr << s << ": ";
-      eval.print_error();
-      throw runtime_error("DD4hep: Severe error during expression evaluation of " + s);
-    }
-    return result;
+    return value_cache().number(value, 0);
   }
   return 0.0;
 }
@@ -657,6 +657,13 @@ template <> void Converter<Region>::operator()(xml_h elt) const {
  *   <segmentation type="RegularNgonCartesianGridXY" gridSizeX="3.0*cm" gridSizeY="3.0*cm" />
  *   <id>system:6,barrel:3,module:4,layer:8,slice:5,x:32:-16,y:-16</id>
  * </readout>
+ *
+ * Optionally the index ranges for the neighbour search and a precomputed neighbour table:
+ *
+ *   <segmentation type="CartesianGridXY" gridSizeX="1*cm" gridSizeY="1*cm" neighbour_table="true">
+ *     <index_range field="x" key_min="-50" key_max="49"/>
+ *     <index_range field="y" key_min="-50" key_max="49"/>
+ *   </segmentation>
  */
 template <> void Converter<Segmentation>::operator()(xml_h seg) const {
   string type = seg.attr<string>(_U(type));
@@ -735,6 +742,25 @@ template <> void Converter<Segmentation>::operator()(xml_h seg) const {
         delete sub_seg.ptr();
       }
     }
+    // Index ranges known from the geometry restrict the neighbour search:
+    // <index_range field="x" key_min="-50" key_max="49"/>
+    for(xml_coll_t rng(seg,_Unicode(index_range)); rng; ++rng)   {
+      xml_dim_t r(rng);
+      base->setIndexRange(r.attr<string>(_U(field)), r.key_min(), r.key_max());
+    }
+    // Fixed cell layouts may precompute the neighbours of all cells
+    if ( seg.hasAttr(_Unicode(neighbour_table)) && seg.attr<bool>(_Unicode(neighbour_table)) )  {
+      try  {
+        base->buildNeighbourTable();
+      }
+      catch(const exception& e)  {
+        throw_print("FAILED to build neighbour table of segmentation: " + type + ". " + e.what());
+      }
+      printout(s_debug_segmentation ? ALWAYS : DEBUG, "Compact",
+               "++ Segmentation [%s/%s]: Neighbour table with %ld cells and %ld entries.",
+               name.c_str(), type.c_str(), long(base->neighbourTable()->size()),
+               long(base->neighbourTable()->numEntries()));
+    }
   }
   opt->first = segment;
 }
@@ -39,7 +39,6 @@
 
 // C/C++ include files
 #include <iostream>
-#include "boost/property_tree/json_parser.hpp"
 
 namespace {
   class Json;
@@ -50,10 +50,16 @@
 #include "TGeoNode.h"
 #include "TClass.h"
 #include "TMath.h"
+#include <cerrno>
+#include <cstdarg>
+#include <cstring>
+#include <exception>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <memory>
+#include <thread>
 
 using namespace DD4hep::Geometry;
 using namespace DD4hep;
@@ -110,6 +116,23 @@ namespace {
     nn += text;
     return nn;
   }
+
+  /// Value key of a position or rotation. Negative zero is mapped to zero.
+  LCDDConverter::TrafoKey trafoKey(double x, double y, double z)  {
+    LCDDConverter::TrafoKey k = {{ x == 0e0 ? 0e0 : x, y == 0e0 ? 0e0 : y, z == 0e0 ? 0e0 : z }};
+    return k;
+  }
+}
+
+/// Hash function of position and rotation keys
+size_t LCDDConverter::TrafoHash::operator()(const TrafoKey& k) const  {
+  unsigned long long h = 14695981039346656037ULL;
+  const unsigned char* p = (const unsigned char*)k.v;
+  for(size_t i=0; i<sizeof(k.v); ++i)  {
+    h ^= p[i];
+    h *= 1099511628211ULL;
+  }
+  return size_t(h);
 }
 
 void LCDDConverter::GeometryInfo::check(const string& name, const TNamed* n, map<string, const TNamed*>& m) const {
@@ -592,14 +615,22 @@ xml_h LCDDConverter::handlePosition(const std::string& name, const TGeoMatrix* t
   if (!pos) {
     const double* tr = trafo->GetTranslation();
     if (tr[0] != 0.0 || tr[1] != 0.0 || tr[2] != 0.0) {
-      string gen_name = genName(name,trafo);
-      geo.checkPosition(gen_name, trafo);
-      geo.doc_define.append(pos = xml_elt_t(geo.doc, _U(position)));
-      pos.setAttr(_U(name), gen_name);
-      pos.setAttr(_U(x), tr[0]);
-      pos.setAttr(_U(y), tr[1]);
-      pos.setAttr(_U(z), tr[2]);
-      pos.setAttr(_U(unit), "cm");
+      TrafoKey key = trafoKey(tr[0], tr[1], tr[2]);
+      TrafoValueMap::const_iterator i = geo.xmlPositionValues.find(key);
+      if (i != geo.xmlPositionValues.end()) {
+        pos = (*i).second;
+      }
+      else {
+        string gen_name = genName(name,trafo);
+        geo.checkPosition(gen_name, trafo);
+        geo.doc_define.append(pos = xml_elt_t(geo.doc, _U(position)));
+        pos.setAttr(_U(name), gen_name);
+        pos.setAttr(_U(x), tr[0]);
+        pos.setAttr(_U(y), tr[1]);
+        pos.setAttr(_U(z), tr[2]);
+        pos.setAttr(_U(unit), "cm");
+        geo.xmlPositionValues[key] = pos;
+      }
     }
     else if (geo.identity_pos) {
       pos = geo.identity_pos;
@@ -626,14 +657,22 @@ xml_h LCDDConverter::handleRotation(const std::string& name, const TGeoMatrix* t
   if (!rot) {
     XYZRotation r = getXYZangles(trafo->GetRotationMatrix());
     if (!(r.X() == 0.0 && r.Y() == 0.0 && r.Z() == 0.0)) {
-      string gen_name = genName(name,trafo);
-      geo.checkRotation(gen_name, trafo);
-      geo.doc_define.append(rot = xml_elt_t(geo.doc, _U(rotation)));
-      rot.setAttr(_U(name), gen_name);
-      rot.setAttr(_U(x), r.X());
-      rot.setAttr(_U(y), r.Y());
-      rot.setAttr(_U(z), r.Z());
-      rot.setAttr(_U(unit), "rad");
+      TrafoKey key = trafoKey(r.X(), r.Y(), r.Z());
+      TrafoValueMap::const_iterator i = geo.xmlRotationValues.find(key);
+      if (i != geo.xmlRotationValues.end()) {
+        rot = (*i).second;
+      }
+      else {
+        string gen_name = genName(name,trafo);
+        geo.checkRotation(gen_name, trafo);
+        geo.doc_define.append(rot = xml_elt_t(geo.doc, _U(rotation)));
+        rot.setAttr(_U(name), gen_name);
+        rot.setAttr(_U(x), r.X());
+        rot.setAttr(_U(y), r.Y());
+        rot.setAttr(_U(z), r.Z());
+        rot.setAttr(_U(unit), "rad");
+        geo.xmlRotationValues[key] = rot;
+      }
     }
     else if (geo.identity_rot) {
       rot = geo.identity_rot;
@@ -1261,6 +1300,354 @@ xml_doc_t LCDDConverter::createLCDD(DetElement top) {
   return geo.doc;
 }
 
+namespace {
+
+  /// Escape the XML special characters of a string
+  string xml_escape(const string& s)  {
+    if ( s.find_first_of("<>&\"'") == string::npos ) return s;
+    string r;
+    r.reserve(s.length()+16);
+    for(char c : s)  {
+      switch(c)  {
+      case '<':  r += "&lt;";   break;
+      case '>':  r += "&gt;";   break;
+      case '&':  r += "&amp;";  break;
+      case '"':  r += "&quot;"; break;
+      case '\'': r += "&apos;"; break;
+      default:   r += c;        break;
+      }
+    }
+    return r;
+  }
+
+  /// Append formatted text to a string buffer
+  void append(string& out, const char* fmt, ...)  {
+    char text[512];
+    va_list args;
+    va_start(args, fmt);
+    int len = ::vsnprintf(text, sizeof(text), fmt, args);
+    va_end(args);
+    if ( len < 0 ) return;
+    if ( size_t(len) < sizeof(text) )  {
+      out.append(text, len);
+      return;
+    }
+    vector<char> buff(len+1);
+    va_start(args, fmt);
+    ::vsnprintf(&buff[0], buff.size(), fmt, args);
+    va_end(args);
+    out.append(&buff[0], len);
+  }
+
+  /// Serialize the children of a DOM element including all attributes
+  void serialize_children(xml_h parent, string& out, int indent)  {
+    for(xml_coll_t c(parent, _U(star)); c; ++c)  {
+      xml_h  e = c;
+      string tag = e.tag();
+      out.append(indent, ' ');
+      out += '<';
+      out += tag;
+      vector<XML::Attribute> attrs = e.attributes();
+      for(XML::Attribute a : attrs)  {
+        out += ' ';
+        out += XML::_toString(e.attr_name(a));
+        out += "=\"";
+        out += xml_escape(e.attr<string>(a));
+        out += '"';
+      }
+      if ( xml_coll_t(e, _U(star)) )  {
+        out += ">\n";
+        serialize_children(e, out, indent+2);
+        out.append(indent, ' ');
+        out += "</" + tag + ">\n";
+      }
+      else  {
+        out += "/>\n";
+      }
+    }
+  }
+
+  /// Data of the streaming GDML writer shared by the formatting threads
+  /**
+   *  \author  M.Frank
+   *  \version 1.0
+   *  \ingroup DD4HEP_GEOMETRY
+   */
+  class GDMLStream  {
+  public:
+    typedef LCDDConverter::TrafoKey TrafoKey;
+    typedef unordered_map<TrafoKey, int, LCDDConverter::TrafoHash> TrafoIndex;
+    /// Daughter placement of a volume
+    struct Placement  {
+      const TGeoVolume* volume;
+      int               position, rotation;
+    };
+    /// Volume definition
+    struct Vol  {
+      const TGeoVolume* volume;
+      string            name, material, solid;
+      size_t            first, last;
+    };
+    /// Position or rotation. Already defined ones are present in the DOM define section.
+    struct Trafo  {
+      string   name;
+      TrafoKey value;
+      bool     defined;
+    };
+    vector<Vol>       volumes;
+    vector<Placement> placements;
+    vector<Trafo>     positions, rotations;
+    TrafoIndex        position_index, rotation_index;
+
+    /// Register a position or rotation by value. Returns the table index
+    static int add(vector<Trafo>& table, TrafoIndex& index, const TrafoKey& key,
+                   const LCDDConverter::TrafoValueMap& dom, xml_h dom_identity,
+                   const char* identity, const string& nam, const void* ptr)
+    {
+      TrafoIndex::const_iterator i = index.find(key);
+      if ( i != index.end() ) return (*i).second;
+      Trafo t;
+      t.value = key;
+      t.defined = false;
+      if ( key.v[0] == 0e0 && key.v[1] == 0e0 && key.v[2] == 0e0 )  {
+        t.name = identity;
+        t.defined = 0 != dom_identity.ptr();
+      }
+      else  {
+        LCDDConverter::TrafoValueMap::const_iterator j = dom.find(key);
+        t.defined = j != dom.end();
+        t.name = t.defined ? XML::_toString(xml_ref_t(xml_h((*j).second)).name()) : xml_escape(genName(nam, ptr));
+      }
+      index[key] = table.size();
+      table.push_back(t);
+      return table.size()-1;
+    }
+    /// Format the deduplicated positions and rotations not present in the DOM
+    void formatDefines(string& out)  const  {
+      for(const Trafo& t : positions)  {
+        if ( t.defined ) continue;
+        append(out, "    <position name=\"%s\" x=\"%.8e\" y=\"%.8e\" z=\"%.8e\" unit=\"cm\"/>\n",
+               t.name.c_str(), t.value.v[0], t.value.v[1], t.value.v[2]);
+      }
+      for(const Trafo& t : rotations)  {
+        if ( t.defined ) continue;
+        append(out, "    <rotation name=\"%s\" x=\"%.8e\" y=\"%.8e\" z=\"%.8e\" unit=\"rad\"/>\n",
+               t.name.c_str(), t.value.v[0], t.value.v[1], t.value.v[2]);
+      }
+    }
+    /// Format the volumes [first, last) of the structure section
+    void formatVolumes(size_t first, size_t last, string& out)  const  {
+      for(size_t i=first; i<last; ++i)  {
+        const Vol& v = volumes[i];
+        const char* tag = v.volume->IsAssembly() ? "assembly" : "volume";
+        append(out, "    <%s name=\"%s\">\n", tag, v.name.c_str());
+        if ( !v.volume->IsAssembly() )  {
+          append(out, "      <materialref ref=\"%s\"/>\n", v.material.c_str());
+          append(out, "      <solidref ref=\"%s\"/>\n", v.solid.c_str());
+        }
+        for(size_t j=v.first; j<v.last; ++j)  {
+          const Placement& p = placements[j];
+          out += "      <physvol>\n";
+          append(out, "        <volumeref ref=\"%s\"/>\n",
+                 xml_escape(genName(p.volume->GetName(),p.volume)).c_str());
+          if ( p.position >= 0 )
+            append(out, "        <positionref ref=\"%s\"/>\n", positions[p.position].name.c_str());
+          if ( p.rotation >= 0 )
+            append(out, "        <rotationref ref=\"%s\"/>\n", rotations[p.rotation].name.c_str());
+          out += "      </physvol>\n";
+        }
+        append(out, "    </%s>\n", tag);
+      }
+    }
+  };
+
+  /// Group of threads, which are joined when leaving the scope, also if an exception is thrown
+  class ThreadGroup : public vector<thread>  {
+  public:
+    /// Default destructor: a joinable thread must not be destroyed
+    ~ThreadGroup()  {  join();  }
+    /// Wait for all running threads
+    void join()  {
+      for (thread& t : *this)
+        if (t.joinable()) t.join();
+    }
+  };
+}
+
+/// Write geometry in GDML format directly to file without building the structure DOM
+long LCDDConverter::writeGDML(DetElement top, const string& file_name, int num_threads) {
+  typedef pair<size_t,size_t> Chunk;
+  const size_t CHUNK_SIZE = 8192;   // Approximate number of volumes and placements per chunk
+  LCDD& lcdd = m_lcdd;
+  if (!top.isValid()) {
+    throw runtime_error("Attempt to call writeGDML with an invalid geometry!");
+  }
+  if (num_threads < 1) {
+    num_threads = std::max(1u, thread::hardware_concurrency());
+  }
+  // The buffer must outlive the file: declare it first
+  vector<char> out_buffer(1<<22);
+  unique_ptr<FILE,int(*)(FILE*)> out(::fopen(file_name.c_str(), "w"), ::fclose);
+  if (!out) {
+    except("LCDDConverter","++ Failed to open GDML output file %s: %s",
+           file_name.c_str(), ::strerror(errno));
+  }
+  ::setvbuf(out.get(), &out_buffer[0], _IOFBF, out_buffer.size());
+
+  GeometryInfo& geo = *(m_dataPtr = new GeometryInfo);
+  m_data->clear();
+  collect(top, geo);
+  printout(ALWAYS,"LCDDConverter","++ ==> Streaming in memory detector description to GDML file %s...",
+           file_name.c_str());
+
+  // Materials and solids are converted using the DOM. They are few compared to the placements.
+  XML::DocumentHandler docH;
+  geo.doc = docH.create("gdml", docH.defaultComment());
+  geo.doc_root = geo.doc.root();
+  geo.doc_root.append(geo.doc_define = xml_elt_t(geo.doc, _U(define)));
+  geo.doc_root.append(geo.doc_materials = xml_elt_t(geo.doc, _U(materials)));
+  geo.doc_root.append(geo.doc_solids = xml_elt_t(geo.doc, _U(solids)));
+  handle(this, geo.materials, &LCDDConverter::handleMaterial);
+  printout(ALWAYS,"LCDDConverter","++ Handled %ld materials.",geo.materials.size());
+  handle(this, geo.solids, &LCDDConverter::handleSolid);
+  printout(ALWAYS,"LCDDConverter","++ Handled %ld solids.",geo.solids.size());
+
+  // Collect the structure and deduplicate the placement transformations by value
+  GDMLStream s;
+  s.volumes.reserve(geo.volumes.size());
+  for (Volume volume : geo.volumes) {
+    const TGeoVolume* v = volume;
+    GDMLStream::Vol e;
+    e.volume = v;
+    e.name   = xml_escape(genName(v->GetName(),v));
+    if (!v->IsAssembly()) {
+      TGeoMedium* m  = v->GetMedium();
+      TGeoShape*  sh = v->GetShape();
+      xml_ref_t sol = handleSolid(sh->GetName(), sh);
+      if (!sol)
+        throw runtime_error("G4Converter: No LCDD Solid present for volume:" + e.name);
+      else if (!m)
+        throw runtime_error("G4Converter: No LCDD material present for volume:" + e.name);
+      xml_ref_t med = handleMaterial(m->GetName(), Material(m));
+      e.material = xml_escape(XML::_toString(med.name()));
+      e.solid    = xml_escape(XML::_toString(sol.name()));
+    }
+    e.first = s.placements.size();
+    const TObjArray* dau = const_cast<TGeoVolume*>(v)->GetNodes();
+    for (Int_t i = 0, n_dau = dau ? dau->GetEntries() : 0; i < n_dau; ++i) {
+      TGeoNode*   node = reinterpret_cast<TGeoNode*>(dau->At(i));
+      TGeoMatrix* mat  = node->GetMatrix();
+      GDMLStream::Placement p = { node->GetVolume(), -1, -1 };
+      if (mat) {
+        string nam = node->GetName();
+        const double* tr = mat->GetTranslation();
+        p.position = s.add(s.positions, s.position_index, trafoKey(tr[0], tr[1], tr[2]),
+                           geo.xmlPositionValues, geo.identity_pos, "identity_pos", nam+"_pos", mat);
+        if (mat->IsRotation()) {
+          XYZRotation r = getXYZangles(mat->GetRotationMatrix());
+          p.rotation = s.add(s.rotations, s.rotation_index, trafoKey(r.X(), r.Y(), r.Z()),
+                             geo.xmlRotationValues, geo.identity_rot, "identity_rot", nam+"_rot", mat);
+        }
+      }
+      s.placements.push_back(p);
+    }
+    e.last = s.placements.size();
+    s.volumes.push_back(e);
+  }
+  printout(ALWAYS,"LCDDConverter","++ Collected %ld volumes with %ld placements: "
+           "%ld unique positions, %ld unique rotations.", s.volumes.size(), s.placements.size(),
+           s.positions.size(), s.rotations.size());
+
+  // Split the structure into chunks formatted in parallel
+  vector<Chunk> chunks;
+  for (size_t i = 0, first = 0, cnt = 0; i < s.volumes.size(); ++i) {
+    cnt += 1 + s.volumes[i].last - s.volumes[i].first;
+    if (cnt >= CHUNK_SIZE || i+1 == s.volumes.size()) {
+      chunks.push_back(Chunk(first, i+1));
+      first = i+1;
+      cnt = 0;
+    }
+  }
+
+  // Independent sections are formatted in parallel to the first chunks of the structure
+  string dom_define, dom_materials, dom_solids, defines;
+  exception_ptr dom_error, define_error;
+  ThreadGroup sections;
+  sections.emplace_back([&]()  {
+      try  {
+        serialize_children(geo.doc_define, dom_define, 4);
+        serialize_children(geo.doc_materials, dom_materials, 4);
+        serialize_children(geo.doc_solids, dom_solids, 4);
+      }
+      catch(...)  {
+        dom_error = current_exception();
+      }
+    });
+  sections.emplace_back([&]()  {
+      try  {
+        s.formatDefines(defines);
+      }
+      catch(...)  {
+        define_error = current_exception();
+      }
+    });
+
+  bool ok = true, head = false;
+  auto put = [&](const string& text)  {
+    ok = ok && ::fwrite(text.c_str(), 1, text.length(), out.get()) == text.length();
+  };
+  vector<string> texts(num_threads);
+  for (size_t c = 0; c < chunks.size() || !head; ) {
+    size_t n = std::min(size_t(num_threads), chunks.size() - c);
+    vector<exception_ptr> errors(n);
+    ThreadGroup workers;
+    for (size_t k = 0; k < n; ++k) {
+      workers.emplace_back([&,k]()  {
+          try  {
+            texts[k].clear();
+            s.formatVolumes(chunks[c+k].first, chunks[c+k].second, texts[k]);
+          }
+          catch(...)  {
+            errors[k] = current_exception();
+          }
+        });
+    }
+    workers.join();
+    if (!head) {
+      sections.join();
+      if (dom_error) rethrow_exception(dom_error);
+      if (define_error) rethrow_exception(define_error);
+      put("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+          "<gdml xmlns:xs=\"http://www.w3.org/2001/XMLSchema-instance\" "
+          "xs:noNamespaceSchemaLocation=\"http://service-spi.web.cern.ch/service-spi/app/releases/GDML/schema/gdml.xsd\">\n");
+      put("  <define>\n");
+      put(dom_define);
+      put(defines);
+      put("  </define>\n  <materials>\n");
+      put(dom_materials);
+      put("  </materials>\n  <solids>\n");
+      put(dom_solids);
+      put("  </solids>\n  <structure>\n");
+      head = true;
+    }
+    for (size_t k = 0; k < n; ++k) {
+      if (errors[k]) rethrow_exception(errors[k]);
+      put(texts[k]);
+    }
+    c += n;
+  }
+  Volume world_vol = lcdd.worldVolume();
+  put("  </structure>\n  <setup name=\"default\" version=\"1.0\">\n");
+  put("    <world ref=\"" + xml_escape(genName(world_vol.name(),world_vol.ptr())) + "\"/>\n");
+  put("  </setup>\n</gdml>\n");
+  ok = (::fclose(out.release()) == 0) && ok;
+  if (!ok) {
+    except("LCDDConverter","++ Failed to write GDML output file %s", file_name.c_str());
+  }
+  printout(ALWAYS,"LCDDConverter","++ Handled %ld volumes.",s.volumes.size());
+  return 1;
+}
+
 /// Helper constructor
 LCDDConverter::GeometryInfo::GeometryInfo()
   : doc(0), doc_root(0), doc_header(0), doc_idDict(0), doc_detectors(0), doc_limits(0), 
@@ -1284,6 +1671,15 @@ static long create_lcdd(LCDD& lcdd, int argc, char** argv) {
   return dump_output(wr.createLCDD(lcdd.world()), argc, argv);
 }
 
+/// Write GDML directly to file. Arguments: output file name [number of threads]
+static long create_gdml_stream(LCDD& lcdd, int argc, char** argv) {
+  if (argc < 1) {
+    except("DD4hepGeometry2GDMLStream","++ Insufficient arguments: arg[0] = output file name!");
+  }
+  LCDDConverter wr(lcdd);
+  return wr.writeGDML(lcdd.world(), argv[0], argc > 1 ? ::atoi(argv[1]) : 0);
+}
+
 static long create_vis(LCDD& lcdd, int argc, char** argv) {
   LCDDConverter wr(lcdd);
   return dump_output(wr.createVis(lcdd.world()), argc, argv);
@@ -1319,4 +1715,5 @@ static long create_visASCII(LCDD& lcdd, int /* argc */, char** argv) {
 DECLARE_APPLY(DD4hepGeometry2VIS, create_vis)
 DECLARE_APPLY(DD4hepGeometry2VISASCII, create_visASCII)
 DECLARE_APPLY(DD4hepGeometry2GDML, create_gdml)
+DECLARE_APPLY(DD4hepGeometry2GDMLStream, create_gdml_stream)
 DECLARE_APPLY(DD4hepGeometry2LCDD, create_lcdd)
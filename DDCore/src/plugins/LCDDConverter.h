@@ -23,6 +23,7 @@
 #include <set>
 #include <map>
 #include <vector>
+#include <unordered_map>
 
 // Forward declarations
 class TGeoVolume;
@@ -62,6 +63,19 @@ namespace DD4hep {
       typedef std::map<const TGeoShape*,  XmlElement*> SolidMap;
       typedef std::map<OverlayedField,    XmlElement*> FieldMap;
       typedef std::map<const TGeoMatrix*, XmlElement*> TrafoMap;
+
+      /// Key to identify positions and rotations by value
+      struct TrafoKey  {
+        double v[3];
+        bool operator==(const TrafoKey& k) const  {
+          return v[0] == k.v[0] && v[1] == k.v[1] && v[2] == k.v[2];
+        }
+      };
+      /// Hash function of position and rotation keys
+      struct TrafoHash  {
+        size_t operator()(const TrafoKey& k) const;
+      };
+      typedef std::unordered_map<TrafoKey, XmlElement*, TrafoHash> TrafoValueMap;
       /// Data structure of the geometry converter from DD4hep to Geant 4 in LCDD format.
       /**
        *  \author  M.Frank
@@ -82,6 +96,8 @@ namespace DD4hep {
         SensDetMap xmlSensDets;
         TrafoMap xmlPositions;
         TrafoMap xmlRotations;
+        TrafoValueMap xmlPositionValues;
+        TrafoValueMap xmlRotationValues;
         FieldMap xmlFields;
         SensitiveDetectorSet sensitives;
         RegionSet regions;
@@ -144,6 +160,14 @@ namespace DD4hep {
       /// Create geometry conversion in Vis format
       xml_doc_t createVis(DetElement top);
 
+      /// Write geometry in GDML format directly to file without building the structure DOM
+      /** Materials and solids are converted using the DOM and serialized in a separate thread.
+       *  Positions and rotations of the placements are deduplicated by value.
+       *  The volume structure is formatted in chunks by num_threads threads and
+       *  written in order to the buffered output file.
+       */
+      long writeGDML(DetElement top, const std::string& file_name, int num_threads);
+
       /// Add header information in LCDD format
       virtual void handleHeader() const;
 
@@ -0,0 +1,575 @@
+//==========================================================================
+//  AIDA Detector description implementation for LCD
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Frank
+//
+//==========================================================================
+
+// Framework include files
+#include "DD4hep/LCDD.h"
+#include "DD4hep/Printout.h"
+#include "DD4hep/Factories.h"
+
+// ROOT include files
+#include "TGeoManager.h"
+#include "TGeoNavigator.h"
+#include "TGeoVolume.h"
+#include "TGeoMatrix.h"
+#include "TGeoBBox.h"
+#include "TGeoNode.h"
+
+// C/C++ include files
+#include <set>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+
+using namespace std;
+using namespace DD4hep;
+using namespace DD4hep::Geometry;
+
+namespace  {
+
+  /// Overlap or extrusion found between the daughters of a volume
+  struct OverlapRecord  {
+    string type;                  // "overlap" or "extrusion"
+    string first, second;         // Daughter node names (second is the mother for extrusions)
+    double depth;                 // Estimated penetration depth [cm]
+    double point[3];              // Point of the deepest penetration in the mother frame [cm]
+  };
+  typedef vector<OverlapRecord> OverlapRecords;
+
+  /// Daughter of a mother volume. Assemblies are replaced by their own daughters
+  struct Daughter  {
+    const TGeoNode*    node;      // Placement of the daughter
+    TGeoHMatrix        matrix;    // Transformation to the frame of the mother
+    int                top;       // Index of the direct daughter of the mother
+    string             name;      // Node path relative to the mother
+  };
+  typedef vector<Daughter> Daughters;
+
+  /// Unit of work: one mother volume with its daughters
+  struct VolumeTask  {
+    TGeoVolume*        volume;
+    size_t             subdetector;
+    unsigned long long hash;
+    double             cost;
+    bool               cached;
+    double             seconds;
+    Daughters          daughters;
+    OverlapRecords     overlaps;
+  };
+
+  /// Per subdetector summary
+  struct SubdetectorInfo  {
+    string name;
+    size_t volumes = 0, checked = 0, cached = 0, overlaps = 0;
+    double seconds = 0e0;
+  };
+
+  /// Parallel overlap checker working on the volume hierarchy of subdetectors
+  /**
+   *  The geometry is partitioned according to the top level detector elements.
+   *  Every logical volume with daughters is checked once:
+   *  - Random points are sampled inside each daughter shape.
+   *  - A point outside the mother shape is an extrusion.
+   *  - A point also inside a sibling (with intersecting bounding box) is an overlap.
+   *  Assemblies have no shape: the daughters of an assembly are checked against
+   *  the siblings of the assembly and for extrusions from the first mother, which
+   *  is no assembly. Daughters of the same assembly are checked with the assembly.
+   *  The penetration depth is estimated from the shape safety distances;
+   *  only penetrations exceeding the tolerance are reported.
+   *
+   *  The checks only use the const shape interfaces. The geometry manager is
+   *  switched to multi-threaded mode and each worker owns a navigator, so that
+   *  shapes with thread local state (e.g. boolean shapes) are safe to use.
+   *
+   *  Each volume is identified by a hash of its shape, the shapes and
+   *  placements of its daughters and the check parameters. Results are
+   *  stored in a cache file and volumes with unchanged hash are not checked
+   *  again on later runs.
+   *
+   *  \author  M.Frank
+   *  \version 1.0
+   *  \ingroup DD4HEP_GEOMETRY
+   */
+  class OverlapChecker  {
+  public:
+    typedef map<unsigned long long, OverlapRecords> Cache;
+    LCDD&                   lcdd;
+    TGeoManager*            mgr;
+    double                  tolerance   = 0.1;     // ROOT default [cm]
+    int                     points      = 1000;    // Sample points per daughter
+    int                     threads     = 0;
+    string                  cache_file, output;
+    set<string>             selection;
+    vector<SubdetectorInfo> subdetectors;
+    vector<VolumeTask>      tasks;
+    map<const TGeoShape*, unsigned long long> shape_hashes;
+    Cache                   cache;
+    atomic<size_t>          next_task;
+    mutex                   lock;
+    string                  error;
+
+    /// Initializing constructor
+    OverlapChecker(LCDD& l) : lcdd(l), mgr(&l.manager()), next_task(0)  {}
+    /// Hash the shape parameters using the mesh points of the shape
+    unsigned long long shapeHash(const TGeoShape* shape);
+    /// Hash of one mother volume: shapes and placements of the daughters
+    unsigned long long volumeHash(TGeoVolume* vol, const Daughters& daughters);
+    /// Collect all volumes with daughters below a placement
+    void collect(TGeoNode* node, size_t subdet, set<TGeoVolume*>& seen);
+    /// Partition the geometry by subdetector
+    void partition();
+    /// Check one mother volume
+    void check(VolumeTask& task)  const;
+    /// Worker thread body
+    void work();
+    /// Run the checks with the configured number of threads
+    void run();
+    /// Read the results of a previous run
+    void readCache();
+    /// Save the results for future runs
+    void writeCache()  const;
+    /// Write the machine readable report
+    void writeReport()  const;
+  };
+
+  /// FNV-1a hash accumulator
+  struct Hasher  {
+    unsigned long long h = 14695981039346656037ULL;
+    Hasher& add(const void* ptr, size_t len)  {
+      const unsigned char* p = (const unsigned char*)ptr;
+      for(size_t i=0; i<len; ++i) { h ^= p[i]; h *= 1099511628211ULL; }
+      return *this;
+    }
+    Hasher& add(double v)             {  return add(&v, sizeof(v));             }
+    Hasher& add(unsigned long long v) {  return add(&v, sizeof(v));             }
+    Hasher& add(const char* s)        {  return add(s, s ? ::strlen(s)+1 : 0);  }
+  };
+
+  /// Version of the cache file format
+  const int CACHE_VERSION = 2;
+
+  /// Read a length prefixed name of the cache file: names may contain blanks
+  bool read_name(istream& is, size_t len, string& name)  {
+    name.assign(len, ' ');
+    return is.get() == ' ' && (len == 0 || is.read(&name[0], len));
+  }
+
+  /// Collect the daughters of a volume. Assemblies are replaced by their own daughters
+  void collect_daughters(const TGeoVolume* vol, const TGeoHMatrix& parent, int top,
+                         const string& path, Daughters& result)  {
+    for(int i=0, n=vol->GetNdaughters(); i<n; ++i)  {
+      const TGeoNode* node = vol->GetNode(i);
+      TGeoHMatrix matrix(parent);
+      matrix.Multiply(node->GetMatrix());
+      string name = path.empty() ? string(node->GetName()) : path + "/" + node->GetName();
+      if ( node->GetVolume()->IsAssembly() )
+        collect_daughters(node->GetVolume(), matrix, top < 0 ? i : top, name, result);
+      else
+        result.push_back(Daughter{node, matrix, top < 0 ? i : top, name});
+    }
+  }
+
+  /// Escape a string for the JSON output
+  string json(const string& s)  {
+    string r = "\"";
+    for(char c : s)  {
+      if ( c == '"' || c == '\\' ) { r += '\\'; r += c; }
+      else if ( (unsigned char)c < 0x20 ) r += ' ';
+      else r += c;
+    }
+    return r += '"';
+  }
+
+  /// Bounding box of a placed daughter in the frame of the mother
+  void mother_box(const Daughter& daughter, double lo[3], double hi[3])  {
+    const TGeoBBox* box = (const TGeoBBox*)daughter.node->GetVolume()->GetShape();
+    const double* o = box->GetOrigin();
+    const double  d[3] = { box->GetDX(), box->GetDY(), box->GetDZ() };
+    for(int k=0; k<3; ++k) { lo[k] = 1e300; hi[k] = -1e300; }
+    for(int i=0; i<8; ++i)  {
+      double local[3] = { o[0] + ((i&1) ? d[0] : -d[0]),
+                          o[1] + ((i&2) ? d[1] : -d[1]),
+                          o[2] + ((i&4) ? d[2] : -d[2]) }, master[3];
+      daughter.matrix.LocalToMaster(local, master);
+      for(int k=0; k<3; ++k) { lo[k] = min(lo[k], master[k]); hi[k] = max(hi[k], master[k]); }
+    }
+  }
+}
+
+/// Hash the shape parameters using the mesh points of the shape
+unsigned long long OverlapChecker::shapeHash(const TGeoShape* shape)   {
+  auto i = shape_hashes.find(shape);
+  if ( i != shape_hashes.end() ) return i->second;
+  Hasher h;
+  const TGeoBBox* box = (const TGeoBBox*)shape;
+  h.add(shape->ClassName()).add(box->GetDX()).add(box->GetDY()).add(box->GetDZ());
+  h.add(box->GetOrigin(), 3*sizeof(double));
+  if ( !shape->IsAssembly() )  {
+    int n = shape->GetNmeshVertices();
+    if ( n > 0 )  {
+      vector<double> pts(3*n);
+      shape->SetPoints(&pts[0]);
+      h.add(&pts[0], pts.size()*sizeof(double));
+    }
+    h.add(shape->Capacity());
+  }
+  return shape_hashes[shape] = h.h;
+}
+
+/// Hash of one mother volume: shapes and placements of the daughters
+unsigned long long OverlapChecker::volumeHash(TGeoVolume* vol, const Daughters& daughters)   {
+  Hasher h;
+  h.add(tolerance).add((unsigned long long)points).add(shapeHash(vol->GetShape()));
+  for(const Daughter& d : daughters)  {
+    h.add(d.name.c_str()).add(shapeHash(d.node->GetVolume()->GetShape()));
+    h.add((unsigned long long)d.top);
+    h.add(d.matrix.GetTranslation(), 3*sizeof(double)).add(d.matrix.GetRotationMatrix(), 9*sizeof(double));
+  }
+  return h.h;
+}
+
+/// Collect all volumes with daughters below a placement
+void OverlapChecker::collect(TGeoNode* node, size_t subdet, set<TGeoVolume*>& seen)   {
+  TGeoVolume* vol = node->GetVolume();
+  int num = vol->GetNdaughters();
+  if ( num == 0 || !seen.insert(vol).second ) return;
+  Daughters daughters;
+  collect_daughters(vol, TGeoHMatrix(), -1, "", daughters);
+  // The cost scales with the number of sampled daughters and the siblings tested
+  double cost = double(daughters.size())*daughters.size();
+  tasks.push_back(VolumeTask{vol, subdet, volumeHash(vol, daughters), cost, false, 0e0, daughters, OverlapRecords()});
+  for(int i=0; i<num; ++i)
+    collect(vol->GetNode(i), subdet, seen);
+}
+
+/// Partition the geometry by subdetector
+void OverlapChecker::partition()   {
+  set<TGeoVolume*> seen;
+  DetElement world = lcdd.world();
+  // The world volume itself: the subdetector envelopes are checked against each other
+  TGeoVolume* top = mgr->GetTopVolume();
+  subdetectors.push_back(SubdetectorInfo());
+  subdetectors.back().name = world.name();
+  Daughters daughters;
+  collect_daughters(top, TGeoHMatrix(), -1, "", daughters);
+  seen.insert(top);
+  tasks.push_back(VolumeTask{top, 0, volumeHash(top, daughters), double(daughters.size())*daughters.size(),
+                           false, 0e0, daughters, OverlapRecords()});
+  for(const auto& c : world.children())  {
+    DetElement de = c.second;
+    PlacedVolume pv = de.placement();
+    if ( !pv.isValid() ) continue;
+    if ( !selection.empty() && selection.find(de.name()) == selection.end() ) continue;
+    subdetectors.push_back(SubdetectorInfo());
+    subdetectors.back().name = de.name();
+    collect(pv.ptr(), subdetectors.size()-1, seen);
+  }
+  if ( !selection.empty() ) tasks.erase(tasks.begin());
+  for(VolumeTask& t : tasks)  {
+    SubdetectorInfo& s = subdetectors[t.subdetector];
+    auto i = cache.find(t.hash);
+    ++s.volumes;
+    if ( i != cache.end() )  {
+      t.cached   = true;
+      t.overlaps = i->second;
+      ++s.cached;
+    }
+  }
+  // Largest volumes first to balance the load between the workers
+  stable_sort(tasks.begin(), tasks.end(),
+              [](const VolumeTask& a, const VolumeTask& b) { return a.cost > b.cost; });
+}
+
+/// Check one mother volume
+void OverlapChecker::check(VolumeTask& task)  const   {
+  TGeoVolume*      vol    = task.volume;
+  const TGeoShape* mother = vol->GetShape();
+  const Daughters& d      = task.daughters;
+  const bool  extrusions  = !vol->IsAssembly();
+  const int   num         = int(d.size());
+  vector<double> lo(3*num), hi(3*num);
+  for(int i=0; i<num; ++i)
+    mother_box(d[i], &lo[3*i], &hi[3*i]);
+  // Deterministic sequence per volume: results do not depend on the scheduling
+  mt19937_64 rndm(task.hash);
+  uniform_real_distribution<double> flat(-1e0, 1e0);
+  map<pair<int,int>, OverlapRecord> found;
+  auto record = [&found](int a, int b, const char* type, const string& first,
+                         const string& second, double depth, const double* point)  {
+    OverlapRecord& r = found[make_pair(a, b)];
+    if ( r.type.empty() || depth > r.depth )  {
+      r.type   = type;
+      r.first  = first;
+      r.second = second;
+      r.depth  = depth;
+      ::memcpy(r.point, point, sizeof(r.point));
+    }
+  };
+
+  for(int i=0; i<num; ++i)  {
+    const TGeoShape* shape = d[i].node->GetVolume()->GetShape();
+    // Siblings with intersecting bounding boxes.
+    // Daughters of the same assembly are checked with the assembly itself.
+    vector<int> candidates;
+    for(int j=0; j<num; ++j)  {
+      if ( d[j].top == d[i].top ) continue;
+      bool hit = true;
+      for(int k=0; k<3 && hit; ++k)
+        hit = lo[3*i+k] < hi[3*j+k] && lo[3*j+k] < hi[3*i+k];
+      if ( hit ) candidates.push_back(j);
+    }
+    const TGeoBBox* box = (const TGeoBBox*)shape;
+    const double* o = box->GetOrigin();
+    for(int s=0, tries=0; s<points && tries<20*points; ++tries)  {
+      double local[3] = { o[0] + flat(rndm)*box->GetDX(),
+                          o[1] + flat(rndm)*box->GetDY(),
+                          o[2] + flat(rndm)*box->GetDZ() }, master[3], other[3];
+      if ( !shape->Contains(local) ) continue;
+      ++s;
+      d[i].matrix.LocalToMaster(local, master);
+      if ( extrusions && !mother->Contains(master) )  {
+        double depth = mother->Safety(master, kFALSE);
+        if ( depth > tolerance )
+          record(i, -1, "extrusion", d[i].name, vol->GetName(), depth, master);
+      }
+      for(int j : candidates)  {
+        d[j].matrix.MasterToLocal(master, other);
+        const TGeoShape* sibling_shape = d[j].node->GetVolume()->GetShape();
+        if ( sibling_shape->Contains(other) )  {
+          double depth = min(shape->Safety(local, kTRUE), sibling_shape->Safety(other, kTRUE));
+          if ( depth > tolerance )  {
+            int a = min(i, j), b = max(i, j);
+            record(a, b, "overlap", d[a].name, d[b].name, depth, master);
+          }
+        }
+      }
+    }
+  }
+  task.overlaps.clear();
+  for(const auto& f : found) task.overlaps.push_back(f.second);
+}
+
+/// Worker thread body
+void OverlapChecker::work()   {
+  typedef chrono::steady_clock clock;
+  try  {
+    // Registers the thread with the geometry manager: boolean shapes keep per thread state
+    mgr->AddNavigator();
+    for(size_t i = next_task++; i < tasks.size(); i = next_task++)  {
+      VolumeTask& t = tasks[i];
+      if ( t.cached ) continue;
+      clock::time_point start = clock::now();
+      check(t);
+      t.seconds = chrono::duration<double>(clock::now()-start).count();
+    }
+  }
+  catch(const exception& e)  {
+    lock_guard<mutex> guard(lock);
+    error = e.what();
+    next_task = tasks.size();
+  }
+}
+
+/// Run the checks with the configured number of threads
+void OverlapChecker::run()   {
+  typedef chrono::steady_clock clock;
+  int n_threads = threads > 0 ? threads : max(1u, thread::hardware_concurrency());
+  size_t todo = 0;
+  for(const VolumeTask& t : tasks) todo += t.cached ? 0 : 1;
+  printout(INFO,"OverlapCheck","+++ Checking %ld of %ld volumes (%ld cached) of %ld subdetectors "
+           "with %d threads. Tolerance: %g cm, %d points per daughter.",
+           long(todo), long(tasks.size()), long(tasks.size()-todo), long(subdetectors.size()),
+           n_threads, tolerance, points);
+  clock::time_point start = clock::now();
+  if ( todo > 0 )  {
+    mgr->SetMaxThreads(n_threads);
+    vector<thread> workers;
+    for(int i=0; i<n_threads; ++i)
+      workers.emplace_back(&OverlapChecker::work, this);
+    for(thread& t : workers) t.join();
+    if ( !error.empty() )  {
+      except("OverlapCheck","+++ Overlap check failed: %s",error.c_str());
+    }
+  }
+  for(const VolumeTask& t : tasks)  {
+    SubdetectorInfo& s = subdetectors[t.subdetector];
+    s.overlaps += t.overlaps.size();
+    s.seconds  += t.seconds;
+    if ( !t.cached ) ++s.checked;
+  }
+  for(const VolumeTask& t : tasks)  {
+    for(const OverlapRecord& r : t.overlaps)
+      printout(WARNING,"OverlapCheck","+++ %s of %s and %s in %s: depth %g cm at (%g,%g,%g)",
+               r.type.c_str(), r.first.c_str(), r.second.c_str(), t.volume->GetName(),
+               r.depth, r.point[0], r.point[1], r.point[2]);
+  }
+  for(const SubdetectorInfo& s : subdetectors)  {
+    printout(s.overlaps ? WARNING : INFO,"OverlapCheck",
+             "+++ %-24s %6ld volumes %6ld checked %6ld cached %6ld overlaps %9.3f sec",
+             s.name.c_str(), long(s.volumes), long(s.checked), long(s.cached), long(s.overlaps), s.seconds);
+  }
+  printout(INFO,"OverlapCheck","+++ Overlap check finished in %.3f sec.",
+           chrono::duration<double>(clock::now()-start).count());
+}
+
+/// Read the results of a previous run
+/*
+ *  Format: a header line "OverlapCache <version>", then one line per volume
+ *  "V <hash> <number of records>" followed by the records
+ *  "O <type> <depth> <x> <y> <z> <length first> <length second> <first> <second>".
+ *  The names are length prefixed: node names may contain blanks.
+ */
+void OverlapChecker::readCache()   {
+  ifstream in(cache_file.c_str());
+  string tag;
+  int version = 0;
+  if ( !in.is_open() )  {
+    printout(INFO,"OverlapCheck","+++ No cache file %s found. Checking all volumes.",cache_file.c_str());
+    return;
+  }
+  if ( !(in >> tag >> version) || tag != "OverlapCache" || version != CACHE_VERSION )  {
+    printout(WARNING,"OverlapCheck","+++ Cache file %s has an unknown format. Checking all volumes.",
+             cache_file.c_str());
+    return;
+  }
+  unsigned long long hash = 0;
+  size_t num = 0;
+  bool   good = true;
+  while ( good && (in >> tag >> hex >> hash >> dec >> num) )  {
+    OverlapRecords recs;
+    good = tag == "V";
+    for(size_t i=0; good && i<num; ++i)  {
+      OverlapRecord r;
+      size_t len_first = 0, len_second = 0;
+      good = (in >> tag >> r.type >> r.depth >> r.point[0] >> r.point[1] >> r.point[2] >> len_first >> len_second)
+        && tag == "O" && read_name(in, len_first, r.first) && read_name(in, len_second, r.second);
+      if ( good ) recs.push_back(r);
+    }
+    if ( good ) cache[hash] = recs;
+  }
+  if ( !good )  {
+    printout(WARNING,"OverlapCheck","+++ Cache file %s is corrupted after %ld volume results.",
+             cache_file.c_str(),long(cache.size()));
+  }
+  printout(INFO,"OverlapCheck","+++ Read %ld cached volume results from %s.",long(cache.size()),cache_file.c_str());
+}
+
+/// Save the results for future runs
+void OverlapChecker::writeCache()  const   {
+  // Keep the entries of volumes not checked in this run (e.g. other subdetectors)
+  Cache entries(cache);
+  for(const VolumeTask& t : tasks)
+    entries[t.hash] = t.overlaps;
+  ofstream out(cache_file.c_str());
+  if ( !out.is_open() )  {
+    except("OverlapCheck","+++ Cannot open cache file %s: %s",cache_file.c_str(),::strerror(errno));
+  }
+  out.precision(17);
+  out << "OverlapCache " << CACHE_VERSION << "\n";
+  for(const auto& e : entries)  {
+    out << "V " << hex << e.first << dec << " " << e.second.size() << "\n";
+    for(const OverlapRecord& r : e.second)
+      out << "O " << r.type << " " << r.depth << " " << r.point[0] << " " << r.point[1] << " "
+          << r.point[2] << " " << r.first.length() << " " << r.second.length() << " "
+          << r.first << " " << r.second << "\n";
+  }
+}
+
+/// Write the machine readable report
+void OverlapChecker::writeReport()  const   {
+  FILE* f = output == "-" ? stdout : ::fopen(output.c_str(), "w");
+  bool first = true;
+  if ( !f )  {
+    except("OverlapCheck","+++ Cannot open output file %s: %s",output.c_str(),::strerror(errno));
+  }
+  ::fprintf(f, "{\n  \"tolerance\": %g,\n  \"points\": %d,\n  \"subdetectors\": [", tolerance, points);
+  for(const SubdetectorInfo& s : subdetectors)  {
+    ::fprintf(f, "%s\n    {\"name\": %s, \"volumes\": %ld, \"checked\": %ld, \"cached\": %ld, "
+              "\"overlaps\": %ld, \"seconds\": %.6f}", first ? "" : ",", json(s.name).c_str(),
+              long(s.volumes), long(s.checked), long(s.cached), long(s.overlaps), s.seconds);
+    first = false;
+  }
+  ::fprintf(f, "\n  ],\n  \"overlaps\": [");
+  first = true;
+  for(const VolumeTask& t : tasks)  {
+    for(const OverlapRecord& r : t.overlaps)  {
+      ::fprintf(f, "%s\n    {\"subdetector\": %s, \"volume\": %s, \"type\": \"%s\", \"first\": %s, "
+                "\"second\": %s, \"depth\": %.6g, \"point\": [%.6g, %.6g, %.6g], \"cached\": %s}",
+                first ? "" : ",", json(subdetectors[t.subdetector].name).c_str(),
+                json(t.volume->GetName()).c_str(), r.type.c_str(), json(r.first).c_str(),
+                json(r.second).c_str(), r.depth, r.point[0], r.point[1], r.point[2],
+                t.cached ? "true" : "false");
+      first = false;
+    }
+  }
+  ::fprintf(f, "\n  ]\n}\n");
+  if ( f != stdout ) ::fclose(f);
+}
+
+/// Basic entry point to check the geometry for overlaps in parallel
+/**
+ *  Factory: DD4hep_ParallelOverlapCheck
+ *
+ *  Invokation: -plugin DD4hep_ParallelOverlapCheck
+ *                      -tolerance <cm>       (default: 0.1)
+ *                      -points    <number>   sample points per daughter (default: 1000)
+ *                      -threads   <number>   (default: number of cores)
+ *                      -detector  <name>     restrict to subdetector (may be repeated)
+ *                      -cache     <file>     result cache of previous runs
+ *                      -output    <file>     JSON report ("-" for stdout)
+ *
+ *  Assemblies have no shape and are not checked for extrusions. Their daughters
+ *  are checked against the siblings of the assembly and for extrusions from the
+ *  first mother volume, which is no assembly. Overlaps between daughters of the
+ *  same assembly are reported for the assembly volume.
+ *
+ *  Returns 1 if no overlap was found, 0 otherwise.
+ *
+ *  \author  M.Frank
+ *  \version 1.0
+ *  \date    19/10/2017
+ */
+static long parallel_overlap_check(LCDD& lcdd, int argc, char** argv)  {
+  OverlapChecker checker(lcdd);
+  for(int i=0; i<argc; ++i)  {
+    if      ( 0 == ::strncmp(argv[i],"-tolerance",4) && i+1<argc ) checker.tolerance = ::atof(argv[++i]);
+    else if ( 0 == ::strncmp(argv[i],"-points",4)    && i+1<argc ) checker.points    = ::atoi(argv[++i]);
+    else if ( 0 == ::strncmp(argv[i],"-threads",4)   && i+1<argc ) checker.threads   = ::atoi(argv[++i]);
+    else if ( 0 == ::strncmp(argv[i],"-detector",4)  && i+1<argc ) checker.selection.insert(argv[++i]);
+    else if ( 0 == ::strncmp(argv[i],"-cache",4)     && i+1<argc ) checker.cache_file = argv[++i];
+    else if ( 0 == ::strncmp(argv[i],"-output",4)    && i+1<argc ) checker.output    = argv[++i];
+    else  {
+      except("OverlapCheck","+++ Unknown argument: %s",argv[i]);
+    }
+  }
+  if ( checker.points < 1 )  {
+    except("OverlapCheck","+++ Invalid number of sample points: %d",checker.points);
+  }
+  if ( !checker.cache_file.empty() ) checker.readCache();
+  checker.partition();
+  checker.run();
+  if ( !checker.cache_file.empty() ) checker.writeCache();
+  if ( !checker.output.empty() ) checker.writeReport();
+  size_t overlaps = 0;
+  for(const SubdetectorInfo& s : checker.subdetectors) overlaps += s.overlaps;
+  return overlaps == 0 ? 1 : 0;
+}
+DECLARE_APPLY(DD4hep_ParallelOverlapCheck,parallel_overlap_check)
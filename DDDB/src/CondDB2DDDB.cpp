@@ -27,6 +27,9 @@
 #include "DDDB/DDDBConversion.h"
 
 // C/C++ include files
+#include <set>
+#include <thread>
+#include <atomic>
 
 using namespace std;
 using namespace DD4hep;
@@ -140,11 +143,16 @@ namespace DD4hep {
         }
       };
 
+      /// Documents parsed ahead of their conversion: (DDDB document, XML document)
+      typedef map<string,pair<Document*,XML::Document::DOC> > Prefetched;
+
     public:
       lcdd_t&     lcdd;
       XML::UriReader* resolver;
       dddb*       geo;
       Locals      locals;
+      Prefetched  prefetched;
+      int         num_threads;
       bool        check;
       bool        print_xml;
       bool        print_docs;
@@ -164,7 +172,7 @@ namespace DD4hep {
 
       /// Default constructor
       Context(lcdd_t& l) 
-        : lcdd(l), resolver(0), geo(0), check(true),
+        : lcdd(l), resolver(0), geo(0), num_threads(1), check(true),
           print_xml(false),
           print_docs(false),
           print_materials(false), 
@@ -183,6 +191,11 @@ namespace DD4hep {
       {     }
       /// Default destructor
       ~Context()  {
+        for(Prefetched::iterator i=prefetched.begin(); i!=prefetched.end(); ++i)  {
+          XML::DocumentHolder doc((*i).second.second);
+          (*i).second.first->release();
+        }
+        prefetched.clear();
       }
 
       /** Printout helpers                                                                             */
@@ -386,6 +399,8 @@ namespace DD4hep {
       return container.find(id) != container.end();
     }
 
+    void prefetch_dddb_entities(Context* context, xml_h element);
+
     bool checkParents(Context* context, Catalog* det)  {
       dddb* geo = context->geo;
       if ( det == geo->top )  {
@@ -1476,6 +1491,7 @@ namespace DD4hep {
         {
           Context::PreservedLocals locals(context);
           context->locals.obj_path = catalog->path;
+          prefetch_dddb_entities(context, e);
           xml_coll_t(e, _U(parameter)).for_each(Conv<Parameter>(lcdd,context,catalog));
           xml_coll_t(e, _U(isotope)).for_each(Conv<Isotope>(lcdd,context,catalog));
           xml_coll_t(e, _U(element)).for_each(Conv<Element>(lcdd,context,catalog));
@@ -1510,6 +1526,7 @@ namespace DD4hep {
     template <> void Conv<dddb>::convert(xml_h e) const {
       Catalog* catalog = 0;
       Context* context = _param<Context>();
+      prefetch_dddb_entities(context, e);
       xml_coll_t(e, _U(parameter)).for_each(Conv<Parameter>(lcdd,context,catalog));
       xml_coll_t(e, _U(isotope)).for_each(Conv<Isotope>(lcdd,context,catalog));
       xml_coll_t(e, _U(element)).for_each(Conv<Element>(lcdd,context,catalog));
@@ -1664,6 +1681,97 @@ namespace DD4hep {
       return p;
     }
 
+    /// Create a new DDDB document entry for an entity
+    Document* new_document(Context* context, const string& doc_path)  {
+      DDDBReaderContext* ctx       = (DDDBReaderContext*)context->resolver->context();
+      Document*          xml_doc   = new Document();
+      xml_doc->id                  = doc_path;
+      xml_doc->context.doc         = xml_doc->id;
+      xml_doc->context.event_time  = ctx->event_time;
+      xml_doc->context.valid_since = 0;
+      xml_doc->context.valid_until = 0;
+      return xml_doc;
+    }
+
+    /// Parse all external documents referenced by a catalog in parallel
+    /** Only the reading and parsing of the documents is done by the worker
+     *  threads, each with its own parser instance and reader context.
+     *  The conversion of the parsed documents is not touched: it happens
+     *  when the references are processed in the usual order by load_dddb_entity,
+     *  which picks up the prefetched documents. Hence the result is identical
+     *  to the single threaded processing.
+     */
+    void prefetch_dddb_entities(Context* context, xml_h element)   {
+      /// Work item of the prefetch step
+      struct Item  {
+        string              path, fp;
+        Document*           doc;
+        XML::Document::DOC  xml;
+      };
+      static const xml_tag_t* refs[] = {
+        &_LBU(elementref), &_LBU(materialref), &_LBU(logvolref), &_LBU(tabpropertyref),
+        &_LBU(conditionref), &_LBU(catalogref), &_LBU(detelemref), 0
+      };
+      if ( context->num_threads < 2 )  {
+        return;
+      }
+      vector<Item> items;
+      set<string>  paths;
+      const dddb::Documents& docs = context->geo->documents;
+      for(const xml_tag_t** tag=refs; *tag; ++tag)  {
+        for(xml_coll_t c(element, **tag); c; ++c)  {
+          string href = c.attr<string>(_LBU(href));
+          if ( href.find('#') == 0 ) continue;
+          string doc_path = reference_href(c, href);
+          size_t hash = doc_path.find('#');
+          if ( hash != string::npos ) doc_path = doc_path.substr(0,hash);
+          if ( _find(doc_path,docs) || _find(doc_path,context->prefetched) ) continue;
+          if ( !paths.insert(doc_path).second ) continue;
+          Item item;
+          size_t idx = doc_path.find('[');
+          size_t idq = doc_path.find(']');
+          item.path = doc_path;
+          item.fp   = (idq != string::npos && idx != string::npos) ? doc_path.substr(0,idx) : doc_path;
+          item.doc  = new_document(context, doc_path);
+          item.xml  = 0;
+          items.push_back(item);
+        }
+      }
+      if ( items.size() < 2 )  {
+        for(size_t i=0; i<items.size(); ++i) delete items[i].doc;
+        return;
+      }
+      XML::UriReader* rdr = context->resolver;
+      atomic<size_t>  next(0);
+      vector<thread*> threads;
+      size_t num_threads = min(items.size(), size_t(context->num_threads));
+      for(size_t i=0; i<num_threads; ++i)  {
+        threads.push_back(new thread([&items,&next,rdr] {
+              for(size_t j=next++; j<items.size(); j=next++)  {
+                Item& it = items[j];
+                try  {
+                  XML::UriContextReader reader(rdr, &it.doc->context);
+                  it.xml = xml_handler_t().load(it.fp, &reader);
+                }
+                catch(...)  {
+                  it.xml = 0;  // Failure is reported when converting the entity
+                }
+              }
+            }));
+      }
+      for(size_t i=0; i<threads.size(); ++i)  {
+        threads[i]->join();
+        delete threads[i];
+      }
+      for(size_t i=0; i<items.size(); ++i)  {
+        Item& it = items[i];
+        if ( it.xml )
+          context->prefetched.insert(make_pair(it.path,make_pair(it.doc,it.xml)));
+        else
+          delete it.doc;
+      }
+    }
+
     template <typename ACTION>
     void load_dddb_entity(Context*      context,
                           Catalog*      catalog, 
@@ -1697,17 +1805,24 @@ namespace DD4hep {
             fp = doc_path.substr(0,idx);
           }
           XML::UriReader*    rdr       = context->resolver;
-          DDDBReaderContext* ctx       = (DDDBReaderContext*)rdr->context();
-          Document*          xml_doc   = new Document();
-          xml_doc->id                  = doc_path;
+          Document*          xml_doc   = 0;
+          xml_doc_holder_t   doc;
+          Context::Prefetched::iterator ipre = context->prefetched.find(doc_path);
+          if ( ipre != context->prefetched.end() )  {
+            // Link step: document was already parsed by a prefetch worker
+            xml_doc = (*ipre).second.first;
+            doc.assign((*ipre).second.second);
+            context->prefetched.erase(ipre);
+          }
+          else  {
+            xml_doc = new_document(context, doc_path);
+          }
           xml_doc->name                = context->locals.obj_path;
-          xml_doc->context.doc         = xml_doc->id;
-          xml_doc->context.event_time  = ctx->event_time;
-          xml_doc->context.valid_since = 0;
-          xml_doc->context.valid_until = 0;
           docs.insert(make_pair(doc_path,xml_doc->addRef()));
           XML::UriContextReader reader(rdr, &xml_doc->context);
-          xml_doc_holder_t doc(xml_handler_t().load(fp, &reader));
+          if ( !doc.ptr() )  {
+            doc.assign(xml_handler_t().load(fp, &reader));
+          }
           xml_h e = doc.root();
           context->print(xml_doc);
           if ( e )   {
@@ -1800,6 +1915,9 @@ namespace DD4hep {
           ctx->event_time = evt_time;
         }
         config_context(ctxt, rdr, sys_id, obj_path);
+        if ( argc >= 5 && argv[4] != 0 )  {
+          ctxt.num_threads = *(int*)argv[4];
+        }
         load_dddb_entity<ACTION>(&ctxt,0,0,ctxt.locals.xml_doc->id);
         checkParents( &ctxt );
         fixCatalogs( &ctxt );
@@ -0,0 +1,444 @@
+//==========================================================================
+//  AIDA Detector description implementation for LCD
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Frank
+//
+//==========================================================================
+//
+// DDDB is a detector description convention developed by the LHCb experiment.
+// For further information concerning the DTD, please see:
+// http://lhcb-comp.web.cern.ch/lhcb-comp/Frameworks/DetDesc/Documents/lhcbDtd.pdf
+//
+//==========================================================================
+
+// Framework includes
+#include "DD4hep/Mutex.h"
+#include "DDDB/DDDBReader.h"
+
+/// Namespace for the AIDA detector description toolkit
+namespace DD4hep {
+
+  /// Namespace of the DDDB conversion stuff
+  namespace DDDB  {
+
+    /// Layout of a packed DDDB archive file
+    /**
+     *  The archive consists of:
+     *  - the header
+     *  - the entry table, sorted by entity name
+     *  - the name block (names are not null terminated)
+     *  - the data block with the raw XML content of all entities
+     *
+     *  All offsets are relative to the begin of the file.
+     *
+     *  \author   M.Frank
+     *  \version  1.0
+     *  \ingroup DD4HEP_XML
+     */
+    namespace DDDBArchive  {
+      /// Archive file header
+      struct Header  {
+        char               magic[8];
+        unsigned int       version;
+        unsigned int       count;
+        unsigned long long names;
+        unsigned long long data;
+      };
+      /// Entry table record
+      struct Entry  {
+        unsigned long long name_offset;
+        unsigned long long data_offset;
+        unsigned long long data_length;
+        unsigned int       name_length;
+        unsigned int       spare;
+      };
+      /// Magic word identifying archive files
+      static const char         MAGIC[8] = {'D','D','D','B','P','A','C','K'};
+      /// Current archive version
+      static const unsigned int VERSION  = 1;
+    }
+
+    /// Class serving DDDB entities from a single memory mapped archive file
+    /**
+     *  The archive is either the file given as directory, or
+     *  if the directory is a real directory: <directory>.pack
+     *  The archive is mapped with the first entity request.
+     *  Only entities matching the reader's match string (e.g. conddb:)
+     *  are served from the archive, the top level input file is still
+     *  read by the XML parser.
+     *
+     *  Archives are created from an existing DDDB directory tree
+     *  with the plugin DDDB_PackArchive.
+     *
+     *  \author   M.Frank
+     *  \version  1.0
+     *  \ingroup DD4HEP_XML
+     */
+    class DDDBArchiveReader : public DDDBReader   {
+    protected:
+      /// Name of the archive file
+      std::string m_archive;
+      /// Pointer to the mapped archive
+      const char* m_mapping;
+      /// Size of the mapped region
+      size_t      m_size;
+      /// Number of entries in the archive
+      size_t      m_count;
+      /// Protection of the archive mapping: documents may be read by several threads
+      dd4hep_mutex_t m_lock;
+
+      /// Map the archive file into memory. Returns false if it cannot be mapped, throws if it is corrupt
+      bool open();
+      /// Unmap the archive file
+      void close();
+      /// Binary search of an entity in the archive entry table
+      const DDDBArchive::Entry* find(const std::string& name)  const;
+
+    public:
+      /// Standard constructor
+      DDDBArchiveReader(const std::string& archive="");
+      /// Default destructor
+      virtual ~DDDBArchiveReader();
+      /// Read raw XML object from the database / file
+      virtual int getObject(const std::string& system_id, UserContext* ctxt, std::string& data);
+      /// Resolve a given URI to a string containing the data
+      virtual bool load(const std::string& system_id, std::string& buffer);
+      /// Resolve a given URI to a string containing the data
+      virtual bool load(const std::string& system_id, UserContext* ctxt, std::string& buffer);
+    };
+  }    /* End namespace DDDB            */
+}      /* End namespace DD4hep          */
+
+
+//==========================================================================
+// Framework includes
+#include "DD4hep/Factories.h"
+#include "DD4hep/Printout.h"
+#include "DD4hep/LCDD.h"
+
+// C/C++ include files
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <unistd.h>
+#include <dirent.h>
+#include <fcntl.h>
+
+using namespace std;
+using namespace DD4hep;
+using namespace DD4hep::DDDB;
+
+namespace {
+
+  /// Remove the optional "file:" prefix of a path
+  string _file_name(const string& path)  {
+    return path.substr(0,5) == "file:" ? path.substr(5) : path;
+  }
+
+  /// Remove duplicate slashes from an entity name
+  string _entity_name(const string& id)  {
+    string name;
+    name.reserve(id.length()+1);
+    if ( id.empty() || id[0] != '/' ) name += '/';
+    for(size_t i=0; i<id.length(); ++i)  {
+      if ( id[i] == '/' && !name.empty() && name[name.length()-1] == '/' ) continue;
+      name += id[i];
+    }
+    return name;
+  }
+
+  /// Read the content of a file into a string
+  bool _read_file(const string& path, string& buffer)   {
+    int fid = ::open(path.c_str(), O_RDONLY);
+    if ( fid != -1 )   {
+      struct stat buff;
+      if ( 0 == ::fstat(fid, &buff) )  {
+        size_t done = 0, len = buff.st_size;
+        buffer.resize(len);
+        while ( done<len )  {
+          ssize_t sc = ::read(fid, &buffer[done], len-done);
+          if ( sc > 0 ) { done += sc; continue; }
+          break;
+        }
+        ::close(fid);
+        return done == len;
+      }
+      ::close(fid);
+    }
+    return false;
+  }
+
+  /// Recursively collect all regular files of a directory tree (names relative to the top)
+  void _scan_directory(const string& top, const string& rel, vector<string>& files)   {
+    string dir_name = top + rel;
+    DIR* dir = ::opendir(dir_name.c_str());
+    if ( dir )  {
+      struct dirent* entry;
+      while( (entry=::readdir(dir)) != 0 )   {
+        const char* n = entry->d_name;
+        if ( ::strcmp(n,".") == 0 || ::strcmp(n,"..") == 0 ) continue;
+        string   name = rel + '/' + n;
+        struct stat buff;
+        if ( 0 != ::stat((top+name).c_str(), &buff) ) continue;
+        if ( S_ISDIR(buff.st_mode) )
+          _scan_directory(top, name, files);
+        else if ( S_ISREG(buff.st_mode) )
+          files.push_back(name);
+      }
+      ::closedir(dir);
+      return;
+    }
+    except("DDDBArchive","+++ Failed to open directory %s [%s]",dir_name.c_str(),::strerror(errno));
+  }
+
+  /// Comparison of archive entries by name
+  struct _entry_less  {
+    const char* names;
+    _entry_less(const char* n) : names(n) {}
+    int compare(const DDDBArchive::Entry& e, const char* n, size_t len) const  {
+      size_t l = std::min(size_t(e.name_length), len);
+      int cmp = ::memcmp(names+e.name_offset, n, l);
+      if ( cmp ) return cmp;
+      return e.name_length < len ? -1 : (e.name_length > len ? 1 : 0);
+    }
+    bool operator()(const DDDBArchive::Entry& e, const string& n) const
+    {  return compare(e, n.c_str(), n.length()) < 0;  }
+  };
+
+  /// Check the header and all entries of a mapped archive. Returns 0 or the reason of the failure
+  const char* _check_archive(const DDDBArchive::Header* hdr, size_t size)   {
+    typedef unsigned long long ull;
+    const ull table = sizeof(DDDBArchive::Header);
+    if ( ::memcmp(hdr->magic,DDDBArchive::MAGIC,sizeof(hdr->magic)) != 0 )
+      return "bad magic word";
+    else if ( hdr->version != DDDBArchive::VERSION )
+      return "unsupported version";
+    else if ( hdr->count > (size-table)/sizeof(DDDBArchive::Entry) )
+      return "entry table exceeds the file size";
+    else if ( table+hdr->count*sizeof(DDDBArchive::Entry) > hdr->names )
+      return "entry table overlaps the name block";
+    else if ( hdr->names > hdr->data )
+      return "name block overlaps the data block";
+    else if ( hdr->data > size )
+      return "data block exceeds the file size";
+    const DDDBArchive::Entry* e = (const DDDBArchive::Entry*)((const char*)hdr+table);
+    for(ull i=0; i<hdr->count; ++i, ++e)  {
+      if ( e->name_offset < hdr->names || e->name_offset > hdr->data ||
+           e->name_length > hdr->data - e->name_offset )
+        return "entry name outside the name block";
+      if ( e->data_offset < hdr->data || e->data_offset > size ||
+           e->data_length > size - e->data_offset )
+        return "entry data outside the data block";
+    }
+    return 0;
+  }
+}
+
+/// Standard constructor
+DDDBArchiveReader::DDDBArchiveReader(const std::string& archive)
+  : DDDBReader(), m_archive(archive), m_mapping(0), m_size(0), m_count(0)
+{
+}
+
+/// Default destructor
+DDDBArchiveReader::~DDDBArchiveReader()   {
+  close();
+}
+
+/// Map the archive file into memory. Returns false if it cannot be mapped, throws if it is corrupt
+bool DDDBArchiveReader::open()   {
+  dd4hep_lock_t lock(m_lock);
+  if ( m_mapping )  {
+    return true;
+  }
+  if ( m_archive.empty() )  {
+    struct stat buff;
+    string dir = _file_name(m_directory);
+    if ( 0 == ::stat(dir.c_str(), &buff) && S_ISREG(buff.st_mode) )
+      m_archive = dir;
+    else
+      m_archive = dir + ".pack";
+  }
+  int fid = ::open(m_archive.c_str(), O_RDONLY);
+  if ( fid == -1 )  {
+    printout(ERROR,"DDDBArchiveReader","++ Failed to open archive %s [%s]",
+             m_archive.c_str(), ::strerror(errno));
+    return false;
+  }
+  struct stat buff;
+  if ( 0 != ::fstat(fid, &buff) || size_t(buff.st_size) < sizeof(DDDBArchive::Header) )  {
+    printout(ERROR,"DDDBArchiveReader","++ Invalid archive %s",m_archive.c_str());
+    ::close(fid);
+    return false;
+  }
+  void* ptr = ::mmap(0, buff.st_size, PROT_READ, MAP_SHARED, fid, 0);
+  ::close(fid);
+  if ( ptr == MAP_FAILED )  {
+    printout(ERROR,"DDDBArchiveReader","++ Failed to map archive %s [%s]",
+             m_archive.c_str(), ::strerror(errno));
+    return false;
+  }
+  const DDDBArchive::Header* hdr = (const DDDBArchive::Header*)ptr;
+  const char* err = _check_archive(hdr, buff.st_size);
+  if ( err )  {
+    ::munmap(ptr, buff.st_size);
+    except("DDDBArchiveReader","++ File %s is no valid DDDB archive: %s.",m_archive.c_str(),err);
+  }
+  m_mapping = (const char*)ptr;
+  m_size    = buff.st_size;
+  m_count   = hdr->count;
+  printout(INFO,"DDDBArchiveReader","++ Mapped archive %s: %ld entities, %ld bytes.",
+           m_archive.c_str(), long(m_count), long(m_size));
+  return true;
+}
+
+/// Unmap the archive file
+void DDDBArchiveReader::close()   {
+  if ( m_mapping )  {
+    ::munmap((void*)m_mapping, m_size);
+    m_mapping = 0;
+    m_size    = 0;
+    m_count   = 0;
+  }
+}
+
+/// Binary search of an entity in the archive entry table
+const DDDBArchive::Entry* DDDBArchiveReader::find(const string& name)  const  {
+  const DDDBArchive::Entry* beg = (const DDDBArchive::Entry*)(m_mapping+sizeof(DDDBArchive::Header));
+  const DDDBArchive::Entry* end = beg + m_count;
+  _entry_less less(m_mapping);
+  const DDDBArchive::Entry* e = std::lower_bound(beg, end, name, less);
+  if ( e != end && 0 == less.compare(*e, name.c_str(), name.length()) )
+    return e;
+  return 0;
+}
+
+/// Read raw XML object from the database / file
+int DDDBArchiveReader::getObject(const string& system_id, UserContext* /* ctxt */, string& buffer)  {
+  if ( open() )   {
+    const DDDBArchive::Entry* e = find(_entity_name(system_id));
+    if ( e && e->data_offset+e->data_length <= m_size )  {
+      buffer.assign(m_mapping+e->data_offset, e->data_length);
+      return 1;
+    }
+    errno = ENOENT;
+  }
+  return 0;
+}
+
+/// Resolve a given URI to a string containing the data
+bool DDDBArchiveReader::load(const string& system_id, string& buffer)   {
+  return XML::UriReader::load(system_id, buffer);
+}
+
+/// Resolve a given URI to a string containing the data
+bool DDDBArchiveReader::load(const string& system_id, UserContext* ctxt, string& buffer)  {
+  bool result = DDDBReader::load(system_id, ctxt, buffer);
+  if ( result )  {
+    DDDBReaderContext* c = (DDDBReaderContext*)ctxt;
+    c->valid_since = c->event_time;
+    c->valid_until = c->event_time;
+  }
+  return result;
+}
+
+namespace {
+  void* create_dddb_xml_archive_reader(const char* arg) {
+    return new DDDBArchiveReader(arg ? arg : "");
+  }
+}
+DECLARE_CONSTRUCTOR(DDDB_ArchiveReader,create_dddb_xml_archive_reader)
+
+/// Plugin to pack an existing DDDB directory tree into a single archive file
+/**
+ *  Arguments: -input  <directory>   Top directory of the DDDB tree.
+ *             -output <file-name>   Archive file. Default: <directory>.pack
+ *
+ *  \author   M.Frank
+ *  \version  1.0
+ *  \ingroup DD4HEP_XML
+ */
+static long dddb_pack_archive(Geometry::LCDD& /* lcdd */, int argc, char** argv)  {
+  string input, output;
+  for(int i=0; i<argc; ++i)  {
+    if ( ::strncmp(argv[i],"-input",4)==0 && i+1<argc )
+      input = _file_name(argv[++i]);
+    else if ( ::strncmp(argv[i],"-output",4)==0 && i+1<argc )
+      output = _file_name(argv[++i]);
+    else  {
+      ::printf("DDDB_PackArchive -opt [-opt]                                     \n"
+               "  -input  <directory>   Top directory of the DDDB tree to be packed.\n"
+               "  -output <file-name>   Archive file. Default: <directory>.pack     \n");
+      ::exit(EINVAL);
+    }
+  }
+  while ( input.length() > 1 && input[input.length()-1] == '/' )
+    input.erase(input.length()-1);
+  if ( input.empty() )  {
+    except("DDDB_PackArchive","+++ No input directory given. Use -input <directory>.");
+  }
+  if ( output.empty() ) output = input + ".pack";
+
+  vector<string> files;
+  _scan_directory(input, "", files);
+  sort(files.begin(), files.end());
+
+  DDDBArchive::Header hdr;
+  vector<DDDBArchive::Entry> entries(files.size());
+  string names;
+  ::memcpy(hdr.magic, DDDBArchive::MAGIC, sizeof(hdr.magic));
+  hdr.version = DDDBArchive::VERSION;
+  hdr.count   = files.size();
+  hdr.names   = sizeof(hdr) + entries.size()*sizeof(DDDBArchive::Entry);
+  for(size_t i=0; i<files.size(); ++i)  {
+    entries[i].name_offset = hdr.names + names.length();
+    entries[i].name_length = files[i].length();
+    entries[i].spare       = 0;
+    names += files[i];
+  }
+  hdr.data = hdr.names + names.length();
+
+  // Write to a temporary file first: concurrent readers never see partial archives
+  string tmp = output + ".tmp";
+  FILE* f = ::fopen(tmp.c_str(),"wb");
+  if ( !f )  {
+    except("DDDB_PackArchive","+++ Failed to open output file %s [%s]",tmp.c_str(),::strerror(errno));
+  }
+  bool ok = ::fseek(f, hdr.data, SEEK_SET) == 0;
+  unsigned long long offset = hdr.data;
+  string buffer;
+  for(size_t i=0; ok && i<files.size(); ++i)  {
+    if ( !_read_file(input+files[i], buffer) )  {
+      printout(ERROR,"DDDB_PackArchive","+++ Failed to read %s",(input+files[i]).c_str());
+      ok = false;
+      break;
+    }
+    entries[i].data_offset = offset;
+    entries[i].data_length = buffer.length();
+    ok = ::fwrite(buffer.c_str(), 1, buffer.length(), f) == buffer.length();
+    offset += buffer.length();
+  }
+  ok = ok && ::fseek(f, 0, SEEK_SET) == 0;
+  ok = ok && ::fwrite(&hdr, sizeof(hdr), 1, f) == 1;
+  ok = ok && (entries.empty() || ::fwrite(&entries[0], sizeof(DDDBArchive::Entry), entries.size(), f) == entries.size());
+  ok = ok && ::fwrite(names.c_str(), 1, names.length(), f) == names.length();
+  ok = (::fclose(f) == 0) && ok;
+  if ( !ok || ::rename(tmp.c_str(), output.c_str()) != 0 )  {
+    ::unlink(tmp.c_str());
+    except("DDDB_PackArchive","+++ Failed to write archive %s [%s]",output.c_str(),::strerror(errno));
+  }
+  printout(INFO,"DDDB_PackArchive","+++ Packed %ld entities [%lld bytes] from %s into %s",
+           long(files.size()), offset, input.c_str(), output.c_str());
+  return 1;
+}
+DECLARE_APPLY(DDDB_PackArchive,dddb_pack_archive)
@@ -53,10 +53,14 @@ static void usage_load_xml_dddb()   {
     "   Note: No '-' signs infront of identifiers!                           \n"
     "                                                                        \n"
     "  -loader <plugin>      Plugin instance for XML entity resolution.      \n"
+    "                        DDDB_FileReader: one file per entity (default)  \n"
+    "                        DDDB_ArchiveReader: <input-dir>.pack archive    \n"
+    "                        created by the plugin DDDB_PackArchive          \n"
     "  -param  <file-name>   Preprocessing xml file                          \n"
     "  -input  <file-name>   Directory containing DDDB                       \n"
     "  -config <plugin>      Execute config plugin initializing the helper.  \n"
     "  -match  <string>      Match string for entity resolver e.g.'conddb:'  \n"
+    "  -threads <number>     Number of threads to parse DDDB documents.      \n"
     "  -xml    <file-name>   Parse additional XML files using LCDD.          \n"
     "  -setup  <plugin>      Add setup plugin after dddb parsing.            \n"
     "  -exec   <plugin>      Add execution plugin after setup.               \n"
@@ -80,6 +84,7 @@ static long load_xml_dddb(Geometry::LCDD& lcdd, int argc, char** argv) {
     std::vector<string> setup, xmlFiles, executors, config;
     std::map<std::string, std::vector<char*> > e_args, s_args, c_args;
     long result = 0, visualize = 0, dump = 0;
+    int  num_threads = 1;
     char last = 0, c;
     for(int i=0; i<argc;++i) {
       c = 0;
@@ -125,6 +130,10 @@ static long load_xml_dddb(Geometry::LCDD& lcdd, int argc, char** argv) {
           s_args[setup.back()] = std::vector<char*>();
           last = c;
           break;
+        case 'T':
+          num_threads = ::atol(argv[++i]);
+          last = 0;
+          break;
         case 'V':
           visualize = 1;
           last = 0;
@@ -191,9 +200,9 @@ static long load_xml_dddb(Geometry::LCDD& lcdd, int argc, char** argv) {
     /// Process XML
     if ( !sys_id.empty() )   {
       long long int init_time = makeTime(2016,4,1,12);
-      const void* args[] = {0, sys_id.c_str(), "/", &init_time, 0};
+      const void* args[] = {0, sys_id.c_str(), "/", &init_time, &num_threads, 0};
       printout(INFO,"DDDBExecutor","+++ Processing DDDB: %s", sys_id.c_str());
-      result = lcdd.apply("DDDB_Loader", 4, (char**)args);
+      result = lcdd.apply("DDDB_Loader", 5, (char**)args);
       check_result(result);
       printout(INFO,"DDDBExecutor","                         .... done");
     }
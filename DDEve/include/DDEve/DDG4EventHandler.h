@@ -19,16 +19,43 @@
 // C/C++ include files
 #include <map>
 #include <string>
+#include <vector>
 
 // Forward declarations
 class TTree;
 class TFile;
+class TClass;
 class TBranch;
 
 /// Namespace for the AIDA detector description toolkit
 namespace DD4hep {
 
+  // Forward declarations
+  class DDG4EventPrefetch;
+
+  /// Data objects of one event read from a DDG4 event tree. Owned by the reader.
+  /** 
+   * \author  M.Frank
+   * \version 1.0
+   * \ingroup DD4HEP_EVE
+   */
+  struct DDG4EventData  {
+    typedef std::vector<std::pair<TClass*,void*> > Objects;
+    /// Entry number in the event tree
+    Long64_t entry  = -1;
+    /// Number of bytes read
+    Int_t    nbytes = -1;
+    /// Branch objects in the order of the branch names
+    Objects  objects;
+    /// Delete all data objects
+    void release();
+  };
+
   /** Event I/O handler class for the DD4hep event display
+   *
+   *  The neighbouring events of the current event are read by a background
+   *  thread with its own file handle. Prefetching may be disabled with the
+   *  ROOT environment variable DDEve.Prefetch=0.
    *
    * \author  M.Frank
    * \version 1.0
@@ -52,6 +79,15 @@ namespace DD4hep {
     ParticleAccessor_t m_particleConverter;
     /// Data collection map
     TypedEventCollections m_data;
+    /// Data objects of the current event
+    DDG4EventData m_event;           //!
+    /// Classes of the branch objects in the order of the branch map
+    std::vector<TClass*> m_classes;  //!
+    /// Background reader of the neighbouring events
+    DDG4EventPrefetch* m_prefetch;   //!
+
+    /// Read event data from the event tree (synchronously)
+    Int_t readEntry(Long64_t entry, DDG4EventData& data);
   public:
     /// Standard constructor
     DDG4EventHandler();
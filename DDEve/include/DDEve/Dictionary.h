@@ -33,6 +33,7 @@
 #include "DDEve/EveShapeContextMenu.h"
 #include "DDEve/EvePgonSetProjectedContextMenu.h"
 #include "DDEve/DisplayConfiguration.h"
+#include "DDEve/HitActors.h"
 
 
 #include "DDEve/GenericEventHandler.h"
@@ -93,6 +94,8 @@ namespace DD4hep {
 #pragma link C++ class DD4hep::ElementListContextMenu;
 #pragma link C++ class DD4hep::EveShapeContextMenu;
 #pragma link C++ class DD4hep::EvePgonSetProjectedContextMenu;
+#pragma link C++ class DD4hep::LODPointSet;
+#pragma link C++ class DD4hep::LODBoxSet;
 //#pragma link C++ class DD4hep::;
 
 #endif
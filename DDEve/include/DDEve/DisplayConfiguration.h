@@ -72,6 +72,8 @@ namespace DD4hep {
       float towerH;
       float emax;   // Max energy deposit displayed
       int   type;   // Marker type
+      float voxel;  // Voxel size [cm] of the coarse level of detail
+      int   lod;    // Minimal number of hits to display the coarse level of detail (0: never)
     };
     class Config  {
     public:
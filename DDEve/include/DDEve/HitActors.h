@@ -17,15 +17,92 @@
 #include "DDEve/EventHandler.h"
 #include "DDEve/DisplayConfiguration.h"
 
+// ROOT include files
+#include "TEveBoxSet.h"
+#include "TEvePointSet.h"
+
 // Forward declarations
 class THF2;
 class TEveElement;
-class TEvePointSet;
-class TEveBoxSet;
 
 /// Namespace for the AIDA detector description toolkit
 namespace DD4hep {
 
+  /// Point set with a coarse level of detail for large hit collections.
+  /*
+   *  The hits are aggregated into cubic voxels and one point per voxel is displayed
+   *  at the energy weighted centroid. The full detail is built when the element 
+   *  is selected.
+   *
+   *  \author  M.Frank
+   *  \version 1.0
+   *  \ingroup DD4HEP_EVE
+   */
+  class LODPointSet : public TEvePointSet  {
+  protected:
+    /// Full detail hit data. Released once the full detail is built
+    DDEveHits m_hits;      //!
+    /// Voxel size in cm
+    float     m_voxel;
+    /// Flag if the full detail is displayed
+    bool      m_detailed;
+  public:
+    /// Standard initializing constructor
+    LODPointSet(const char* name, size_t length, float voxel);
+    /// Standard destructor
+    virtual ~LODPointSet();
+    /// Add hit to the full detail data
+    void add(const DDEveHit& hit)  {  m_hits.push_back(hit);  }
+    /// Build the coarse level of detail
+    void BuildCoarse();
+    /// Build the full detail
+    void BuildDetail();
+    /// TEveElement overload: Build the full detail if the element gets selected
+    virtual void SelectElement(Bool_t state)  override;
+    ClassDefOverride(LODPointSet,0);
+  };
+
+  /// Box set with a coarse level of detail for large hit collections.
+  /*
+   *  The hits are aggregated into cubic voxels and one box per voxel is displayed
+   *  at the energy weighted centroid with the sum of the energy deposits.
+   *  The full detail is built when the element is selected.
+   *
+   *  \author  M.Frank
+   *  \version 1.0
+   *  \ingroup DD4HEP_EVE
+   */
+  class LODBoxSet : public TEveBoxSet  {
+  public:
+    /// Definition of the function to add one hit to the box set
+    typedef void (*builder_t)(TEveBoxSet* set, const DDEveHit& hit, float emax, float towerH);
+  protected:
+    /// Full detail hit data. Released once the full detail is built
+    DDEveHits m_hits;      //!
+    /// Function to add one hit to the box set
+    builder_t m_builder;   //!
+    /// Voxel size in cm
+    float     m_voxel;
+    /// Energy scale parameters
+    float     m_emax, m_towerH;
+    /// Flag if the full detail is displayed
+    bool      m_detailed;
+  public:
+    /// Standard initializing constructor
+    LODBoxSet(const char* name, size_t length, float voxel);
+    /// Standard destructor
+    virtual ~LODBoxSet();
+    /// Add hit to the full detail data
+    void add(const DDEveHit& hit)  {  m_hits.push_back(hit);  }
+    /// Build the coarse level of detail
+    void BuildCoarse(builder_t builder, float emax, float towerH);
+    /// Build the full detail
+    void BuildDetail();
+    /// TEveElement overload: Build the full detail if the element gets selected
+    virtual void SelectElement(Bool_t state)  override;
+    ClassDefOverride(LODBoxSet,0);
+  };
+
   /// Fill EtaPhi histograms from a hit collection
   /*
    *  \author  M.Frank
@@ -48,6 +125,7 @@ namespace DD4hep {
    */
   struct PointsetCreator : public DDEveHitActor  {
     TEvePointSet* pointset;
+    LODPointSet*  lod;
     float deposit;
     int count;
     /// Standard initializing constructor
@@ -70,8 +148,14 @@ namespace DD4hep {
    */
   struct BoxsetCreator : public DDEveHitActor  {
     TEveBoxSet* boxset;
+    LODBoxSet*  lod;
+    LODBoxSet::builder_t builder;
     float emax, towerH, deposit;
     int count;
+    /// Add a box for a hit
+    static void addBox(TEveBoxSet* set, const DDEveHit& hit, float emax, float towerH);
+    /// Add a tower for a hit
+    static void addTower(TEveBoxSet* set, const DDEveHit& hit, float emax, float towerH);
     /// Standard initializing constructor
     BoxsetCreator(const std::string& collection, size_t length);
     /// Standard initializing constructor
@@ -93,14 +177,12 @@ namespace DD4hep {
   struct TowersetCreator : public BoxsetCreator  {
     /// Standard initializing constructor
     TowersetCreator(const std::string& collection, size_t length) 
-      : BoxsetCreator(collection,length) {}
+      : BoxsetCreator(collection,length) { builder = addTower; }
     /// Standard initializing constructor
     TowersetCreator(const std::string& collection, size_t length, const DisplayConfiguration::Config& cfg)
-      : BoxsetCreator(collection, length, cfg) {}
+      : BoxsetCreator(collection, length, cfg) { builder = addTower; }
     /// Standard destructor
     virtual ~TowersetCreator() {}
-    /// Action callback of this functor: 
-    virtual void operator()(const DDEveHit& hit);
   };
 
 } /* End namespace DD4hep   */
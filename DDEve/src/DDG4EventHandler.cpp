@@ -18,12 +18,20 @@
 #include "DD4hep/Objects.h"
 #include "DD4hep/Factories.h"
 
+#include "TEnv.h"
+#include "TROOT.h"
 #include "TFile.h"
 #include "TTree.h"
+#include "TClass.h"
 #include "TBranch.h"
+#include "TVirtualCollectionProxy.h"
 
 // C/C++ include files
 #include <stdexcept>
+#include <algorithm>
+#include <condition_variable>
+#include <thread>
+#include <mutex>
 
 using namespace std;
 using namespace DD4hep;
@@ -45,8 +53,189 @@ namespace {
 using namespace DD4hep::Geometry;
 DECLARE_CONSTRUCTOR(DDEve_DDG4EventHandler,_create)
 
+/// Namespace for the AIDA detector description toolkit
+namespace DD4hep {
+
+  /// Background reader of the events next to the currently displayed event
+  /** 
+   *  The reader uses its own file handle and tree. Events are read into
+   *  freshly allocated objects, which are handed over to the event handler.
+   *
+   * \author  M.Frank
+   * \version 1.0
+   * \ingroup DD4HEP_EVE
+   */
+  class DDG4EventPrefetch  {
+    typedef std::map<Long64_t,DDG4EventData> Cache;
+    std::string              m_fileName;
+    std::vector<std::string> m_branchNames;
+    std::vector<TClass*>     m_classes;
+    std::vector<void*>       m_addresses;
+    std::vector<Long64_t>    m_wanted;
+    Cache                    m_cache;
+    std::mutex               m_lock;
+    std::condition_variable  m_cond;
+    Long64_t                 m_busy = -1;
+    bool                     m_stop = false;
+    std::thread              m_thread;
+
+    /// Thread body: read the requested events
+    void run();
+    /// Drop all cached events, which are no longer requested. Requires lock.
+    void trim();
+  public:
+    /// Initializing constructor
+    DDG4EventPrefetch(const std::string& file_name, 
+                      const std::vector<std::string>& branches,
+                      const std::vector<TClass*>& classes);
+    /// Default destructor
+    ~DDG4EventPrefetch();
+    /// Set the events to be prefetched
+    void request(const std::vector<Long64_t>& entries);
+    /// Access prefetched event. Waits if the event is currently read.
+    bool take(Long64_t entry, DDG4EventData& data);
+  };
+}
+
+namespace {
+  /// Read one entry into newly allocated branch objects
+  Int_t read_entry(TTree* tree, const vector<TClass*>& classes, const vector<void**>& addresses,
+                   Long64_t entry, DDG4EventData& data)
+  {
+    data.release();
+    data.entry = entry;
+    for(size_t i=0; i<addresses.size(); ++i)  {
+      void* obj = classes[i] ? classes[i]->New() : 0;
+      *addresses[i] = obj;
+      data.objects.push_back(make_pair(classes[i],obj));
+    }
+    return data.nbytes = tree->GetEntry(entry);
+  }
+}
+
+/// Delete all data objects
+void DDG4EventData::release()   {
+  for(const auto& o : objects)  {
+    TClass* cl = o.first;
+    if ( cl && o.second )  {
+      TVirtualCollectionProxy* proxy = cl->GetCollectionProxy();
+      if ( proxy && proxy->HasPointers() )  {
+        TVirtualCollectionProxy::TPushPop env(proxy, o.second);
+        proxy->Clear("force");
+      }
+      cl->Destructor(o.second);
+    }
+  }
+  objects.clear();
+  entry  = -1;
+  nbytes = -1;
+}
+
+/// Initializing constructor
+DDG4EventPrefetch::DDG4EventPrefetch(const std::string& file_name, 
+                                     const std::vector<std::string>& branches,
+                                     const std::vector<TClass*>& classes)
+  : m_fileName(file_name), m_branchNames(branches), m_classes(classes), m_addresses(branches.size(),0)
+{
+  m_thread = std::thread([this]() { this->run(); });
+}
+
+/// Default destructor
+DDG4EventPrefetch::~DDG4EventPrefetch()   {
+  {
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_stop = true;
+    m_cond.notify_all();
+  }
+  m_thread.join();
+  for(auto& c : m_cache) c.second.release();
+  m_cache.clear();
+}
+
+/// Drop all cached events, which are no longer requested. Requires lock.
+void DDG4EventPrefetch::trim()   {
+  for(Cache::iterator i=m_cache.begin(); i != m_cache.end(); )  {
+    if ( std::find(m_wanted.begin(),m_wanted.end(),(*i).first) == m_wanted.end() )  {
+      (*i).second.release();
+      i = m_cache.erase(i);
+      continue;
+    }
+    ++i;
+  }
+}
+
+/// Set the events to be prefetched
+void DDG4EventPrefetch::request(const std::vector<Long64_t>& entries)   {
+  std::lock_guard<std::mutex> lock(m_lock);
+  m_wanted = entries;
+  trim();
+  m_cond.notify_all();
+}
+
+/// Access prefetched event. Waits if the event is currently read.
+bool DDG4EventPrefetch::take(Long64_t entry, DDG4EventData& data)   {
+  std::unique_lock<std::mutex> lock(m_lock);
+  m_cond.wait(lock, [this,entry]() { return m_busy != entry; });
+  Cache::iterator i = m_cache.find(entry);
+  if ( i != m_cache.end() )  {
+    bool ok = (*i).second.nbytes >= 0;
+    if ( ok )
+      std::swap(data,(*i).second);
+    (*i).second.release();
+    m_cache.erase(i);
+    return ok;
+  }
+  return false;
+}
+
+/// Thread body: read the requested events
+void DDG4EventPrefetch::run()   {
+  TFile* file = TFile::Open(m_fileName.c_str());
+  TTree* tree = (file && !file->IsZombie()) ? (TTree*)file->Get("EVENT") : 0;
+  vector<void**> addresses;
+  if ( !tree )  {
+    printout(ERROR,"DDG4EventPrefetch","+++ Cannot access event tree in %s. Prefetching disabled.",
+             m_fileName.c_str());
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_stop = true;
+  }
+  else  {
+    tree->SetBranchStatus("*",0);
+    for(size_t i=0; i<m_branchNames.size(); ++i)  {
+      tree->SetBranchStatus(m_branchNames[i].c_str(),1);
+      tree->SetBranchAddress(m_branchNames[i].c_str(),&m_addresses[i]);
+      addresses.push_back(&m_addresses[i]);
+    }
+  }
+  std::unique_lock<std::mutex> lock(m_lock);
+  while ( !m_stop )  {
+    Long64_t next = -1;
+    for(Long64_t e : m_wanted)  {
+      if ( m_cache.find(e) == m_cache.end() )  { next = e; break; }
+    }
+    if ( next < 0 )  {
+      m_cond.wait(lock);
+      continue;
+    }
+    m_busy = next;
+    lock.unlock();
+    DDG4EventData data;
+    read_entry(tree, m_classes, addresses, next, data);
+    lock.lock();
+    m_busy = -1;
+    std::swap(m_cache[next], data);
+    trim();
+    m_cond.notify_all();
+  }
+  lock.unlock();
+  if ( file )  {
+    file->Close();
+    delete file;
+  }
+}
+
 /// Standard constructor
-DDG4EventHandler::DDG4EventHandler() : EventHandler(), m_file(0,0), m_entry(-1) {
+DDG4EventHandler::DDG4EventHandler() : EventHandler(), m_file(0,0), m_entry(-1), m_prefetch(0) {
   void* ptr = PluginService::Create<void*>("DDEve_DDG4HitAccess",(const char*)"");
   if ( 0 == ptr )   {
     throw runtime_error("FATAL: Failed to access function pointer from factory DDEve_DDG4HitAccess");
@@ -61,6 +250,9 @@ DDG4EventHandler::DDG4EventHandler() : EventHandler(), m_file(0,0), m_entry(-1)
 
 /// Default destructor
 DDG4EventHandler::~DDG4EventHandler()   {
+  if ( m_prefetch ) delete m_prefetch;
+  m_prefetch = 0;
+  m_event.release();
   if ( m_file.first )  {
     m_file.first->Close();
     delete m_file.first;
@@ -156,6 +348,14 @@ size_t DDG4EventHandler::collectionLoop(const std::string& collection, DDEvePart
   return 0;
 }
 
+/// Read event data from the event tree (synchronously)
+Int_t DDG4EventHandler::readEntry(Long64_t entry, DDG4EventData& data)   {
+  vector<void**> addresses;
+  for(Branches::iterator i=m_branches.begin(); i != m_branches.end(); ++i)
+    addresses.push_back(&(*i).second.second);
+  return read_entry(m_file.second, m_classes, addresses, entry, data);
+}
+
 /// Load the specified event
 Int_t DDG4EventHandler::ReadEvent(Long64_t event_number)   {
   m_data.clear();
@@ -170,17 +370,34 @@ Int_t DDG4EventHandler::ReadEvent(Long64_t event_number)   {
       printout(ERROR,"DDG4EventHandler","+++ nextEvent: Cannot read across Start-of-file! Reading first event:%d.",event_number);
     }
 
-    Int_t nbytes = m_file.second->GetEntry(event_number);
+    DDG4EventData data;
+    bool  prefetched = m_prefetch && m_prefetch->take(event_number, data);
+    Int_t nbytes = prefetched ? data.nbytes : readEntry(event_number, data);
     if ( nbytes >= 0 )   {
-      printout(ERROR,"DDG4EventHandler","+++ ReadEvent: Read %d bytes of event data for entry:%d",nbytes,event_number);
-      for(Branches::const_iterator i=m_branches.begin(); i != m_branches.end(); ++i)  {
+      printout(ERROR,"DDG4EventHandler","+++ ReadEvent: Read %d bytes of event data for entry:%d%s",
+               nbytes,event_number,prefetched ? " [prefetched]" : "");
+      std::swap(m_event, data);
+      data.release();
+      size_t idx = 0;
+      for(Branches::iterator i=m_branches.begin(); i != m_branches.end(); ++i, ++idx)  {
         TBranch* b = (*i).second.first;
+        (*i).second.second = m_event.objects[idx].second;
         std::vector<void*>* ptr_data = *(std::vector<void*>**)b->GetAddress();
-        m_data[b->GetClassName()].push_back(make_pair(b->GetName(),ptr_data->size()));
+        m_data[b->GetClassName()].push_back(make_pair(b->GetName(),ptr_data ? ptr_data->size() : 0));
       }
       m_hasEvent = true;
+      if ( m_prefetch )  {
+        vector<Long64_t> next;
+        if ( event_number+1 < m_file.second->GetEntries() ) next.push_back(event_number+1);
+        if ( event_number > 0 ) next.push_back(event_number-1);
+        m_prefetch->request(next);
+      }
       return nbytes;
     }
+    size_t idx = 0;
+    for(Branches::iterator i=m_branches.begin(); i != m_branches.end(); ++i, ++idx)
+      (*i).second.second = idx < m_event.objects.size() ? m_event.objects[idx].second : 0;
+    data.release();
     printout(ERROR,"DDG4EventHandler","+++ ReadEvent: Cannot read event data for entry:%d",event_number);
     throw runtime_error("+++ EventHandler::readEvent: Failed to read event");
   }
@@ -189,6 +406,10 @@ Int_t DDG4EventHandler::ReadEvent(Long64_t event_number)   {
 
 /// Open new data file
 bool DDG4EventHandler::Open(const std::string&, const std::string& name)   {
+  if ( m_prefetch ) delete m_prefetch;
+  m_prefetch = 0;
+  m_event.release();
+  m_classes.clear();
   if ( m_file.first ) m_file.first->Close();
   m_hasFile = false;
   m_hasEvent = false;
@@ -212,6 +433,15 @@ bool DDG4EventHandler::Open(const std::string&, const std::string& name)   {
         if ( !b ) continue;
         b->SetAddress(&m_branches[b->GetName()].second);
       }
+      vector<string> names;
+      for(Branches::const_iterator i=m_branches.begin(); i != m_branches.end(); ++i)  {
+        names.push_back((*i).first);
+        m_classes.push_back(TClass::GetClass((*i).second.first->GetClassName()));
+      }
+      if ( gEnv->GetValue("DDEve.Prefetch",1) )  {
+        ROOT::EnableThreadSafety();
+        m_prefetch = new DDG4EventPrefetch(name, names, m_classes);
+      }
       m_hasFile = true;
       return true;
     }
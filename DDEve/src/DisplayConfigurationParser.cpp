@@ -76,6 +76,8 @@ namespace {
   DECL_TAG(phi_max);
   DECL_TAG(calodata);
   DECL_TAG(towerH);
+  DECL_TAG(voxel);
+  DECL_TAG(lod);
   DECL_TAG(visLevel);
   DECL_TAG(loadLevel);
 }
@@ -133,6 +135,8 @@ template <> void Converter<collection_configs>::operator()(xml_h e)  const  {
   c.data.hits.emax      = e.hasAttr(u_emax) ? e.attr<float>(u_emax) : 25.0;
   c.data.hits.towerH    = e.hasAttr(u_towerH) ? e.attr<float>(u_towerH) : 25.0;
   c.data.hits.threshold = e.hasAttr(_U(threshold)) ? e.attr<float>(_U(threshold)) : 0.0;
+  c.data.hits.voxel     = e.hasAttr(u_voxel) ? e.attr<float>(u_voxel) : 1.0;
+  c.data.hits.lod       = e.hasAttr(u_lod) ? e.attr<int>(u_lod) : 50000;
   if ( e.hasAttr(u_hits)   ) c.hits = e.attr<string>(u_hits);
   if ( e.hasAttr(u_use)    ) c.use = e.attr<string>(u_use);
   configs->push_back(c);
@@ -230,6 +234,8 @@ template <> void Converter<collection>::operator()(xml_h e)  const  {
   c.data.hits.emax    = e.hasAttr(u_emax)   ? e.attr<float>(u_emax)    : 25.0;
   c.data.hits.towerH  = e.hasAttr(u_towerH) ? e.attr<float>(u_towerH)  : 25.0;
   c.data.hits.threshold = e.hasAttr(_U(threshold)) ? e.attr<float>(_U(threshold)) : 0;
+  c.data.hits.voxel   = e.hasAttr(u_voxel)  ? e.attr<float>(u_voxel)   : 1.0;
+  c.data.hits.lod     = e.hasAttr(u_lod)    ? e.attr<int>(u_lod)       : 50000;
   configs->push_back(c);
 }
 
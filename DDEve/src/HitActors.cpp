@@ -23,9 +23,137 @@
 #include "TEvePointSet.h"
 #include "TEveCompound.h"
 
+// C/C++ include files
+#include <cmath>
+#include <unordered_map>
+
 using namespace std;
 using namespace DD4hep;
 
+ClassImp(LODPointSet)
+ClassImp(LODBoxSet)
+
+namespace {
+  /// Default number of hits above which the coarse level of detail is displayed
+  const size_t DEFAULT_LOD_HITS  = 50000;
+  /// Default voxel size in cm of the coarse level of detail
+  const float  DEFAULT_LOD_VOXEL = 1.0;
+
+  /// Aggregate hits into cubic voxels of the given size [cm]
+  DDEveHits aggregate_hits(const DDEveHits& hits, float voxel)   {
+    struct Voxel  { double e = 0, ex = 0, ey = 0, ez = 0, x = 0, y = 0, z = 0; long n = 0; };
+    unordered_map<long long,Voxel> voxels;
+    double scale = MM_2_CM/(voxel > 0 ? voxel : DEFAULT_LOD_VOXEL);
+    voxels.reserve(hits.size()/8+1);
+    for(const DDEveHit& h : hits)  {
+      long long ix = (long long)std::floor(h.x*scale) & 0x1FFFFF;
+      long long iy = (long long)std::floor(h.y*scale) & 0x1FFFFF;
+      long long iz = (long long)std::floor(h.z*scale) & 0x1FFFFF;
+      Voxel& v = voxels[(ix<<42)|(iy<<21)|iz];
+      v.e  += h.deposit;
+      v.ex += h.deposit*h.x;
+      v.ey += h.deposit*h.y;
+      v.ez += h.deposit*h.z;
+      v.x  += h.x;
+      v.y  += h.y;
+      v.z  += h.z;
+      ++v.n;
+    }
+    DDEveHits result;
+    result.reserve(voxels.size());
+    for(const auto& i : voxels)  {
+      const Voxel& v = i.second;
+      if ( v.e > 0 )
+        result.push_back(DDEveHit(-1, v.ex/v.e, v.ey/v.e, v.ez/v.e, v.e));
+      else
+        result.push_back(DDEveHit(-1, v.x/v.n, v.y/v.n, v.z/v.n, v.e));
+    }
+    return result;
+  }
+}
+
+/// Standard initializing constructor
+LODPointSet::LODPointSet(const char* nam, size_t length, float voxel)
+  : TEvePointSet(nam), m_voxel(voxel), m_detailed(false)
+{
+  m_hits.reserve(length);
+}
+
+/// Standard destructor
+LODPointSet::~LODPointSet()   {
+}
+
+/// Build the coarse level of detail
+void LODPointSet::BuildCoarse()   {
+  DDEveHits coarse = aggregate_hits(m_hits, m_voxel);
+  int count = 0;
+  Reset(coarse.size());
+  for(const DDEveHit& h : coarse)
+    SetPoint(count++, h.x*MM_2_CM, h.y*MM_2_CM, h.z*MM_2_CM);
+  m_detailed = false;
+}
+
+/// Build the full detail
+void LODPointSet::BuildDetail()   {
+  int count = 0;
+  Reset(m_hits.size());
+  for(const DDEveHit& h : m_hits)
+    SetPoint(count++, h.x*MM_2_CM, h.y*MM_2_CM, h.z*MM_2_CM);
+  m_detailed = true;
+  DDEveHits().swap(m_hits);
+  ComputeBBox();
+  ElementChanged();
+}
+
+/// TEveElement overload: Build the full detail if the element gets selected
+void LODPointSet::SelectElement(Bool_t state)   {
+  if ( state && !m_detailed ) BuildDetail();
+  TEvePointSet::SelectElement(state);
+}
+
+/// Standard initializing constructor
+LODBoxSet::LODBoxSet(const char* nam, size_t length, float voxel)
+  : TEveBoxSet(nam), m_builder(0), m_voxel(voxel), m_emax(1e12), m_towerH(1e12), m_detailed(false)
+{
+  m_hits.reserve(length);
+}
+
+/// Standard destructor
+LODBoxSet::~LODBoxSet()   {
+}
+
+/// Build the coarse level of detail
+void LODBoxSet::BuildCoarse(builder_t builder, float emax, float towerH)   {
+  DDEveHits coarse = aggregate_hits(m_hits, m_voxel);
+  m_builder = builder;
+  m_emax    = emax;
+  m_towerH  = towerH;
+  Reset(TEveBoxSet::kBT_FreeBox, kFALSE, 64);
+  for(const DDEveHit& h : coarse)
+    (*m_builder)(this, h, m_emax, m_towerH);
+  m_detailed = false;
+}
+
+/// Build the full detail
+void LODBoxSet::BuildDetail()   {
+  if ( m_builder )  {
+    Reset(TEveBoxSet::kBT_FreeBox, kFALSE, 64);
+    for(const DDEveHit& h : m_hits)
+      (*m_builder)(this, h, m_emax, m_towerH);
+    m_detailed = true;
+    DDEveHits().swap(m_hits);
+    RefitPlex();
+    ComputeBBox();
+    ElementChanged();
+  }
+}
+
+/// TEveElement overload: Build the full detail if the element gets selected
+void LODBoxSet::SelectElement(Bool_t state)   {
+  if ( state && !m_detailed ) BuildDetail();
+  TEveBoxSet::SelectElement(state);
+}
+
 
 /// Action callback of this functor: 
 void EtaPhiHistogramActor::operator()(const DDEveHit& hit)   {
@@ -35,17 +163,23 @@ void EtaPhiHistogramActor::operator()(const DDEveHit& hit)   {
 
 /// Standard initializing constructor
 PointsetCreator::PointsetCreator(const std::string& collection, size_t length) 
-  : pointset(0), deposit(0), count(0) 
+  : pointset(0), lod(0), deposit(0), count(0) 
 {
-  pointset = new TEvePointSet(collection.c_str(),length);
+  if ( length >= DEFAULT_LOD_HITS )
+    pointset = lod = new LODPointSet(collection.c_str(),length,DEFAULT_LOD_VOXEL);
+  else
+    pointset = new TEvePointSet(collection.c_str(),length);
   pointset->SetMarkerSize(0.2);
 }
 
 /// Standard initializing constructor
 PointsetCreator::PointsetCreator(const std::string& collection, size_t length, const DisplayConfiguration::Config& cfg) 
-  : pointset(0), deposit(0), count(0) 
+  : pointset(0), lod(0), deposit(0), count(0) 
 {
-  pointset = new TEvePointSet(collection.c_str(),length);
+  if ( cfg.data.hits.lod > 0 && length >= size_t(cfg.data.hits.lod) )
+    pointset = lod = new LODPointSet(collection.c_str(),length,cfg.data.hits.voxel);
+  else
+    pointset = new TEvePointSet(collection.c_str(),length);
   pointset->SetMarkerSize(cfg.data.hits.size);
   pointset->SetMarkerStyle(cfg.data.hits.type);
   //pointset->SetMarkerAlpha(cfg.data.hits.alpha);
@@ -53,6 +187,7 @@ PointsetCreator::PointsetCreator(const std::string& collection, size_t length, c
 }
 /// Return eve element
 TEveElement* PointsetCreator::element() const   {
+  if ( lod ) lod->BuildCoarse();
   return pointset;
 }
 
@@ -62,23 +197,32 @@ PointsetCreator::~PointsetCreator()   {
     pointset->SetTitle(Form("Hit collection:\n"
                             "Container%s\n"
                             "with %d hits\n"
-                            "total deposit:%.3f GeV",
-                            pointset->GetName(), count, deposit));
+                            "total deposit:%.3f GeV%s",
+                            pointset->GetName(), count, deposit,
+                            lod ? "\n[Select to display all hits]" : ""));
   }
 }
 
 /// Action callback of this functor: 
 void PointsetCreator::operator()(const DDEveHit& hit)   {
+  if ( lod )  {
+    lod->add(hit);
+    ++count;
+    return;
+  }
   pointset->SetPoint(count++, hit.x*MM_2_CM, hit.y*MM_2_CM, hit.z*MM_2_CM); 
 }
 
 /// Standard initializing constructor
-BoxsetCreator::BoxsetCreator(const std::string& collection, size_t /*length */, const DisplayConfiguration::Config& cfg)
-  : boxset(0), emax(1e12), towerH(1e12), deposit(0.0), count(0)
+BoxsetCreator::BoxsetCreator(const std::string& collection, size_t length, const DisplayConfiguration::Config& cfg)
+  : boxset(0), lod(0), builder(addBox), emax(1e12), towerH(1e12), deposit(0.0), count(0)
 {
   emax   = cfg.data.hits.emax;
   towerH = cfg.data.hits.towerH;
-  boxset = new TEveBoxSet(collection.c_str());
+  if ( cfg.data.hits.lod > 0 && length >= size_t(cfg.data.hits.lod) )
+    boxset = lod = new LODBoxSet(collection.c_str(),length,cfg.data.hits.voxel);
+  else
+    boxset = new TEveBoxSet(collection.c_str());
   boxset->Reset(TEveBoxSet::kBT_FreeBox, kFALSE, 64);
   boxset->SetMainTransparency(0);
   boxset->SetMainColor(cfg.data.hits.color);
@@ -88,10 +232,13 @@ BoxsetCreator::BoxsetCreator(const std::string& collection, size_t /*length */,
 }
 
 /// Standard initializing constructor
-BoxsetCreator::BoxsetCreator(const std::string& collection, size_t /*length */)
-  : boxset(0), emax(1e12), towerH(1e12), deposit(0.0), count(0)
+BoxsetCreator::BoxsetCreator(const std::string& collection, size_t length)
+  : boxset(0), lod(0), builder(addBox), emax(1e12), towerH(1e12), deposit(0.0), count(0)
 {
-  boxset = new TEveBoxSet(collection.c_str());
+  if ( length >= DEFAULT_LOD_HITS )
+    boxset = lod = new LODBoxSet(collection.c_str(),length,DEFAULT_LOD_VOXEL);
+  else
+    boxset = new TEveBoxSet(collection.c_str());
   boxset->SetMainTransparency(0);
   boxset->Reset(TEveBoxSet::kBT_FreeBox, kFALSE, 64);
   boxset->CSCApplyMainColorToAllChildren();
@@ -104,21 +251,32 @@ BoxsetCreator::~BoxsetCreator()  {
     boxset->SetTitle(Form("Hit collection:\n"
                           "Container%s\n"
                           "with %d hits\n"
-                          "total deposit:%.3f GeV",
-                          boxset->GetName(), count, deposit));
+                          "total deposit:%.3f GeV%s",
+                          boxset->GetName(), count, deposit,
+                          lod ? "\n[Select to display all hits]" : ""));
   }
 }
 
 /// Return eve element
 TEveElement* BoxsetCreator::element() const   {
+  if ( lod ) lod->BuildCoarse(builder, emax, towerH);
   return boxset;
 }
 
 /// Action callback of this functor: 
 void BoxsetCreator::operator()(const DDEveHit& hit)   {
+  ++count;
+  deposit += hit.deposit*MEV_2_GEV;
+  if ( lod )
+    lod->add(hit);
+  else
+    (*builder)(boxset, hit, emax, towerH);
+}
+
+/// Add a box for a hit
+void BoxsetCreator::addBox(TEveBoxSet* set, const DDEveHit& hit, float emax, float towerH)   {
   double ene = hit.deposit*MEV_2_GEV <= emax ? hit.deposit*MEV_2_GEV : emax;
   TVector3 scale(ene/towerH,ene/towerH,ene/towerH);
-  cout << "Hit:" << ene << " deposit:" << hit.deposit << " " << " emax:" << emax << " towerH:" << towerH << endl;
   TVector3 p(hit.x*MM_2_CM, hit.y*MM_2_CM, hit.z*MM_2_CM);
   double phi = p.Phi();
   float s1X = -0.5*(scale(0)*std::sin(phi)+scale(2)*std::cos(phi));
@@ -135,14 +293,12 @@ void BoxsetCreator::operator()(const DDEveHit& hit)   {
                       float(p.X()+s2X), float(p.Y()+s2Y), float(p.Z()+s2Z),
                       float(p.X()-s1X), float(p.Y()-s1Y), float(p.Z()+s1Z),
                       float(p.X()-s1X), float(p.Y()-s1Y), float(p.Z()-s1Z) };
-  ++count;
-  deposit += hit.deposit*MEV_2_GEV;
-  boxset->AddBox(coords);
-  boxset->DigitColor(boxset->GetMainColor());
+  set->AddBox(coords);
+  set->DigitColor(set->GetMainColor());
 }
 
-/// Action callback of this functor: 
-void TowersetCreator::operator()(const DDEveHit& hit)   {
+/// Add a tower for a hit
+void BoxsetCreator::addTower(TEveBoxSet* set, const DDEveHit& hit, float emax, float towerH)   {
   double ene = hit.deposit*MEV_2_GEV <= emax ? hit.deposit*MEV_2_GEV : emax;
   TVector3 scale(1,1,ene/towerH);
   TVector3 p(hit.x*MM_2_CM, hit.y*MM_2_CM, hit.z*MM_2_CM);
@@ -162,8 +318,6 @@ void TowersetCreator::operator()(const DDEveHit& hit)   {
                       float(p.X()+s2X), float(p.Y()+s2Y), float(p.Z()+s2Z),
                       float(p.X()-s1X), float(p.Y()-s1Y), float(p.Z()+s1Z),
                       float(p.X()-s1X), float(p.Y()-s1Y), float(p.Z()-s1Z) };
-  ++count;
-  deposit += hit.deposit*MEV_2_GEV;
-  boxset->AddBox(coords);
-  boxset->DigitColor(boxset->GetMainColor());
+  set->AddBox(coords);
+  set->DigitColor(set->GetMainColor());
 }
@@ -16,8 +16,10 @@
 // Framework include files
 #include "DD4hep/Exceptions.h"
 #include "DDG4/Geant4Action.h"
+#include "DDG4/Geant4ActionStatistics.h"
 
 // C/C++ include files
+#include <map>
 #include <vector>
 
 /// Namespace for the AIDA detector description toolkit
@@ -61,6 +63,12 @@ namespace DD4hep {
 
     /// Action phase definition. Client callback at various stage of the simulation processing
     /**
+     *  If the property "Instrument" is set, the calls and the execution time of
+     *  every phase member are recorded. With "SamplingPeriod" N only every N-th
+     *  execution of the phase is timed. The counters are reset at the beginning of
+     *  each run. The table is printed at the end of each run and the property
+     *  "Statistics" is updated with the same content.
+     *
      *  \author  M.Frank
      *  \version 1.0
      *  \ingroup DD4HEP_SIMULATION
@@ -73,6 +81,17 @@ namespace DD4hep {
       Members m_members;
       /// Type information of the argument type of the callback
       const std::type_info* m_argTypes[3];
+      /// Call counters and timing of the phase members
+      Geant4ActionStatistics m_statistics;
+      /// Property: Record calls and timing of the phase members
+      bool m_instrument = false;
+      /// Property: Time only every n-th execution of the phase
+      int  m_samplingPeriod = 1;
+      /// Property: Statistics of the phase members (output only)
+      std::map<std::string,std::string> m_statisticsValues;
+
+      /// Execute all members and record the call counters and timing
+      void executeInstrumented(void* argument);
 
     public:
       /// Standard constructor
@@ -90,6 +109,10 @@ namespace DD4hep {
       }
       /// Execute all members in the phase context
       void execute(void* argument);
+      /// Reset the statistics of the phase members
+      void resetStatistics();
+      /// Print the statistics of the phase members and update the "Statistics" property
+      void printStatistics();
       /// Add a new member to the phase
       virtual bool add(Geant4Action* action, Callback callback);
       /// Remove an existing member from the phase. If not existing returns false
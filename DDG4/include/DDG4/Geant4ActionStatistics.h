@@ -0,0 +1,152 @@
+//==========================================================================
+//  AIDA Detector description implementation for LCD
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Frank
+//
+//==========================================================================
+#ifndef DD4HEP_DDG4_GEANT4ACTIONSTATISTICS_H
+#define DD4HEP_DDG4_GEANT4ACTIONSTATISTICS_H
+
+// C/C++ include files
+#include <map>
+#include <string>
+#include <vector>
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/// Namespace for the AIDA detector description toolkit
+namespace DD4hep {
+
+  /// Namespace for the Geant4 based simulation part of the AIDA detector description toolkit
+  namespace Simulation {
+
+    // Forward declarations
+    class Geant4Action;
+
+    /// Call counters and timing of the members of action sequences and phases
+    /**
+     *  Helper for the optional instrumentation of Geant4ActionPhase,
+     *  Geant4SteppingActionSequence and Geant4SensDetActionSequence.
+     *  Every dispatch of the owner increments the call counters of its members.
+     *  With a sampling period N only every N-th dispatch is timed; the total
+     *  time is extrapolated from the mean of the timed calls.
+     *
+     *  Time is measured in ticks of the time stamp counter (x86) or of the
+     *  steady clock. The ticks are converted to seconds using the steady
+     *  clock interval since the last reset, hence no calibration loop is needed.
+     *
+     *  The statistics object is not protected against concurrent access:
+     *  sequences exist once per worker thread and so does their statistics.
+     *
+     *  \author  M.Frank
+     *  \version 1.0
+     *  \ingroup DD4HEP_SIMULATION
+     */
+    class Geant4ActionStatistics {
+    public:
+      typedef unsigned long long ticks_t;
+      typedef std::chrono::steady_clock clock_type;
+
+      /// Counters of one member of the instrumented sequence
+      class Entry {
+      public:
+        /// Member name
+        std::string        name;
+        /// Number of calls
+        unsigned long long calls = 0;
+        /// Number of timed calls
+        unsigned long long timed = 0;
+        /// Number of hits (sensitive actions: successful process calls)
+        unsigned long long hits  = 0;
+        /// Accumulated ticks of the timed calls
+        ticks_t            ticks = 0;
+      };
+      typedef std::vector<Entry> Entries;
+
+    protected:
+      /// Per member counters
+      Entries            m_entries;
+      /// Number of dispatches of the owner
+      unsigned long long m_dispatches = 0;
+      /// Sampling period: time every n-th dispatch
+      unsigned long      m_period = 1;
+      /// Tick counter at the last reset for the conversion to seconds
+      ticks_t            m_startTicks = 0;
+      /// Steady clock at the last reset for the conversion to seconds
+      clock_type::time_point m_startTime;
+
+    public:
+      /// Default constructor
+      Geant4ActionStatistics();
+      /// Default destructor
+      ~Geant4ActionStatistics() = default;
+      /// Current value of the tick counter
+      static ticks_t ticks()  {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now().time_since_epoch()).count();
+#endif
+      }
+      /// Set the sampling period. Values below 1 are treated as 1
+      void setSamplingPeriod(int period)  {
+        m_period = period > 1 ? period : 1;
+      }
+      /// Access to the member counters
+      const Entries& entries() const  {
+        return m_entries;
+      }
+      /// Number of entries
+      size_t size() const  {
+        return m_entries.size();
+      }
+      /// Access member counters by index
+      Entry& operator[](size_t which)  {
+        return m_entries[which];
+      }
+      /// (Re-)define the member names. Existing counters are dropped if the names differ.
+      void define(const std::vector<std::string>& names);
+      /// Drop all members and counters
+      void clear();
+      /// Reset all counters, but keep the member names
+      void reset();
+      /// Count a dispatch of the owner. Returns true if this dispatch should be timed
+      bool dispatch()  {
+        return (m_dispatches++ % m_period) == 0;
+      }
+      /// Count an untimed call of a member
+      void count(size_t which)  {
+        ++m_entries[which].calls;
+      }
+      /// Count a timed call of a member, which started at 'start'. Returns the current tick count
+      ticks_t record(size_t which, ticks_t start)  {
+        Entry&  e   = m_entries[which];
+        ticks_t now = ticks();
+        e.ticks += now - start;
+        ++e.timed;
+        ++e.calls;
+        return now;
+      }
+      /// Count a hit produced by a member
+      void hit(size_t which)  {
+        ++m_entries[which].hits;
+      }
+      /// Seconds per tick estimated from the steady clock since the last reset
+      double secondsPerTick() const;
+      /// Print the statistics table using the output level of the owner
+      void print(const Geant4Action* owner) const;
+      /// Export the statistics as name -> "calls:... total[s]:... mean[s]:... hits:..."
+      void publish(std::map<std::string,std::string>& values) const;
+    };
+  }    // End namespace Simulation
+}      // End namespace DD4hep
+
+#endif // DD4HEP_DDG4_GEANT4ACTIONSTATISTICS_H
@@ -242,6 +242,12 @@ namespace DD4hep {
       /// Create identified worker instance
       virtual Geant4Kernel& createWorker();
       /// Access worker instance by it's identifier
+      /** The worker of the calling thread is published in thread local storage
+       *  by createWorker. Lookups of the own worker do not lock.
+       *  In sequential mode the master instance serves the calling thread.
+       *  Unknown workers are only created in multi-threaded mode and only
+       *  if create_if is set. Otherwise an exception is thrown.
+       */
       Geant4Kernel& worker(unsigned long thread_identifier, bool create_if=false);
       /// Access number of workers
       int numWorkers() const;
@@ -19,6 +19,7 @@
 #include "DD4hep/LCDD.h"
 #include "DDG4/Geant4Action.h"
 #include "DDG4/Geant4HitCollection.h"
+#include "DDG4/Geant4ActionStatistics.h"
 
 // C/C++ include files
 #include <vector>
@@ -26,7 +27,9 @@
 // Forward declarations
 class G4HCofThisEvent;
 class G4Step;
+class G4Run;
 class G4Event;
+class G4ParticleDefinition;
 class G4TouchableHistory;
 class G4VHitsCollection;
 class G4VReadOutGeometry;
@@ -50,6 +53,7 @@ namespace DD4hep {
     class Geant4Sensitive;
     class Geant4SensDetActionSequence;
     class Geant4SensDetSequences;
+    class Geant4Filter;
 
     /// Interface class to access properties of the underlying Geant4 sensitive detector structure
     /**
@@ -85,6 +89,89 @@ namespace DD4hep {
       virtual const std::string& sensitiveType() const = 0;
     };
 
+    /// Compact description of the selection criteria of sensitive detector filters
+    /**
+     *  Filters expressing their selection with these criteria are fused
+     *  by the Geant4FilterChain into one single check. All criteria 
+     *  are combined with a logical AND.
+     *
+     *  \author  M.Frank
+     *  \version 1.0
+     *  \ingroup DD4HEP_SIMULATION
+     */
+    class Geant4FilterCuts {
+    public:
+      typedef std::vector<const G4ParticleDefinition*> Particles;
+      enum Charge { ANY_CHARGE = 0, CHARGED = 1, NEUTRAL = 2 };
+      enum Checks {
+        CHECK_NONE      = 0,
+        CHECK_SELECT    = 1<<0,
+        CHECK_REJECT    = 1<<1,
+        CHECK_CHARGE    = 1<<2,
+        CHECK_ENERGY    = 1<<3,
+        CHECK_PARTICLE  = CHECK_SELECT|CHECK_REJECT|CHECK_CHARGE
+      };
+      /// Accepted particle types if CHECK_SELECT is set
+      Particles    selected;
+      /// Rejected particle types
+      Particles    rejected;
+      /// Minimal energy deposit of the step (exclusive)
+      double       energyCut = 0e0;
+      /// Charge requirement
+      int          charge    = ANY_CHARGE;
+      /// Bit mask of the checks to be performed
+      unsigned int checks    = CHECK_NONE;
+
+    public:
+      /// Accept only particles of the given type
+      void selectParticle(const G4ParticleDefinition* def);
+      /// Accept only particles of one of the given types
+      void selectParticles(const Particles& defs);
+      /// Reject particles of the given type
+      void rejectParticle(const G4ParticleDefinition* def);
+      /// Require charged or neutral particles
+      void requireCharge(Charge which);
+      /// Require an energy deposit above the given value
+      void minimumEnergyDeposit(double cut);
+    };
+
+    /// Fused evaluation of a sequence of sensitive detector filters
+    /**
+     *  The chain is compiled from a list of filters: the criteria of all filters
+     *  implementing Geant4Filter::describe are merged into one single check.
+     *  All other filters are called afterwards in their original order.
+     *  An empty or not compiled chain accepts all steps.
+     *
+     *  \author  M.Frank
+     *  \version 1.0
+     *  \ingroup DD4HEP_SIMULATION
+     */
+    class Geant4FilterChain {
+    protected:
+      /// Fused criteria of the describable filters
+      Geant4FilterCuts                 m_cuts;
+      /// Filters, which could not be fused
+      std::vector<const Geant4Filter*> m_residual;
+      /// Flag if the chain is compiled
+      bool                             m_compiled = false;
+
+    public:
+      /// Default constructor
+      Geant4FilterChain() = default;
+      /// Compile the filter chain
+      void compile(const std::vector<Geant4Filter*>& filters);
+      /// Invalidate the compiled chain
+      void reset()                {  m_compiled = false; m_residual.clear(); m_cuts = Geant4FilterCuts(); }
+      /// Check if the chain was compiled
+      bool isCompiled() const     {  return m_compiled;     }
+      /// Access the fused filter criteria
+      const Geant4FilterCuts& cuts() const  {  return m_cuts;  }
+      /// Number of filters, which could not be fused
+      size_t numResidual() const  {  return m_residual.size();  }
+      /// Apply the compiled chain. Return true if hits should be processed
+      bool operator()(const G4Step* step) const;
+    };
+
     /// Base class to construct filters for Geant4 sensitive detectors
     /**
      *  \author  M.Frank
@@ -109,6 +196,11 @@ namespace DD4hep {
       virtual ~Geant4Filter();
       /// Filter action. Return true if hits should be processed
       virtual bool operator()(const G4Step* step) const;
+      /// Describe the filter criteria for fused evaluation.
+      /** Return false if the filter cannot be expressed by the cuts (default).
+       *  Then the filter action is called for each step.
+       */
+      virtual bool describe(Geant4FilterCuts& cuts) const;
     };
 
     /// The base class for Geant4 sensitive detector actions implemented by users
@@ -156,6 +248,8 @@ namespace DD4hep {
       Segmentation m_segmentation;
       /// The list of sensitive detector filter objects
       Actors<Geant4Filter> m_filters;
+      /// Fused filter chain compiled at the begin of the run
+      Geant4FilterChain    m_filterChain;
 
       /// Protect the default constructor
       Geant4Sensitive() = default;
@@ -240,6 +334,9 @@ namespace DD4hep {
        */
       bool accept(const G4Step* step) const;
 
+      /// Compile the filters into a fused filter chain
+      void compileFilters();
+
       /// Initialize the usage of a single hit collection. Returns the collection ID
       template <typename TYPE> size_t defineCollection(const std::string& coll_name);
 
@@ -294,6 +391,13 @@ namespace DD4hep {
     /**
      * Concrete implementation of the sensitive detector action sequence
      *
+     * If the property "Instrument" is set, the calls, the execution time
+     * including the filters and the number of hits (successful calls to
+     * Geant4Sensitive::process) of every sensitive action are recorded.
+     * With "SamplingPeriod" N only every N-th step is timed. The counters are
+     * reset at the beginning of each run. The table is printed at the end of
+     * each run and copied to the property "Statistics".
+     *
      *  \author  M.Frank
      *  \version 1.0
      *  \ingroup DD4HEP_SIMULATION
@@ -321,6 +425,18 @@ namespace DD4hep {
       Actors<Geant4Sensitive> m_actors;
       /// The list of sensitive detector filter objects
       Actors<Geant4Filter>    m_filters;
+      /// Fused filter chain compiled at the begin of the run
+      Geant4FilterChain       m_filterChain;
+      /// Property: Fuse the filters at the begin of the run
+      bool                    m_fuseFilters = true;
+      /// Call counters, timing and hits of the sensitive actions
+      Geant4ActionStatistics  m_statistics;
+      /// Property: Record calls, timing and hits of the sensitive actions
+      bool                    m_instrument = false;
+      /// Property: Time only every n-th step
+      int                     m_samplingPeriod = 1;
+      /// Property: Statistics of the sensitive actions (output only)
+      std::map<std::string,std::string> m_statisticsValues;
 
       /// Hit collection creators
       HitCollections m_collections;
@@ -336,6 +452,9 @@ namespace DD4hep {
         return new Geant4HitCollection(det, coll, sd, (TYPE*) 0);
       }
 
+      /// Hit processing recording the call counters, timing and hits
+      bool processInstrumented(G4Step* step, G4TouchableHistory* hist);
+
     protected:
       /// Protect the default constructor
       Geant4SensDetActionSequence() = default;
@@ -415,6 +534,12 @@ namespace DD4hep {
        */
       bool accept(const G4Step* step) const;
 
+      /// Begin-of-run callback: compile the filter chains and reset the statistics
+      virtual void beginRun(const G4Run* run);
+
+      /// End-of-run callback: print the statistics if instrumented
+      virtual void endRun(const G4Run* run);
+
       /// Function to process hits
       virtual bool process(G4Step* step, G4TouchableHistory* hist);
 
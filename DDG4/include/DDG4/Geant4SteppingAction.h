@@ -15,10 +15,12 @@
 
 // Framework include files
 #include "DDG4/Geant4Action.h"
+#include "DDG4/Geant4ActionStatistics.h"
 
 // Forward declarations
 class G4SteppingManager;
 class G4Step;
+class G4Run;
 
 /// Namespace for the AIDA detector description toolkit
 namespace DD4hep {
@@ -98,6 +100,12 @@ namespace DD4hep {
      * threads calling the Geant4 callbacks!
      * These must be protected in the user actions themselves.
      *
+     * If the property "Instrument" is set, the calls and the execution time
+     * of every member are recorded. The registered callbacks are accounted
+     * together. With "SamplingPeriod" N only every N-th step is timed.
+     * The counters are reset at the beginning of each run. The table is
+     * printed at the end of each run and copied to the property "Statistics".
+     *
      *  \author  M.Frank
      *  \version 1.0
      *  \ingroup DD4HEP_SIMULATION
@@ -108,6 +116,17 @@ namespace DD4hep {
       CallbackSequence m_calls;
       /// The list of action objects to be called
       Actors<Geant4SteppingAction> m_actors;
+      /// Call counters and timing of the sequence members
+      Geant4ActionStatistics m_statistics;
+      /// Property: Record calls and timing of the sequence members
+      bool m_instrument = false;
+      /// Property: Time only every n-th step
+      int  m_samplingPeriod = 1;
+      /// Property: Statistics of the sequence members (output only)
+      std::map<std::string,std::string> m_statisticsValues;
+
+      /// Stepping callback recording the call counters and timing
+      void stepInstrumented(const G4Step* step, G4SteppingManager* mgr);
 
     public:
       /// Inhibit copy constructor
@@ -131,6 +150,10 @@ namespace DD4hep {
       void adopt(Geant4SteppingAction* action);
       /// User stepping callback
       virtual void operator()(const G4Step* step, G4SteppingManager* mgr);
+      /// Begin-of-run callback: reset the statistics
+      virtual void beginRun(const G4Run* run);
+      /// End-of-run callback: print the statistics if instrumented
+      virtual void endRun(const G4Run* run);
     };
 
   }    // End namespace Simulation
@@ -0,0 +1,341 @@
+//==========================================================================
+//  AIDA Detector description implementation for LCD
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Frank
+//
+//==========================================================================
+#ifndef DD4HEP_DDG4_GEANT4BENCHMARK_H
+#define DD4HEP_DDG4_GEANT4BENCHMARK_H
+
+// Framework include files
+#include "DDG4/Geant4RunAction.h"
+#include "DDG4/Geant4GeneratorAction.h"
+
+// C/C++ include files
+#include <chrono>
+
+// Forward declarations
+class G4SteppingManager;
+class G4Track;
+class G4Step;
+
+/// Namespace for the AIDA detector description toolkit
+namespace DD4hep {
+
+  /// Namespace for the Geant4 based simulation part of the AIDA detector description toolkit
+  namespace Simulation {
+
+    /// Timer of the event processing phases of one thread
+    /**
+     *  The event processing is split into phases by time stamps taken
+     *  by callbacks of the generator, event, tracking and stepping sequences:
+     *  - generation:   from the benchmark generator action to the end of the generator sequence
+     *  - begin_event:  to the end of the begin-of-event actions
+     *  - tracking:     from there to the end of the Geant4 tracking (stepping, sensitive detectors)
+     *  - end_event:    the end-of-event actions (hit conversion, output)
+     *
+     *  The action must be the first action of the generator sequence.
+     *  Every event is merged into process wide statistics, which are
+     *  written by the Geant4BenchmarkReport run action of the master.
+     *
+     *  \author  M.Frank
+     *  \version 1.0
+     *  \ingroup DD4HEP_SIMULATION
+     */
+    class Geant4BenchmarkAction : public Geant4GeneratorAction  {
+    public:
+      typedef std::chrono::steady_clock clock;
+      enum Phase { GENERATION, BEGIN_EVENT, TRACKING, END_EVENT, EVENT, NUM_PHASES };
+    protected:
+      /// Time stamps of the current event
+      clock::time_point m_start, m_generated, m_begun, m_tracked;
+      /// Track and step counters of the current event
+      unsigned long     m_tracks, m_steps;
+    public:
+      /// Standard constructor
+      Geant4BenchmarkAction(Geant4Context* context, const std::string& nam);
+      /// Default destructor
+      virtual ~Geant4BenchmarkAction();
+      /// Event generation action callback: start of the event processing
+      virtual void operator()(G4Event* event)  override;
+      /// Callback at the end of the generator sequence
+      void generated(G4Event* event);
+      /// Begin-of-event callback after the event actions
+      void beginEvent(const G4Event* event);
+      /// End-of-event callback before the event actions
+      void endTracking(const G4Event* event);
+      /// Final end-of-event callback
+      void endEvent(const G4Event* event);
+      /// Pre-track action callback
+      void beginTrack(const G4Track* track);
+      /// Stepping action callback
+      void step(const G4Step* step, G4SteppingManager* mgr);
+    };
+
+    /// Run action writing the benchmark report in JSON format
+    /**
+     *  The report contains the event throughput, the statistics of the
+     *  processing phases measured by the Geant4BenchmarkAction instances
+     *  of all threads and the memory usage of the process.
+     *  In multi-threaded mode the action must be attached to the master,
+     *  whose end-of-run action is called after all workers finished.
+     *
+     *  \author  M.Frank
+     *  \version 1.0
+     *  \ingroup DD4HEP_SIMULATION
+     */
+    class Geant4BenchmarkReport : public Geant4RunAction  {
+    protected:
+      /// Property: Output file name
+      std::string m_output;
+      /// Property: Label of the configuration written to the report
+      std::string m_label;
+      /// Property: Number of worker threads written to the report
+      int         m_threads;
+      /// Time stamp of the begin of the run
+      std::chrono::steady_clock::time_point m_start;
+      /// Resident memory at the begin of the run [bytes]
+      double      m_rssStart;
+    public:
+      /// Standard constructor
+      Geant4BenchmarkReport(Geant4Context* context, const std::string& nam);
+      /// Default destructor
+      virtual ~Geant4BenchmarkReport();
+      /// Begin-of-run callback
+      virtual void begin(const G4Run* run)  override;
+      /// End-of-run callback
+      virtual void end(const G4Run* run)  override;
+    };
+  }    // End namespace Simulation
+}      // End namespace DD4hep
+#endif // DD4HEP_DDG4_GEANT4BENCHMARK_H
+
+//==========================================================================
+//  AIDA Detector description implementation for LCD
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Frank
+//
+//==========================================================================
+
+// Framework include files
+#include "DD4hep/Printout.h"
+#include "DD4hep/InstanceCount.h"
+#include "DDG4/Geant4Context.h"
+#include "DDG4/Geant4EventAction.h"
+#include "DDG4/Geant4TrackingAction.h"
+#include "DDG4/Geant4SteppingAction.h"
+
+// Geant4 include files
+#include "G4Run.hh"
+#include "G4Threading.hh"
+#include "G4AutoLock.hh"
+
+// C/C++ include files
+#include <map>
+#include <algorithm>
+#include <cmath>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include <sys/resource.h>
+
+using namespace std;
+using namespace DD4hep;
+using namespace DD4hep::Simulation;
+
+namespace {
+
+  G4Mutex benchmark_mutex = G4MUTEX_INITIALIZER;
+
+  /// Statistics of one processing phase [seconds]
+  struct PhaseStat  {
+    double sum = 0e0, sum2 = 0e0, min = 1e300, max = 0e0;
+    void add(double t)  {
+      sum += t;
+      sum2 += t*t;
+      if ( t < min ) min = t;
+      if ( t > max ) max = t;
+    }
+  };
+
+  /// Process wide benchmark statistics. Protected by the benchmark mutex
+  struct BenchmarkStatistics  {
+    typedef Geant4BenchmarkAction::clock clock;
+    PhaseStat phases[Geant4BenchmarkAction::NUM_PHASES];
+    unsigned long events = 0, tracks = 0, steps = 0;
+    clock::time_point first, last;
+    map<int, unsigned long> thread_events;
+    void reset()  {  *this = BenchmarkStatistics();  }
+  } s_statistics;
+
+  const char* s_phase_names[Geant4BenchmarkAction::NUM_PHASES] = {
+    "generation", "begin_event", "tracking", "end_event", "event"
+  };
+
+  /// Resident memory of the process [bytes]
+  double resident_memory()  {
+    long pages = 0, resident = 0;
+    FILE* f = ::fopen("/proc/self/statm", "r");
+    if ( f )  {
+      if ( ::fscanf(f, "%ld %ld", &pages, &resident) != 2 ) resident = 0;
+      ::fclose(f);
+    }
+    return double(resident) * double(::sysconf(_SC_PAGESIZE));
+  }
+
+  /// Peak resident memory of the process [bytes]
+  double peak_memory()  {
+    struct rusage usage;
+    ::getrusage(RUSAGE_SELF, &usage);
+    return double(usage.ru_maxrss) * 1024e0;
+  }
+
+  double seconds(Geant4BenchmarkAction::clock::duration d)  {
+    return chrono::duration<double>(d).count();
+  }
+}
+
+/// Standard constructor
+Geant4BenchmarkAction::Geant4BenchmarkAction(Geant4Context* ctxt, const string& nam)
+  : Geant4GeneratorAction(ctxt, nam), m_tracks(0), m_steps(0)
+{
+  InstanceCount::increment(this);
+  ctxt->generatorAction().call(this,  &Geant4BenchmarkAction::generated);
+  ctxt->eventAction().callAtBegin(this, &Geant4BenchmarkAction::beginEvent);
+  ctxt->eventAction().callAtEnd(this,   &Geant4BenchmarkAction::endTracking);
+  ctxt->eventAction().callAtFinal(this, &Geant4BenchmarkAction::endEvent);
+  ctxt->trackingAction().callAtBegin(this, &Geant4BenchmarkAction::beginTrack);
+  ctxt->steppingAction().call(this, &Geant4BenchmarkAction::step);
+}
+
+/// Default destructor
+Geant4BenchmarkAction::~Geant4BenchmarkAction()  {
+  InstanceCount::decrement(this);
+}
+
+/// Event generation action callback: start of the event processing
+void Geant4BenchmarkAction::operator()(G4Event* /* event */)  {
+  m_tracks = m_steps = 0;
+  m_start = clock::now();
+}
+
+/// Callback at the end of the generator sequence
+void Geant4BenchmarkAction::generated(G4Event* /* event */)  {
+  m_generated = clock::now();
+}
+
+/// Begin-of-event callback after the event actions
+void Geant4BenchmarkAction::beginEvent(const G4Event* /* event */)  {
+  m_begun = clock::now();
+}
+
+/// End-of-event callback before the event actions
+void Geant4BenchmarkAction::endTracking(const G4Event* /* event */)  {
+  m_tracked = clock::now();
+}
+
+/// Final end-of-event callback
+void Geant4BenchmarkAction::endEvent(const G4Event* /* event */)  {
+  clock::time_point now = clock::now();
+  G4AutoLock protection_lock(&benchmark_mutex);
+  BenchmarkStatistics& s = s_statistics;
+  s.phases[GENERATION].add(seconds(m_generated - m_start));
+  s.phases[BEGIN_EVENT].add(seconds(m_begun - m_generated));
+  s.phases[TRACKING].add(seconds(m_tracked - m_begun));
+  s.phases[END_EVENT].add(seconds(now - m_tracked));
+  s.phases[EVENT].add(seconds(now - m_start));
+  if ( 0 == s.events++ ) s.first = m_start;
+  if ( m_start < s.first ) s.first = m_start;
+  if ( now > s.last ) s.last = now;
+  s.tracks += m_tracks;
+  s.steps  += m_steps;
+  ++s.thread_events[G4Threading::G4GetThreadId()];
+}
+
+/// Pre-track action callback
+void Geant4BenchmarkAction::beginTrack(const G4Track* /* track */)  {
+  ++m_tracks;
+}
+
+/// Stepping action callback
+void Geant4BenchmarkAction::step(const G4Step* /* step */, G4SteppingManager* /* mgr */)  {
+  ++m_steps;
+}
+
+/// Standard constructor
+Geant4BenchmarkReport::Geant4BenchmarkReport(Geant4Context* ctxt, const string& nam)
+  : Geant4RunAction(ctxt, nam), m_threads(0), m_rssStart(0e0)
+{
+  InstanceCount::increment(this);
+  declareProperty("Output",  m_output = "benchmark.json");
+  declareProperty("Label",   m_label);
+  declareProperty("Threads", m_threads);
+}
+
+/// Default destructor
+Geant4BenchmarkReport::~Geant4BenchmarkReport()  {
+  InstanceCount::decrement(this);
+}
+
+/// Begin-of-run callback
+void Geant4BenchmarkReport::begin(const G4Run* /* run */)  {
+  G4AutoLock protection_lock(&benchmark_mutex);
+  s_statistics.reset();
+  m_rssStart = resident_memory();
+  m_start = chrono::steady_clock::now();
+}
+
+/// End-of-run callback
+void Geant4BenchmarkReport::end(const G4Run* run)  {
+  G4AutoLock protection_lock(&benchmark_mutex);
+  const BenchmarkStatistics& s = s_statistics;
+  double total  = seconds(chrono::steady_clock::now() - m_start);
+  double wall   = s.events ? seconds(s.last - s.first) : 0e0;
+  double rss    = resident_memory();
+  FILE*  f      = ::fopen(m_output.c_str(), "w");
+  if ( !f )  {
+    except("+++ Cannot open benchmark report %s: %s", m_output.c_str(), ::strerror(errno));
+  }
+  ::fprintf(f, "{\n  \"label\": \"%s\",\n  \"run\": %d,\n  \"threads\": %d,\n", m_label.c_str(), run->GetRunID(), m_threads);
+  ::fprintf(f, "  \"events\": %lu,\n  \"tracks\": %lu,\n  \"steps\": %lu,\n", s.events, s.tracks, s.steps);
+  ::fprintf(f, "  \"run_seconds\": %.6f,\n  \"event_loop_seconds\": %.6f,\n", total, wall);
+  ::fprintf(f, "  \"events_per_second\": %.6g,\n", wall > 0 ? s.events/wall : 0e0);
+  ::fprintf(f, "  \"memory\": {\"rss_begin\": %.0f, \"rss_end\": %.0f, \"rss_peak\": %.0f, \"rss_per_event\": %.6g},\n",
+            m_rssStart, rss, peak_memory(), s.events ? (rss - m_rssStart)/s.events : 0e0);
+  ::fprintf(f, "  \"phases\": {");
+  for( int i = 0; i < Geant4BenchmarkAction::NUM_PHASES; ++i )  {
+    const PhaseStat& p = s.phases[i];
+    double mean = s.events ? p.sum/s.events : 0e0;
+    double rms  = s.events ? sqrt(max(0e0, p.sum2/s.events - mean*mean)) : 0e0;
+    ::fprintf(f, "%s\n    \"%s\": {\"total\": %.6f, \"mean\": %.6g, \"rms\": %.6g, \"min\": %.6g, \"max\": %.6g}",
+              i ? "," : "", s_phase_names[i], p.sum, mean, rms, s.events ? p.min : 0e0, p.max);
+  }
+  ::fprintf(f, "\n  },\n  \"thread_events\": {");
+  bool first = true;
+  for( const auto& t : s.thread_events )  {
+    ::fprintf(f, "%s\"%d\": %lu", first ? "" : ", ", t.first, t.second);
+    first = false;
+  }
+  ::fprintf(f, "}\n}\n");
+  ::fclose(f);
+  info("+++ %lu events in %.3f sec: %.3f events/sec. Tracking: %.3f sec/event. Report: %s",
+         s.events, wall, wall > 0 ? s.events/wall : 0e0,
+         s.events ? s.phases[Geant4BenchmarkAction::TRACKING].sum/s.events : 0e0, m_output.c_str());
+}
+
+#include "DDG4/Factories.h"
+DECLARE_GEANT4ACTION(Geant4BenchmarkAction)
+DECLARE_GEANT4ACTION(Geant4BenchmarkReport)
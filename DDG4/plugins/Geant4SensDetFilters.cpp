@@ -61,6 +61,8 @@ namespace DD4hep {
       virtual ~ParticleRejectFilter();
       /// Filter action. Return true if hits should be processed
       virtual bool operator()(const G4Step* step) const;
+      /// Describe the filter criteria for fused evaluation
+      virtual bool describe(Geant4FilterCuts& cuts) const;
     };
 
     /// Geant4 sensitive detector filter implementing a particle selector
@@ -76,6 +78,8 @@ namespace DD4hep {
       virtual ~ParticleSelectFilter();
       /// Filter action. Return true if hits should be processed
       virtual bool operator()(const G4Step* step) const;
+      /// Describe the filter criteria for fused evaluation
+      virtual bool describe(Geant4FilterCuts& cuts) const;
     };
 
     /// Geant4 sensitive detector filter implementing a Geantino rejector
@@ -91,6 +95,8 @@ namespace DD4hep {
       virtual ~GeantinoRejectFilter();
       /// Filter action. Return true if hits should be processed
       virtual bool operator()(const G4Step* step) const;
+      /// Describe the filter criteria for fused evaluation
+      virtual bool describe(Geant4FilterCuts& cuts) const;
     };
 
     /// Geant4 sensitive detector filter implementing an energy cut.
@@ -109,6 +115,8 @@ namespace DD4hep {
       virtual ~EnergyDepositMinimumCut();
       /// Filter action. Return true if hits should be processed
       virtual bool operator()(const G4Step* step) const;
+      /// Describe the filter criteria for fused evaluation
+      virtual bool describe(Geant4FilterCuts& cuts) const;
     };
   }
 }
@@ -192,6 +200,13 @@ bool GeantinoRejectFilter::operator()(const G4Step* step) const   {
   return !isGeantino(step->GetTrack());
 }
 
+/// Describe the filter criteria for fused evaluation
+bool GeantinoRejectFilter::describe(Geant4FilterCuts& cuts) const   {
+  cuts.rejectParticle(G4Geantino::Definition());
+  cuts.rejectParticle(G4ChargedGeantino::Definition());
+  return true;
+}
+
 /// Constructor.
 ParticleRejectFilter::ParticleRejectFilter(Geant4Context* c, const std::string& n)
   : ParticleFilter(c,n) {
@@ -208,6 +223,12 @@ bool ParticleRejectFilter::operator()(const G4Step* step) const   {
   return isSameType(step->GetTrack());
 }
 
+/// Describe the filter criteria for fused evaluation (same logic as the filter action)
+bool ParticleRejectFilter::describe(Geant4FilterCuts& cuts) const   {
+  cuts.selectParticle(definition());
+  return true;
+}
+
 /// Constructor.
 ParticleSelectFilter::ParticleSelectFilter(Geant4Context* c, const std::string& n)
   : ParticleFilter(c,n) {
@@ -224,6 +245,12 @@ bool ParticleSelectFilter::operator()(const G4Step* step) const   {
   return !isSameType(step->GetTrack());
 }
 
+/// Describe the filter criteria for fused evaluation (same logic as the filter action)
+bool ParticleSelectFilter::describe(Geant4FilterCuts& cuts) const   {
+  cuts.rejectParticle(definition());
+  return true;
+}
+
 /// Constructor.
 EnergyDepositMinimumCut::EnergyDepositMinimumCut(Geant4Context* c, const std::string& n)
   : Geant4Filter(c,n) {
@@ -241,3 +268,9 @@ bool EnergyDepositMinimumCut::operator()(const G4Step* step) const  {
   return step->GetTotalEnergyDeposit() > m_energyCut;
 }
 
+/// Describe the filter criteria for fused evaluation
+bool EnergyDepositMinimumCut::describe(Geant4FilterCuts& cuts) const  {
+  cuts.minimumEnergyDeposit(m_energyCut);
+  return true;
+}
+
@@ -0,0 +1,239 @@
+#!/bin/python
+#==========================================================================
+#  AIDA Detector description implementation for LCD
+#--------------------------------------------------------------------------
+# Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+# All rights reserved.
+#
+# For the licensing terms see $DD4hepINSTALL/LICENSE.
+# For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+#
+#==========================================================================
+"""
+   DDG4 throughput benchmark
+
+   Simulates a fixed number of particle gun events with fixed seeds
+   for a list of thread counts. Every configuration runs in a separate
+   process, since Geant4 cannot be initialized twice. The event
+   processing phases are timed by the Geant4BenchmarkAction and each
+   run writes a report with the Geant4BenchmarkReport run action.
+   The reports are combined into one JSON file including the scaling
+   with the number of threads.
+
+   Example:
+   python g4Benchmark.py -c $DD4hepINSTALL/examples/CLICSiD/compact/compact.xml \\
+                         -t 0,1,2,4 -n 200 -o benchmark.json
+
+   Thread count 0 runs the sequential (non-MT) Geant4 run manager.
+
+   @author  M.Frank
+   @version 1.0
+"""
+import os, sys, errno, json, optparse, subprocess, tempfile
+
+def setupEventProcessing(geant4, kernel, opts):
+  """ Configure the per-thread actions: generation, MC truth handling, output """
+  if kernel is None:
+    kernel = geant4.kernel()
+  # The benchmark timer must be the first generator action
+  bench = DDG4.GeneratorAction(kernel,'Geant4BenchmarkAction/Benchmark')
+  kernel.generatorAction().adopt(bench)
+  gen = DDG4.GeneratorAction(kernel,'Geant4GeneratorActionInit/GenerationInit')
+  kernel.generatorAction().adopt(gen)
+  gun = DDG4.GeneratorAction(kernel,'Geant4ParticleGun/Gun')
+  gun.Standalone   = False
+  gun.print        = False
+  gun.particle     = opts.particle
+  gun.energy       = opts.energy*SystemOfUnits.GeV
+  gun.multiplicity = opts.multiplicity
+  gun.isotrop      = True
+  gun.Mask         = 1
+  kernel.generatorAction().adopt(gun)
+  gen = DDG4.GeneratorAction(kernel,'Geant4InteractionMerger/InteractionMerger')
+  kernel.generatorAction().adopt(gen)
+  gen = DDG4.GeneratorAction(kernel,'Geant4PrimaryHandler/PrimaryHandler')
+  kernel.generatorAction().adopt(gen)
+  if opts.particle_handler:
+    part = DDG4.GeneratorAction(kernel,'Geant4ParticleHandler/ParticleHandler')
+    part.SaveProcesses = ['Decay']
+    part.MinimalKineticEnergy = 100*SystemOfUnits.MeV
+    kernel.generatorAction().adopt(part)
+  if opts.root_output:
+    out = DDG4.EventAction(kernel,'Geant4Output2ROOT/RootOutput')
+    out.HandleMCTruth = opts.particle_handler
+    out.Output = opts.root_output
+    kernel.eventAction().adopt(out)
+  return 1
+
+def setupReport(geant4, kernel, opts):
+  """ The report is written by the master after all workers finished """
+  if kernel is None:
+    kernel = geant4.master()
+  report = DDG4.RunAction(kernel,'Geant4BenchmarkReport/BenchmarkReport')
+  report.Output  = opts.report
+  report.Label   = opts.label
+  report.Threads = opts.threads
+  kernel.runAction().adopt(report)
+  return 1
+
+def setupSensitives(geant4):
+  """ Standard sensitive detector actions for all sensitive subdetectors """
+  for i in geant4.lcdd.detectors():
+    o = DDG4.DetElement(i.second.ptr())
+    sd = geant4.lcdd.sensitiveDetector(o.name())
+    if sd.isValid():
+      typ = sd.type()
+      if not geant4.sensitive_types.has_key(typ):
+        print '+++  %-32s type:%-12s  --> Unknown Sensitive type'%(o.name(), typ,)
+        sys.exit(errno.EINVAL)
+      geant4.setupDetector(o.name(),geant4.sensitive_types[typ])
+  return 1
+
+def runSingle(opts):
+  """ Execute one benchmark run in this process """
+  kernel = DDG4.Kernel()
+  kernel.loadGeometry(opts.compact)
+  DDG4.Core.setPrintFormat("%-32s %6s %s")
+  DDG4.Core.setPrintLevel(opts.print_level)
+  kernel.NumberOfThreads = opts.threads
+  geant4 = DDG4.Geant4(kernel,tracker='Geant4TrackerCombineAction')
+  geant4.setupCshUI(ui=None)
+
+  rndm = DDG4.Action(kernel,'Geant4Random/Random')
+  rndm.Seed = opts.seed
+  rndm.initialize()
+
+  if opts.threads > 0:
+    geant4.addUserInitialization(worker=setupEventProcessing, worker_args=(geant4,None,opts),
+                                 master=setupReport, master_args=(geant4,None,opts))
+    seq,act = geant4.addDetectorConstruction('Geant4DetectorGeometryConstruction/ConstructGeo')
+    seq,act = geant4.addDetectorConstruction('Geant4PythonDetectorConstruction/SetupSD',
+                                             sensitives=setupSensitives,sensitives_args=(geant4,))
+    seq,act = geant4.addDetectorConstruction('Geant4DetectorSensitivesConstruction/ConstructSD')
+    seq,act = geant4.addDetectorConstruction('Geant4FieldTrackingConstruction/MagFieldTrackingSetup')
+  else:
+    setupEventProcessing(geant4, kernel, opts)
+    setupReport(geant4, kernel, opts)
+    setupSensitives(geant4)
+    geant4.setupTrackingField(prt=False)
+  geant4.setupPhysics(opts.physics)
+  kernel.NumEvents = opts.events
+  if opts.threads > 0:
+    geant4.run()
+  else:
+    kernel.configure()
+    kernel.initialize()
+    kernel.run()
+    kernel.terminate()
+  return 0
+
+def runScaling(opts, threads):
+  """ Run one process per thread count and combine the reports """
+  runs = []
+  for n in threads:
+    fd, report = tempfile.mkstemp(prefix='g4bench_', suffix='.json')
+    os.close(fd)
+    cmd = [opts.python, os.path.abspath(sys.argv[0]), '--single',
+           '-c', opts.compact, '-n', str(opts.events), '-t', str(n), '-s', str(opts.seed),
+           '--particle', opts.particle, '--energy', str(opts.energy),
+           '--multiplicity', str(opts.multiplicity), '--physics', opts.physics,
+           '--label', opts.label, '--report', report, '-P', str(opts.print_level)]
+    if opts.particle_handler: cmd.append('--particle-handler')
+    if opts.root_output:      cmd += ['--root-output', '%s_%d.root'%(opts.root_output,n)]
+    print '+++ Benchmark with %d threads: %s'%(n, ' '.join(cmd),)
+    ret = subprocess.call(cmd)
+    if ret != 0:
+      print '+++ Benchmark with %d threads FAILED with status %d'%(n, ret,)
+      os.unlink(report)
+      return ret
+    with open(report) as f:
+      runs.append(json.load(f))
+    os.unlink(report)
+
+  base = runs[0]
+  for r in runs:
+    r['speedup'] = r['events_per_second']/base['events_per_second'] if base['events_per_second'] > 0 else 0.0
+    r['efficiency'] = r['speedup']*max(base['threads'],1)/max(r['threads'],1)
+  result = {
+    'compact': opts.compact, 'events': opts.events, 'seed': opts.seed,
+    'particle': opts.particle, 'energy_GeV': opts.energy, 'multiplicity': opts.multiplicity,
+    'physics': opts.physics, 'particle_handler': opts.particle_handler,
+    'root_output': opts.root_output is not None, 'label': opts.label,
+    'runs': runs }
+  with open(opts.output,'w') as f:
+    json.dump(result, f, indent=2, sort_keys=True)
+  print '\n+++ %-8s %12s %10s %10s %14s %14s'%('threads','events/sec','speedup','efficiency','tracking[ms]','rss/event[kB]')
+  for r in runs:
+    print '+++ %-8d %12.3f %10.3f %10.3f %14.3f %14.3f'%(r['threads'], r['events_per_second'], r['speedup'],
+                                                      r['efficiency'], 1e3*r['phases']['tracking']['mean'],
+                                                      r['memory']['rss_per_event']/1024.)
+  print '+++ Benchmark report written to',opts.output
+  return 0
+
+parser = optparse.OptionParser()
+parser.formatter.width = 132
+parser.description = 'DDG4 throughput benchmark: events/sec, per phase time and memory per event.'
+parser.add_option('-c', '--compact', dest='compact', default=None,
+                  help='Define LCCDD style compact xml input', metavar='<FILE>')
+parser.add_option('-n', '--events', dest='events', default=100, type='int',
+                  help='Number of events per run', metavar='<int>')
+parser.add_option('-t', '--threads', dest='threads', default='0',
+                  help='Comma separated list of thread counts. 0: sequential run manager', metavar='<list>')
+parser.add_option('-s', '--seed', dest='seed', default=987654321, type='int',
+                  help='Random number seed', metavar='<int>')
+parser.add_option('--particle', dest='particle', default='pi-',
+                  help='Particle gun: particle type', metavar='<name>')
+parser.add_option('--energy', dest='energy', default=10.0, type='float',
+                  help='Particle gun: energy in GeV', metavar='<float>')
+parser.add_option('--multiplicity', dest='multiplicity', default=1, type='int',
+                  help='Particle gun: particles per event', metavar='<int>')
+parser.add_option('--physics', dest='physics', default='QGSP_BERT',
+                  help='Geant4 physics list', metavar='<name>')
+parser.add_option('--particle-handler', dest='particle_handler', default=False, action='store_true',
+                  help='Enable the MC truth particle handler')
+parser.add_option('--root-output', dest='root_output', default=None,
+                  help='Write the events to ROOT files with this prefix', metavar='<FILE>')
+parser.add_option('--label', dest='label', default='',
+                  help='Label of the configuration written to the report', metavar='<string>')
+parser.add_option('-o', '--output', dest='output', default='g4benchmark.json',
+                  help='Combined JSON report', metavar='<FILE>')
+parser.add_option('--python', dest='python', default=sys.executable,
+                  help='Interpreter used to execute the individual runs', metavar='<FILE>')
+parser.add_option('-P', '--print', dest='print_level', default=4, type='int',
+                  help='Set DD4hep print level.', metavar='<int>')
+parser.add_option('--single', dest='single', default=False, action='store_true',
+                  help='Internal: execute a single run in this process')
+parser.add_option('--report', dest='report', default='g4benchmark_run.json',
+                  help='Internal: report file of a single run', metavar='<FILE>')
+
+(opts, args) = parser.parse_args()
+
+if opts.compact is None:
+  print "   ",parser.format_help()
+  sys.exit(1)
+
+try:
+  threads = [int(t) for t in opts.threads.split(',')]
+except ValueError,X:
+  print 'Invalid thread count list:',opts.threads
+  sys.exit(errno.EINVAL)
+
+if not opts.single:
+  sys.exit(runScaling(opts, threads))
+
+opts.threads = threads[0]
+try:
+  import ROOT
+  from ROOT import gROOT
+  gROOT.SetBatch(1)
+except ImportError,X:
+  print 'PyROOT interface not accessible:',X
+  sys.exit(errno.ENOENT)
+
+try:
+  import DDG4, SystemOfUnits
+except ImportError,X:
+  print 'DDG4 python interface not accessible:',X
+  sys.exit(errno.ENOENT)
+#
+sys.exit(runSingle(opts))
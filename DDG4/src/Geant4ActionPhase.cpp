@@ -44,6 +44,9 @@ Geant4ActionPhase::Geant4ActionPhase(Geant4Context* ctxt, const string& nam, con
   m_argTypes[0] = &arg_type0;
   m_argTypes[1] = &arg_type1;
   m_argTypes[2] = &arg_type2;
+  declareProperty("Instrument",     m_instrument);
+  declareProperty("SamplingPeriod", m_samplingPeriod);
+  declareProperty("Statistics",     m_statisticsValues);
   InstanceCount::increment(this);
 }
 
@@ -59,6 +62,7 @@ Geant4ActionPhase::~Geant4ActionPhase() {
 bool Geant4ActionPhase::add(Geant4Action* action, Callback callback) {
   action->addRef();
   m_members.push_back(make_pair(action,callback));
+  m_statistics.clear();
   return true;
 }
 
@@ -69,6 +73,7 @@ bool Geant4ActionPhase::remove(Geant4Action* action, Callback callback) {
     if (i != m_members.end()) {
       (*i).first->release();
       m_members.erase(i);
+      m_statistics.clear();
       return true;
     }
     return false;
@@ -81,16 +86,57 @@ bool Geant4ActionPhase::remove(Geant4Action* action, Callback callback) {
       i = m_members.begin();
     }
   }
+  m_statistics.clear();
   return (len > m_members.size());
 }
 
 /// Execute all members in the phase context
 void Geant4ActionPhase::execute(void* argument) {
+  if ( m_instrument )  {
+    executeInstrumented(argument);
+    return;
+  }
   for (Members::iterator i = m_members.begin(); i != m_members.end(); ++i) {
     (*i).second.execute((const void**) &argument);
   }
 }
 
+/// Execute all members and record the call counters and timing
+void Geant4ActionPhase::executeInstrumented(void* argument) {
+  if ( m_statistics.size() != m_members.size() )  {
+    vector<string> names;
+    for (Members::const_iterator i = m_members.begin(); i != m_members.end(); ++i)
+      names.push_back((*i).first->name());
+    m_statistics.define(names);
+  }
+  m_statistics.setSamplingPeriod(m_samplingPeriod);
+  if ( m_statistics.dispatch() )  {
+    Geant4ActionStatistics::ticks_t start = Geant4ActionStatistics::ticks();
+    for (size_t i = 0; i < m_members.size(); ++i)  {
+      m_members[i].second.execute((const void**) &argument);
+      start = m_statistics.record(i, start);
+    }
+    return;
+  }
+  for (size_t i = 0; i < m_members.size(); ++i)  {
+    m_members[i].second.execute((const void**) &argument);
+    m_statistics.count(i);
+  }
+}
+
+/// Reset the statistics of the phase members
+void Geant4ActionPhase::resetStatistics()   {
+  m_statistics.reset();
+}
+
+/// Print the statistics of the phase members and update the "Statistics" property
+void Geant4ActionPhase::printStatistics()   {
+  if ( m_instrument )  {
+    m_statistics.print(this);
+    m_statistics.publish(m_statisticsValues);
+  }
+}
+
 class G4HCofThisEvent;
 class G4TouchableHistory;
 #include "DDG4/Geant4RunAction.h"
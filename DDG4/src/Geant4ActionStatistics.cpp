@@ -0,0 +1,98 @@
+//==========================================================================
+//  AIDA Detector description implementation for LCD
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Frank
+//
+//==========================================================================
+
+// Framework include files
+#include "DDG4/Geant4Action.h"
+#include "DDG4/Geant4ActionStatistics.h"
+
+// Geant4 include files
+#include "G4Threading.hh"
+
+// C/C++ include files
+#include <cstdio>
+
+using namespace std;
+using namespace DD4hep;
+using namespace DD4hep::Simulation;
+
+/// Default constructor
+Geant4ActionStatistics::Geant4ActionStatistics()  {
+  reset();
+}
+
+/// (Re-)define the member names. Existing counters are dropped if the names differ.
+void Geant4ActionStatistics::define(const vector<string>& names)  {
+  bool same = names.size() == m_entries.size();
+  for(size_t i=0; same && i<names.size(); ++i)
+    same = names[i] == m_entries[i].name;
+  if ( !same )  {
+    m_entries.clear();
+    m_entries.resize(names.size());
+    for(size_t i=0; i<names.size(); ++i)
+      m_entries[i].name = names[i];
+  }
+}
+
+/// Drop all members and counters
+void Geant4ActionStatistics::clear()  {
+  m_entries.clear();
+  reset();
+}
+
+/// Reset all counters, but keep the member names
+void Geant4ActionStatistics::reset()  {
+  for(Entries::iterator i=m_entries.begin(); i!=m_entries.end(); ++i)  {
+    Entry& e = *i;
+    e.calls = e.timed = e.hits = 0;
+    e.ticks = 0;
+  }
+  m_dispatches = 0;
+  m_startTicks = ticks();
+  m_startTime  = clock_type::now();
+}
+
+/// Seconds per tick estimated from the steady clock since the last reset
+double Geant4ActionStatistics::secondsPerTick() const  {
+  ticks_t dt = ticks() - m_startTicks;
+  double  ds = chrono::duration<double>(clock_type::now() - m_startTime).count();
+  return dt > 0 ? ds/double(dt) : 1e-9;
+}
+
+/// Print the statistics table using the output level of the owner
+void Geant4ActionStatistics::print(const Geant4Action* owner) const  {
+  double sec = secondsPerTick();
+  owner->info("+++ Statistics [thread %d]: %llu dispatches, sampling period %lu",
+              G4Threading::G4GetThreadId(), m_dispatches, m_period);
+  owner->info("+++ %-32s %12s %12s %12s %12s",
+              "Member", "Calls", "Total[ms]", "Mean[us]", "Hits");
+  for(Entries::const_iterator i=m_entries.begin(); i!=m_entries.end(); ++i)  {
+    const Entry& e = *i;
+    double mean = e.timed > 0 ? sec*double(e.ticks)/double(e.timed) : 0e0;
+    owner->info("+++ %-32s %12llu %12.3f %12.3f %12llu",
+                e.name.c_str(), e.calls, 1e3*mean*double(e.calls), 1e6*mean, e.hits);
+  }
+}
+
+/// Export the statistics as name -> "calls:... total[s]:... mean[s]:... hits:..."
+void Geant4ActionStatistics::publish(map<string,string>& values) const  {
+  double sec = secondsPerTick();
+  values.clear();
+  for(Entries::const_iterator i=m_entries.begin(); i!=m_entries.end(); ++i)  {
+    const Entry& e = *i;
+    double mean = e.timed > 0 ? sec*double(e.ticks)/double(e.timed) : 0e0;
+    char text[256];
+    ::snprintf(text, sizeof(text), "calls:%llu total[s]:%g mean[s]:%g hits:%llu",
+               e.calls, mean*double(e.calls), mean, e.hits);
+    values[e.name] = text;
+  }
+}
@@ -29,6 +29,7 @@
 #include "DDG4/Geant4UIManager.h"
 #include "DDG4/Geant4Kernel.h"
 #include "DDG4/Geant4Random.h"
+#include "DDG4/Geant4ActionPhase.h"
 
 // Geant4 include files
 #include "G4Version.hh"
@@ -45,6 +46,7 @@
 
 // C/C++ include files
 #include <memory>
+#include <chrono>
 #include <stdexcept>
 
 namespace {
@@ -348,6 +350,9 @@ namespace DD4hep {
     /// Begin-of-run callback
     void Geant4UserRunAction::BeginOfRunAction(const G4Run* run) {
       createClientContext(run);
+      const Geant4Kernel::Phases& phases = kernel().phases();
+      for (Geant4Kernel::Phases::const_iterator i=phases.begin(); i!=phases.end(); ++i)
+        (*i).second->resetStatistics();
       kernel().executePhase("begin-run",(const void**)&run);
       if ( m_sequence ) m_sequence->begin(run); // Action not mandatory
     }
@@ -356,6 +361,9 @@ namespace DD4hep {
     void Geant4UserRunAction::EndOfRunAction(const G4Run* run) {
       if ( m_sequence ) m_sequence->end(run); // Action not mandatory
       kernel().executePhase("end-run",(const void**)&run);
+      const Geant4Kernel::Phases& phases = kernel().phases();
+      for (Geant4Kernel::Phases::const_iterator i=phases.begin(); i!=phases.end(); ++i)
+        (*i).second->printStatistics();
       destroyClientContext(run);
     }
 
@@ -419,9 +427,12 @@ namespace DD4hep {
         m_sequence->info("+++ Executing Geant4UserActionInitialization::Build. "
                          "Context:%p Kernel:%p [%ld]", (void*)ctx, (void*)&krnl, krnl.id());
       
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
         m_sequence->updateContext(ctx);
         m_sequence->build();
         m_sequence->updateContext(old);
+        m_sequence->info("+++ Worker [%ld] user initialization took %.3f ms.", krnl.id(),
+                         std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now()-start).count());
       }
       // Set user generator action sequence. Not optional, since event context is defined inside
       Geant4UserGeneratorAction* gen_action = new Geant4UserGeneratorAction(ctx,krnl.generatorAction(false));
@@ -36,12 +36,94 @@
 
 // C/C++ include files
 #include <stdexcept>
+#include <unordered_map>
+#include <memory>
+#include <atomic>
+#include <vector>
 
 using namespace std;
 using namespace DD4hep;
 using namespace DD4hep::Simulation;
 namespace {
   G4Mutex creation_mutex=G4MUTEX_INITIALIZER;
+
+#if defined(DD4HEP_ROOT_VERSION_5)
+  /// Create an action object: ROOT 5 has no typed factory handles
+  Geant4Action* _create_action(const string& type, Geant4Context* ctxt, const string& nam)   {
+    return PluginService::Create<Geant4Action*>(type, ctxt, nam);
+  }
+  /// Create a sensitive action object: ROOT 5 has no typed factory handles
+  Geant4Sensitive* _create_sensitive(const string& type, Geant4Context* ctxt, const string& nam,
+                                     Geometry::DetElement* det, Geometry::LCDD* lcdd)   {
+    return PluginService::Create<Geant4Sensitive*>(type, ctxt, nam, det, lcdd);
+  }
+#else
+  G4Mutex factory_mutex=G4MUTEX_INITIALIZER;
+
+  typedef PluginFactory<Geant4Action*(Geant4Context*,string)> ActionFactory;
+  typedef PluginFactory<Geant4Sensitive*(Geant4Context*,string,Geometry::DetElement*,Geometry::LCDD*)> SensitiveFactory;
+
+  /// Process wide table of resolved factories with a lock-free read path
+  /** Workers create the same action types over and over again:
+   *  Avoid the lookup in the plugin registry for each instance.
+   *
+   *  Readers access the current table without locking. Published tables are
+   *  never modified: a new factory is added to a copy of the table, which then
+   *  replaces the current one. Replaced tables are kept until the end of the
+   *  process, since other threads may still read them. Only the first creation
+   *  of a type takes the lock; the number of action types is small.
+   *  Factories which cannot be resolved are not cached: they may appear later
+   *  when new libraries get loaded.
+   */
+  template <typename FACTORY> class FactoryTable  {
+    typedef unordered_map<string,FACTORY> Table;
+    /// Currently published table
+    atomic<const Table*> m_current;
+    /// All tables ever published
+    vector<unique_ptr<const Table> > m_tables;
+  public:
+    /// Default constructor
+    FactoryTable() : m_current(0)  {
+      m_tables.emplace_back(new Table());
+      m_current.store(m_tables.back().get());
+    }
+    /// Access the resolved factory of a given type
+    FACTORY get(const string& type)   {
+      const Table* table = m_current.load(memory_order_acquire);
+      typename Table::const_iterator i = table->find(type);
+      if ( i != table->end() )  {
+        return (*i).second;
+      }
+      FACTORY factory(type);
+      if ( factory.isValid() )  {
+        G4AutoLock protection_lock(&factory_mutex);
+        table = m_current.load(memory_order_relaxed);
+        if ( table->find(type) == table->end() )  {
+          Table* copy = new Table(*table);
+          copy->insert(make_pair(type,factory));
+          m_tables.emplace_back(copy);
+          m_current.store(copy, memory_order_release);
+        }
+      }
+      return factory;
+    }
+  };
+
+  /// Access the resolved factory of a given type. Every factory is looked up only once.
+  template <typename FACTORY> FACTORY _factory(const string& type)   {
+    static FactoryTable<FACTORY> s_factories;
+    return s_factories.get(type);
+  }
+  /// Create an action object using the resolved factory
+  Geant4Action* _create_action(const string& type, Geant4Context* ctxt, const string& nam)   {
+    return _factory<ActionFactory>(type)(ctxt, nam);
+  }
+  /// Create a sensitive action object using the resolved factory
+  Geant4Sensitive* _create_sensitive(const string& type, Geant4Context* ctxt, const string& nam,
+                                     Geometry::DetElement* det, Geometry::LCDD* lcdd)   {
+    return _factory<SensitiveFactory>(type)(ctxt, nam, det, lcdd);
+  }
+#endif
 }
 
 namespace DD4hep {
@@ -75,18 +157,18 @@ namespace DD4hep {
 
     template <typename TYPE> TYPE* _create_object(Geant4Kernel& kernel, const TypeName& typ)    {
       Geant4Context* ctxt = kernel.workerContext();
-      Geant4Action* object = PluginService::Create<Geant4Action*>(typ.first, ctxt, typ.second);
+      Geant4Action* object = _create_action(typ.first, ctxt, typ.second);
       if (!object && typ.first == typ.second) {
         string _t = typeName(typeid(TYPE));
         printout(DEBUG, "Geant4Handle", "Object factory for %s not found. Try out %s",
                  typ.second.c_str(), _t.c_str());
-        object = PluginService::Create<Geant4Action*>(_t, ctxt, typ.second);
+        object = _create_action(_t, ctxt, typ.second);
         if (!object) {
           size_t idx = _t.rfind(':');
           if (idx != string::npos)
             _t = string(_t.substr(idx + 1));
           printout(DEBUG, "Geant4Handle", "Try out object factory for %s",_t.c_str());
-          object = PluginService::Create<Geant4Action*>(_t, ctxt, typ.second);
+          object = _create_action(_t, ctxt, typ.second);
         }
       }
       if (object)  {
@@ -307,7 +389,7 @@ namespace DD4hep {
         TypeName typ = TypeName::split(type_name);
         Geometry::LCDD& lcdd = kernel.lcdd();
         Geometry::DetElement det = lcdd.detector(detector);
-        Geant4Sensitive* object = PluginService::Create<Geant4Sensitive*>(typ.first, ctxt, typ.second, &det, &lcdd);
+        Geant4Sensitive* object = _create_sensitive(typ.first, ctxt, typ.second, &det, &lcdd);
         if (object) {
           value = object;
           return;
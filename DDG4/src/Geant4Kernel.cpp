@@ -44,6 +44,9 @@ using namespace DD4hep::Simulation;
 namespace {
   G4Mutex kernel_mutex=G4MUTEX_INITIALIZER;
   DD4hep::dd4hep_ptr<Geant4Kernel> s_main_instance(0);
+  /// Thread local slots publishing the worker kernel of the current thread and its master
+  G4ThreadLocal Geant4Kernel* s_thread_master = 0;
+  G4ThreadLocal Geant4Kernel* s_thread_worker = 0;
 }
 
 /// Standard constructor
@@ -120,6 +123,9 @@ Geant4Kernel::~Geant4Kernel() {
   if ( this == s_main_instance.get() )   {
     s_main_instance.release();
   }
+  if ( s_thread_master == this || s_thread_worker == this )  {
+    s_thread_master = s_thread_worker = 0;
+  }
   destroyObjects(m_workers);
   if ( isMaster() )  {
     releaseObjects(m_globalFilters);
@@ -162,9 +168,23 @@ unsigned long int Geant4Kernel::thread_self()    {
 Geant4Kernel& Geant4Kernel::createWorker()   {
   if ( isMaster() )   {
     unsigned long identifier = thread_self();
-    Geant4Kernel* w = new Geant4Kernel(this, identifier);
-    m_workers[identifier] = w;
-    printout(INFO,"Geant4Kernel","+++ Created worker instance id=%ul",identifier);
+    Geant4Kernel* w = 0;
+    {
+      // The worker constructor uses the number of workers: must be protected as well
+      G4AutoLock protection_lock(&kernel_mutex);
+      Workers::iterator i = m_workers.find(identifier);
+      if ( i != m_workers.end() )  {
+        w = (*i).second;
+      }
+      else  {
+        w = new Geant4Kernel(this, identifier);
+        m_workers[identifier] = w;
+        printout(INFO,"Geant4Kernel","+++ Created worker instance id=%lu",identifier);
+      }
+    }
+    // Publish the worker for lock-free access by the calling thread
+    s_thread_master = this;
+    s_thread_worker = w;
     return *w;
   }
   throw runtime_error(format("Geant4Kernel", "DDG4: Only the master instance may create workers."));
@@ -172,16 +192,33 @@ Geant4Kernel& Geant4Kernel::createWorker()   {
 
 /// Access worker instance by it's identifier
 Geant4Kernel& Geant4Kernel::worker(unsigned long identifier, bool create_if)    {
-  Workers::iterator i = m_workers.find(identifier);
-  if ( i != m_workers.end() )   {
-    return *((*i).second);
+  // Fast path: the worker of the calling thread is published in thread local storage
+  if ( s_thread_master == this && identifier == thread_self() )  {
+    return *s_thread_worker;
+  }
+  Geant4Kernel* w = 0;
+  {
+    G4AutoLock protection_lock(&kernel_mutex);
+    Workers::iterator i = m_workers.find(identifier);
+    if ( i != m_workers.end() ) w = (*i).second;
+  }
+  if ( w )   {
+    if ( identifier == thread_self() )  {
+      s_thread_master = this;
+      s_thread_worker = w;
+    }
+    return *w;
   }
   else if ( identifier == m_id )  {
+    if ( identifier == thread_self() )  {
+      s_thread_master = s_thread_worker = this;
+    }
     return *this;
   }
   else if ( !isMultiThreaded() )  {
     unsigned long self = thread_self();
     if ( identifier == self )  {
+      s_thread_master = s_thread_worker = this;
       return *this;
     }
   }
@@ -193,6 +230,7 @@ Geant4Kernel& Geant4Kernel::worker(unsigned long identifier, bool create_if)
 
 /// Access number of workers
 int Geant4Kernel::numWorkers() const   {
+  G4AutoLock protection_lock(&kernel_mutex);
   return m_workers.size();
 }
 
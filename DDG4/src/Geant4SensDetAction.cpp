@@ -24,11 +24,14 @@
 
 // Geant4 include files
 #include <G4Step.hh>
+#include <G4Track.hh>
+#include <G4ParticleDefinition.hh>
 #include <G4SDManager.hh>
 #include <G4VSensitiveDetector.hh>
 
 // C/C++ include files
 #include <stdexcept>
+#include <algorithm>
 
 using namespace std;
 using namespace DD4hep;
@@ -84,6 +87,102 @@ bool Geant4Filter::operator()(const G4Step*) const {
   return true;
 }
 
+/// Describe the filter criteria for fused evaluation.
+bool Geant4Filter::describe(Geant4FilterCuts&) const {
+  return false;
+}
+
+/// Accept only particles of the given type
+void Geant4FilterCuts::selectParticle(const G4ParticleDefinition* def)   {
+  selectParticles(Particles(1,def));
+}
+
+/// Accept only particles of one of the given types
+void Geant4FilterCuts::selectParticles(const Particles& defs)   {
+  if ( checks&CHECK_SELECT )  {
+    // Several selections: only particles selected by all of them pass
+    Particles common;
+    for( const auto* d : selected )
+      if ( std::find(defs.begin(),defs.end(),d) != defs.end() ) common.push_back(d);
+    selected = common;
+  }
+  else  {
+    selected = defs;
+  }
+  checks |= CHECK_SELECT;
+}
+
+/// Reject particles of the given type
+void Geant4FilterCuts::rejectParticle(const G4ParticleDefinition* def)   {
+  if ( std::find(rejected.begin(),rejected.end(),def) == rejected.end() )
+    rejected.push_back(def);
+  checks |= CHECK_REJECT;
+}
+
+/// Require charged or neutral particles
+void Geant4FilterCuts::requireCharge(Charge which)   {
+  if ( which == ANY_CHARGE )
+    return;
+  else if ( (checks&CHECK_CHARGE) && charge != which )
+    selectParticles(Particles());  // Contradicting requirements: nothing passes
+  charge  = which;
+  checks |= CHECK_CHARGE;
+}
+
+/// Require an energy deposit above the given value
+void Geant4FilterCuts::minimumEnergyDeposit(double cut)   {
+  energyCut = (checks&CHECK_ENERGY) ? std::max(energyCut,cut) : cut;
+  checks   |= CHECK_ENERGY;
+}
+
+/// Compile the filter chain
+void Geant4FilterChain::compile(const std::vector<Geant4Filter*>& filters)   {
+  reset();
+  for( const Geant4Filter* f : filters )  {
+    Geant4FilterCuts cuts = m_cuts;
+    if ( f->describe(cuts) )
+      m_cuts = cuts;
+    else
+      m_residual.push_back(f);
+  }
+  // Rejecting selected particles is the same as not selecting them
+  if ( (m_cuts.checks&Geant4FilterCuts::CHECK_SELECT) && (m_cuts.checks&Geant4FilterCuts::CHECK_REJECT) )  {
+    Geant4FilterCuts::Particles sel;
+    for( const auto* d : m_cuts.selected )
+      if ( std::find(m_cuts.rejected.begin(),m_cuts.rejected.end(),d) == m_cuts.rejected.end() )
+        sel.push_back(d);
+    m_cuts.selected = sel;
+    m_cuts.rejected.clear();
+    m_cuts.checks &= ~Geant4FilterCuts::CHECK_REJECT;
+  }
+  m_compiled = true;
+}
+
+/// Apply the compiled chain. Return true if hits should be processed
+bool Geant4FilterChain::operator()(const G4Step* step) const   {
+  const unsigned int checks = m_cuts.checks;
+  if ( (checks&Geant4FilterCuts::CHECK_ENERGY) && !(step->GetTotalEnergyDeposit() > m_cuts.energyCut) )
+    return false;
+  if ( checks&Geant4FilterCuts::CHECK_PARTICLE )  {
+    const G4ParticleDefinition* def = step->GetTrack()->GetDefinition();
+    if ( checks&Geant4FilterCuts::CHECK_SELECT )  {
+      const auto& s = m_cuts.selected;
+      if ( std::find(s.begin(),s.end(),def) == s.end() ) return false;
+    }
+    if ( checks&Geant4FilterCuts::CHECK_REJECT )  {
+      const auto& r = m_cuts.rejected;
+      if ( std::find(r.begin(),r.end(),def) != r.end() ) return false;
+    }
+    if ( checks&Geant4FilterCuts::CHECK_CHARGE )  {
+      bool charged = def->GetPDGCharge() != 0e0;
+      if ( charged != (m_cuts.charge == Geant4FilterCuts::CHARGED) ) return false;
+    }
+  }
+  for( const Geant4Filter* f : m_residual )
+    if ( !(*f)(step) ) return false;
+  return true;
+}
+
 /// Constructor. The detector element is identified by the name
 Geant4Sensitive::Geant4Sensitive(Geant4Context* ctxt, const string& nam, DetElement det, LCDD& lcdd_ref)
   : Geant4Action(ctxt, nam), m_sensitiveDetector(0), m_sequence(0),
@@ -118,6 +217,7 @@ void Geant4Sensitive::adopt(Geant4Filter* filter) {
   if (filter) {
     filter->addRef();
     m_filters.add(filter);
+    m_filterChain.reset();
     return;
   }
   throw runtime_error("Geant4Sensitive: Attempt to add invalid sensitive filter!");
@@ -134,6 +234,7 @@ void Geant4Sensitive::adopt_front(Geant4Filter* filter) {
   if (filter) {
     filter->addRef();
     m_filters.add_front(filter);
+    m_filterChain.reset();
     return;
   }
   throw runtime_error("Geant4Sensitive: Attempt to add invalid sensitive filter!");
@@ -141,10 +242,19 @@ void Geant4Sensitive::adopt_front(Geant4Filter* filter) {
 
 /// Callback before hit processing starts. Invoke all filters.
 bool Geant4Sensitive::accept(const G4Step* step) const {
+  if ( m_filterChain.isCompiled() )
+    return m_filterChain(step);
   bool result = m_filters.filter(&Geant4Filter::operator(), step);
   return result;
 }
 
+/// Compile the filters into a fused filter chain
+void Geant4Sensitive::compileFilters()   {
+  m_filterChain.compile(m_filters);
+  printout(DEBUG, name(), "+++ Filter chain: %ld filters, %ld fused.",
+           long(m_filters->size()), long(m_filters->size()-m_filterChain.numResidual()));
+}
+
 /// Access to the sensitive detector object
 void Geant4Sensitive::setDetector(Geant4ActionSD* sens_det) {
   m_sensitiveDetector = sens_det;
@@ -247,6 +357,12 @@ Geant4SensDetActionSequence::Geant4SensDetActionSequence(Geant4Context* ctxt, co
   m_sensitive = context()->lcdd().sensitiveDetector(nam);
   m_sensitiveType = m_sensitive.type();
   m_sensitive.setType("Geant4SensDet");
+  declareProperty("FuseFilters",    m_fuseFilters);
+  declareProperty("Instrument",     m_instrument);
+  declareProperty("SamplingPeriod", m_samplingPeriod);
+  declareProperty("Statistics",     m_statisticsValues);
+  context()->runAction().callAtBegin(this, &Geant4SensDetActionSequence::beginRun);
+  context()->runAction().callAtEnd(this, &Geant4SensDetActionSequence::endRun);
   InstanceCount::increment(this);
 }
 
@@ -277,6 +393,7 @@ void Geant4SensDetActionSequence::adopt(Geant4Sensitive* sensitive) {
   if (sensitive) {
     sensitive->addRef();
     m_actors.add(sensitive);
+    m_statistics.clear();
     return;
   }
   throw runtime_error("Geant4SensDetActionSequence: Attempt to add invalid sensitive actor!");
@@ -287,6 +404,7 @@ void Geant4SensDetActionSequence::adopt(Geant4Filter* filter) {
   if (filter) {
     filter->addRef();
     m_filters.add(filter);
+    m_filterChain.reset();
     return;
   }
   throw runtime_error("Geant4SensDetActionSequence: Attempt to add invalid sensitive filter!");
@@ -345,12 +463,34 @@ Geant4HitCollection* Geant4SensDetActionSequence::collectionByID(size_t id) cons
 
 /// Callback before hit processing starts. Invoke all filters.
 bool Geant4SensDetActionSequence::accept(const G4Step* step) const {
+  if ( m_filterChain.isCompiled() )
+    return m_filterChain(step);
   bool result = m_filters.filter(&Geant4Filter::operator(), step);
   return result;
 }
 
+/// Begin-of-run callback: compile the filter chains and reset the statistics
+void Geant4SensDetActionSequence::beginRun(const G4Run*)   {
+  if ( m_fuseFilters )  {
+    m_filterChain.compile(m_filters);
+    m_actors(&Geant4Sensitive::compileFilters);
+  }
+  m_statistics.reset();
+}
+
+/// End-of-run callback: print the statistics if instrumented
+void Geant4SensDetActionSequence::endRun(const G4Run*)   {
+  if ( m_instrument )  {
+    m_statistics.print(this);
+    m_statistics.publish(m_statisticsValues);
+  }
+}
+
 /// Function to process hits
 bool Geant4SensDetActionSequence::process(G4Step* step, G4TouchableHistory* hist) {
+  if ( m_instrument )  {
+    return processInstrumented(step, hist);
+  }
   bool result = false;
   for (vector<Geant4Sensitive*>::iterator i = m_actors->begin(); i != m_actors->end(); ++i) {
     Geant4Sensitive* s = *i;
@@ -361,6 +501,46 @@ bool Geant4SensDetActionSequence::process(G4Step* step, G4TouchableHistory* hist
   return result;
 }
 
+/// Hit processing recording the call counters, timing and hits
+bool Geant4SensDetActionSequence::processInstrumented(G4Step* step, G4TouchableHistory* hist) {
+  const vector<Geant4Sensitive*>& actors = m_actors;
+  const size_t ncalls = actors.size();
+  bool result = false;
+  if ( m_statistics.size() != ncalls+1 )  {
+    vector<string> names;
+    for (vector<Geant4Sensitive*>::const_iterator i = actors.begin(); i != actors.end(); ++i)
+      names.push_back((*i)->name());
+    names.push_back("Callbacks");
+    m_statistics.define(names);
+  }
+  m_statistics.setSamplingPeriod(m_samplingPeriod);
+  if ( m_statistics.dispatch() )  {
+    Geant4ActionStatistics::ticks_t start = Geant4ActionStatistics::ticks();
+    for (size_t i = 0; i < ncalls; ++i)  {
+      Geant4Sensitive* s = actors[i];
+      if (s->accept(step) && s->process(step, hist))  {
+        m_statistics.hit(i);
+        result = true;
+      }
+      start = m_statistics.record(i, start);
+    }
+    m_process(step, hist);
+    m_statistics.record(ncalls, start);
+    return result;
+  }
+  for (size_t i = 0; i < ncalls; ++i)  {
+    Geant4Sensitive* s = actors[i];
+    if (s->accept(step) && s->process(step, hist))  {
+      m_statistics.hit(i);
+      result = true;
+    }
+    m_statistics.count(i);
+  }
+  m_process(step, hist);
+  m_statistics.count(ncalls);
+  return result;
+}
+
 /** G4VSensitiveDetector interface: Method invoked at the begining of each event.
  *  The hits collection(s) created by this sensitive detector must
  *  be set to the G4HCofThisEvent object at one of these two methods.
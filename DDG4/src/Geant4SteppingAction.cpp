@@ -15,6 +15,7 @@
 // Framework include files
 #include "DD4hep/InstanceCount.h"
 #include "DDG4/Geant4SteppingAction.h"
+#include "DDG4/Geant4RunAction.h"
 // Geant4 headers
 #include "G4Threading.hh"
 #include "G4AutoLock.hh"
@@ -85,6 +86,11 @@ void Geant4SharedSteppingAction::operator()(const G4Step* s, G4SteppingManager*
 Geant4SteppingActionSequence::Geant4SteppingActionSequence(Geant4Context* ctxt, const string& nam)
 : Geant4Action(ctxt, nam) {
   m_needsControl = true;
+  declareProperty("Instrument",     m_instrument);
+  declareProperty("SamplingPeriod", m_samplingPeriod);
+  declareProperty("Statistics",     m_statisticsValues);
+  context()->runAction().callAtBegin(this, &Geant4SteppingActionSequence::beginRun);
+  context()->runAction().callAtEnd(this, &Geant4SteppingActionSequence::endRun);
   InstanceCount::increment(this);
 }
 
@@ -114,16 +120,64 @@ Geant4SteppingAction* Geant4SteppingActionSequence::get(const string& nam) const
 
 /// Pre-track action callback
 void Geant4SteppingActionSequence::operator()(const G4Step* step, G4SteppingManager* mgr) {
+  if ( m_instrument )  {
+    stepInstrumented(step, mgr);
+    return;
+  }
   m_actors(&Geant4SteppingAction::operator(), step, mgr);
   m_calls(step, mgr);
 }
 
+/// Stepping callback recording the call counters and timing
+void Geant4SteppingActionSequence::stepInstrumented(const G4Step* step, G4SteppingManager* mgr) {
+  const vector<Geant4SteppingAction*>& actors = m_actors;
+  const size_t ncalls = actors.size();
+  if ( m_statistics.size() != ncalls+1 )  {
+    vector<string> names;
+    for (vector<Geant4SteppingAction*>::const_iterator i = actors.begin(); i != actors.end(); ++i)
+      names.push_back((*i)->name());
+    names.push_back("Callbacks");
+    m_statistics.define(names);
+  }
+  m_statistics.setSamplingPeriod(m_samplingPeriod);
+  if ( m_statistics.dispatch() )  {
+    Geant4ActionStatistics::ticks_t start = Geant4ActionStatistics::ticks();
+    for (size_t i = 0; i < ncalls; ++i)  {
+      (*actors[i])(step, mgr);
+      start = m_statistics.record(i, start);
+    }
+    m_calls(step, mgr);
+    m_statistics.record(ncalls, start);
+    return;
+  }
+  for (size_t i = 0; i < ncalls; ++i)  {
+    (*actors[i])(step, mgr);
+    m_statistics.count(i);
+  }
+  m_calls(step, mgr);
+  m_statistics.count(ncalls);
+}
+
+/// Begin-of-run callback: reset the statistics
+void Geant4SteppingActionSequence::beginRun(const G4Run*)   {
+  m_statistics.reset();
+}
+
+/// End-of-run callback: print the statistics if instrumented
+void Geant4SteppingActionSequence::endRun(const G4Run*)   {
+  if ( m_instrument )  {
+    m_statistics.print(this);
+    m_statistics.publish(m_statisticsValues);
+  }
+}
+
 /// Add an actor responding to all callbacks. Sequence takes ownership.
 void Geant4SteppingActionSequence::adopt(Geant4SteppingAction* action) {
   if (action) {
     G4AutoLock protection_lock(&action_mutex);
     action->addRef();
     m_actors.add(action);
+    m_statistics.clear();
     return;
   }
   throw runtime_error("Geant4SteppingActionSequence: Attempt to add invalid actor!");
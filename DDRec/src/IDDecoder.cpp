@@ -11,6 +11,8 @@
 #include "DD4hep/LCDD.h"
 #include "DD4hep/VolumeManager.h"
 
+#include <algorithm>
+
 namespace DD4hep {
 namespace DDRec {
 
@@ -18,6 +20,7 @@ using Geometry::DetElement;
 using Geometry::LCDD;
 using Geometry::PlacedVolume;
 using Geometry::Readout;
+using Geometry::Segmentation;
 using Geometry::Solid;
 using Geometry::VolumeManager;
 using Geometry::Volume;
@@ -180,10 +183,16 @@ void IDDecoder::neighbours(const CellID& cell, set<CellID>& neighbour_cells) con
  * Checks if the given cell IDs are neighbours
  */
 bool IDDecoder::areNeighbours(const CellID& cell, const CellID& otherCellID) const {
-	set<CellID> neighbour_cells;
 	DetElement det = this->detectorElement(cell);
-	this->findReadout(det).segmentation().neighbours(cell, neighbour_cells);
-	return neighbour_cells.count(otherCellID) != 0;
+	Segmentation seg = this->findReadout(det).segmentation();
+	CellID buffer[32];
+	size_t n = seg.neighbours(cell, buffer, 32);
+	if (n > 32) {
+		set<CellID> neighbour_cells;
+		seg.neighbours(cell, neighbour_cells);
+		return neighbour_cells.count(otherCellID) != 0;
+	}
+	return std::find(buffer, buffer + n, otherCellID) != buffer + n;
 }
 
 /// Access to the barrel-endcap flag
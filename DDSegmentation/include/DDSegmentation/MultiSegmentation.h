@@ -49,6 +49,21 @@ namespace DD4hep {
       /// Debug flags
       int m_debug;
 
+      /// Direct lookup table indexed by (discriminator value - m_tableOffset)
+      std::vector<Segmentation*> m_table;
+      /// Discriminator value of the first entry of the direct lookup table
+      long           m_tableOffset;
+      /// Sub-segmentations sorted by key range for sparse, non-overlapping ranges
+      Segmentations  m_intervals;
+
+      /// Maximal span of discriminator values served by the direct lookup table
+      enum { MAX_TABLE_SIZE = 4096 };
+
+      /// Rebuild the lookup tables after the sub-segmentations changed
+      void buildLookup();
+      /// Lookup the sub-segmentation for a given discriminator value. Returns 0 if not found
+      Segmentation* lookup(long seg_id)  const;
+
     public:
       /// Default constructor passing the encoding string
       MultiSegmentation(const std::string& cellEncoding = "");
@@ -63,6 +78,9 @@ namespace DD4hep {
       virtual void addSubsegmentation(long key_min, long key_max, Segmentation* entry);
 
       /// Access subsegmentation by cell identifier
+      /** The lookup tables are built when adding sub-segmentations and not
+       *  modified afterwards. Concurrent lookups are therefore safe.
+       */
       const Segmentation& subsegmentation(const CellID& cellID) const;
 
       /// determine the position based on the cell ID
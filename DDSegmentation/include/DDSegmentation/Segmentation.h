@@ -13,6 +13,7 @@
 #include "DDSegmentation/SegmentationParameter.h"
 
 #include <map>
+#include <memory>
 #include <utility>
 #include <set>
 #include <string>
@@ -64,8 +65,51 @@ struct Vector3D {
 	double X, Y, Z;
 };
 
+class Segmentation;
+
+/// Precomputed neighbour table of a fixed set of cells
+/**
+ *  The table is stored in compressed sparse row format: the sorted cell IDs,
+ *  the offsets of their neighbour lists and the concatenated neighbour lists.
+ *  Only the index fields of the segmentation are stored, hence one table
+ *  serves all volumes sharing the segmentation.
+ *  Intended for readouts with a fixed cell layout, e.g. calorimeters.
+ */
+class NeighbourTable {
+public:
+	/// Default constructor
+	NeighbourTable();
+	/// Build the table for the given cells. Only neighbours, which are part of the cell set, are kept
+	void build(const Segmentation& segmentation, const std::vector<CellID>& cells);
+	/// Access the neighbours of a cell. Returns false if the cell is not part of the table
+	/** The neighbour IDs contain only the index fields. The other fields of the cell are ignored */
+	bool neighbours(const CellID& cellID, const CellID*& first, const CellID*& last) const;
+	/// Bit mask of the index fields stored in the table
+	CellID mask() const {
+		return _mask;
+	}
+	/// Number of cells in the table
+	size_t size() const {
+		return _cells.size();
+	}
+	/// Total number of neighbour entries
+	size_t numEntries() const {
+		return _neighbours.size();
+	}
+protected:
+	/// Bit mask of the index fields
+	CellID _mask;
+	/// The sorted cell IDs
+	std::vector<CellID> _cells;
+	/// Offsets of the neighbour lists of each cell. Size: number of cells + 1
+	std::vector<unsigned int> _offsets;
+	/// Concatenated neighbour lists
+	std::vector<CellID> _neighbours;
+};
+
 /// Base class for all segmentations
 class Segmentation {
+	friend class NeighbourTable;
 public:
 	/// Destructor
 	virtual ~Segmentation();
@@ -81,6 +125,24 @@ public:
 	virtual VolumeID volumeID(const CellID& cellID) const;
 	/// Calculates the neighbours of the given cell ID and adds them to the list of neighbours
 	virtual void neighbours(const CellID& cellID, std::set<CellID>& neighbours) const;
+	/** \brief Calculates the neighbours of the given cell ID without throwing exceptions
+
+	    \param cellID cell ID of the cell, for which the neighbours are requested
+	    \param buffer caller provided buffer receiving at most maxNeighbours cell IDs
+	    \param maxNeighbours the size of the buffer
+	    \return the number of neighbours. If larger than maxNeighbours the buffer was too small
+	*/
+	virtual size_t neighbours(const CellID& cellID, CellID* buffer, size_t maxNeighbours) const;
+	/// Restrict the index range of an identifier for the neighbour search, e.g. to the bounds known from the geometry
+	virtual void setIndexRange(const std::string& identifier, long64 minIndex, long64 maxIndex);
+	/// Attach a precomputed neighbour table. The segmentation takes ownership
+	virtual void setNeighbourTable(NeighbourTable* table);
+	/// Build the neighbour table for all cells within the index ranges of the identifiers
+	virtual void buildNeighbourTable();
+	/// Access the precomputed neighbour table (if any)
+	virtual const NeighbourTable* neighbourTable() const {
+		return _neighbourTable.get();
+	}
 	/// Access the encoding string
 	virtual std::string fieldDescription() const {
 		return _decoder->fieldDescription();
@@ -137,6 +199,13 @@ protected:
 	void registerIdentifier(const std::string& nam, const std::string& desc, std::string& ident,
 			const std::string& defaultVal);
 
+	/// Neighbour search based on the index identifiers and their ranges
+	size_t indexNeighbours(const CellID& cellID, CellID* buffer, size_t maxNeighbours) const;
+	/// Valid index range of an identifier: the range of the field, restricted by setIndexRange
+	void indexRange(const std::string& identifier, long64& minIndex, long64& maxIndex) const;
+	/// Bit mask of all index fields
+	CellID indexMask() const;
+
 	/// Helper method to convert a bin number to a 1D position
 	static double binToPosition(CellID bin, double cellSize, double offset = 0.);
 	/// Helper method to convert a 1D position to a cell ID
@@ -157,6 +226,10 @@ protected:
 	std::map<std::string, Parameter> _parameters;
 	/// The indices used for the encoding
 	std::map<std::string, StringParameter> _indexIdentifiers;
+	/// Restricted index ranges of identifiers used by the neighbour search
+	std::map<std::string, std::pair<long64, long64> > _indexRanges;
+	/// Optional precomputed neighbour table
+	std::unique_ptr<NeighbourTable> _neighbourTable;
 	/// The cell ID encoder and decoder
 	mutable BitField64* _decoder;
 	/// Keeps track of the decoder ownership
@@ -164,6 +237,8 @@ protected:
 private:
 	/// No copy constructor allowed
 	Segmentation(const Segmentation&);
+	/// No assignment operator allowed
+	Segmentation& operator=(const Segmentation&);
 };
 
 /// Macro to instantiate a new SegmentationCreator by its type name
@@ -6,6 +6,7 @@
  */
 
 #include "DDSegmentation/MultiSegmentation.h"
+#include <algorithm>
 #include <iomanip>
 #include <stdexcept>
 
@@ -16,7 +17,7 @@ namespace DD4hep {
 
     /// default constructor using an encoding string
     MultiSegmentation::MultiSegmentation(const string& cellEncoding)
-      :	Segmentation(cellEncoding), m_discriminator(0), m_debug(0)
+      :	Segmentation(cellEncoding), m_discriminator(0), m_debug(0), m_tableOffset(0)
     {
       // define type and description
       _type        = "MultiSegmentation";
@@ -27,7 +28,7 @@ namespace DD4hep {
 
     /// Default constructor used by derived classes passing an existing decoder
     MultiSegmentation::MultiSegmentation(BitField64* decode)
-      :	Segmentation(decode), m_discriminator(0), m_debug(0)
+      :	Segmentation(decode), m_discriminator(0), m_debug(0), m_tableOffset(0)
     {
       // define type and description
       _type        = "MultiSegmentation";
@@ -50,6 +51,71 @@ namespace DD4hep {
       e.key_max = key_max;
       e.segmentation = entry;
       m_segmentations.push_back(e);
+      buildLookup();
+    }
+
+    namespace {
+      bool key_less(const MultiSegmentation::Entry& a, const MultiSegmentation::Entry& b)  {
+        return a.key_min < b.key_min;
+      }
+    }
+
+    /// Rebuild the lookup tables after the sub-segmentations changed
+    void MultiSegmentation::buildLookup()   {
+      m_table.clear();
+      m_intervals.clear();
+      m_tableOffset = 0;
+      if ( m_segmentations.empty() )  {
+        return;
+      }
+      long kmin = m_segmentations.front().key_min, kmax = m_segmentations.front().key_max;
+      for(Segmentations::const_iterator i=m_segmentations.begin(); i != m_segmentations.end(); ++i)  {
+        kmin = std::min(kmin, (*i).key_min);
+        kmax = std::max(kmax, (*i).key_max);
+      }
+      // The span of the keys may exceed the range of long: compute it unsigned
+      unsigned long span = (unsigned long)kmax - (unsigned long)kmin;
+      if ( kmax >= kmin && span < MAX_TABLE_SIZE )  {
+        // Dense keys: direct lookup. Fill in reverse order so that the first matching entry wins
+        m_tableOffset = kmin;
+        m_table.assign(span + 1, 0);
+        for(Segmentations::const_reverse_iterator i=m_segmentations.rbegin(); i != m_segmentations.rend(); ++i)  {
+          if ( (*i).key_min > (*i).key_max ) continue;
+          unsigned long first = (unsigned long)(*i).key_min - (unsigned long)kmin;
+          unsigned long last  = (unsigned long)(*i).key_max - (unsigned long)kmin;
+          for(unsigned long k=first; k <= last; ++k)
+            m_table[k] = (*i).segmentation;
+        }
+        return;
+      }
+      // Sparse keys: binary search in the sorted ranges, provided they do not overlap
+      Segmentations sorted(m_segmentations);
+      std::stable_sort(sorted.begin(), sorted.end(), key_less);
+      for(size_t i=1; i<sorted.size(); ++i)  {
+        if ( sorted[i].key_min <= sorted[i-1].key_max ) return;  // Overlaps: fall back to linear search
+      }
+      m_intervals.swap(sorted);
+    }
+
+    /// Lookup the sub-segmentation for a given discriminator value. Returns 0 if not found
+    Segmentation* MultiSegmentation::lookup(long seg_id)  const   {
+      if ( !m_table.empty() )  {
+        unsigned long idx = (unsigned long)seg_id - (unsigned long)m_tableOffset;
+        return idx < m_table.size() ? m_table[idx] : 0;
+      }
+      if ( !m_intervals.empty() )  {
+        Entry e;
+        e.key_min = seg_id;
+        Segmentations::const_iterator i = std::upper_bound(m_intervals.begin(), m_intervals.end(), e, key_less);
+        if ( i == m_intervals.begin() ) return 0;
+        --i;
+        return seg_id <= (*i).key_max ? (*i).segmentation : 0;
+      }
+      for(Segmentations::const_iterator i=m_segmentations.begin(); i != m_segmentations.end(); ++i)  {
+        const Entry& e = *i; 
+        if ( e.key_min<= seg_id && e.key_max >= seg_id ) return e.segmentation;
+      }
+      return 0;
     }
 
     /// Set the underlying decoder
@@ -64,20 +130,17 @@ namespace DD4hep {
     const Segmentation& MultiSegmentation::subsegmentation(const CellID& cID)   const  {
       if ( m_discriminator )  {
         long seg_id = m_discriminator->value(cID);
-        for(Segmentations::const_iterator i=m_segmentations.begin(); i != m_segmentations.end(); ++i)  {
-          const Entry& e = *i; 
-          if ( e.key_min<= seg_id && e.key_max >= seg_id )   {
-            Segmentation* s = e.segmentation;
-            if ( m_debug > 0 )   {
-              cout << "MultiSegmentation: id:" << setw(4) << hex << seg_id << dec << "  " << s->name();
-              const Parameters& pars = s->parameters();
-              for(Parameters::const_iterator j=pars.begin(); j!=pars.end();++j)  {
-                cout << " " << (*j)->name() << "=" << (*j)->value();
-              }
-              cout << endl;
+        Segmentation* s = lookup(seg_id);
+        if ( s )   {
+          if ( m_debug > 0 )   {
+            cout << "MultiSegmentation: id:" << setw(4) << hex << seg_id << dec << "  " << s->name();
+            const Parameters& pars = s->parameters();
+            for(Parameters::const_iterator j=pars.begin(); j!=pars.end();++j)  {
+              cout << " " << (*j)->name() << "=" << (*j)->value();
             }
-            return *s;
+            cout << endl;
           }
+          return *s;
         }
       }
       throw runtime_error("MultiSegmentation: Invalid sub-segmentation identifier!");;
@@ -11,6 +11,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <cmath>
+#include <limits>
 #include <algorithm>
 #include <iomanip>
 
@@ -26,13 +27,13 @@ namespace DD4hep {
 
     /// Default constructor used by derived classes passing the encoding string
     Segmentation::Segmentation(const std::string& cellEncoding) :
-      _name("Segmentation"), _type("Segmentation"), _decoder(new BitField64(cellEncoding)), _ownsDecoder(true) {
+      _name("Segmentation"), _type("Segmentation"), _neighbourTable(), _decoder(new BitField64(cellEncoding)), _ownsDecoder(true) {
 
     }
 
     /// Default constructor used by derived classes passing an existing decoder
     Segmentation::Segmentation(BitField64* newDecoder) :
-      _name("Segmentation"), _type("Segmentation"), _decoder(newDecoder), _ownsDecoder(false) {
+      _name("Segmentation"), _type("Segmentation"), _neighbourTable(), _decoder(newDecoder), _ownsDecoder(false) {
     }
 
     /// Destructor
@@ -68,25 +69,211 @@ namespace DD4hep {
 
     /// Calculates the neighbours of the given cell ID and adds them to the list of neighbours
     void Segmentation::neighbours(const CellID& cID, std::set<CellID>& cellNeighbours) const {
+      CellID buffer[32];
+      size_t n = neighbours(cID, buffer, 32);
+      if (n <= 32) {
+        cellNeighbours.insert(buffer, buffer + n);
+        return;
+      }
+      vector<CellID> cells(n);
+      n = neighbours(cID, &cells[0], n);
+      cellNeighbours.insert(cells.begin(), cells.begin() + n);
+    }
+
+    /// Calculates the neighbours of the given cell ID without throwing exceptions
+    size_t Segmentation::neighbours(const CellID& cID, CellID* buffer, size_t maxNeighbours) const {
+      if (_neighbourTable) {
+        const CellID *first = 0, *last = 0;
+        if (_neighbourTable->neighbours(cID, first, last)) {
+          // the table only knows the index fields: keep all other fields of the cell
+          ulong64 others = ulong64(cID) & ~ulong64(_neighbourTable->mask());
+          size_t n = last - first;
+          for (size_t i = 0; i < n && i < maxNeighbours; ++i)
+            buffer[i] = CellID(others | ulong64(first[i]));
+          return n;
+        }
+      }
+      return indexNeighbours(cID, buffer, maxNeighbours);
+    }
+
+    /// Neighbour search based on the index identifiers and their ranges
+    size_t Segmentation::indexNeighbours(const CellID& cID, CellID* buffer, size_t maxNeighbours) const {
+      const BitField64& decoder = *_decoder;
+      size_t n = 0;
       map<std::string, StringParameter>::const_iterator it;
       for (it = _indexIdentifiers.begin(); it != _indexIdentifiers.end(); ++it) {
         const std::string& identifier = it->second->typedValue();
-        _decoder->setValue(cID);
-        int currentValue = (*_decoder)[identifier];
+        const BitFieldValue& field = decoder[identifier];
+        long64 minVal, maxVal;
+        indexRange(identifier, minVal, maxVal);
         // add both neighbouring cell IDs, don't add out of bound indices
-        try {
-          (*_decoder)[identifier] = currentValue - 1;
-          cellNeighbours.insert(_decoder->getValue());
-        } catch (runtime_error& e) {
-          // nothing to do
+        long64 currentValue = field.value(cID);
+        ulong64 others = ulong64(cID) & ~field.mask();
+        if (currentValue > minVal) {
+          if (n < maxNeighbours)
+            buffer[n] = CellID(others | ((ulong64(currentValue - 1) << field.offset()) & field.mask()));
+          ++n;
         }
-        try {
-          (*_decoder)[identifier] = currentValue + 1;
-          cellNeighbours.insert(_decoder->getValue());
-        } catch (runtime_error& e) {
-          // nothing to do
+        if (currentValue < maxVal) {
+          if (n < maxNeighbours)
+            buffer[n] = CellID(others | ((ulong64(currentValue + 1) << field.offset()) & field.mask()));
+          ++n;
         }
       }
+      return n;
+    }
+
+    /// Valid index range of an identifier: the range of the field, restricted by setIndexRange
+    void Segmentation::indexRange(const std::string& identifier, long64& minIndex, long64& maxIndex) const {
+      const BitFieldValue& field = (*_decoder)[identifier];
+      unsigned width = field.width();
+      minIndex = 0;
+      maxIndex = std::numeric_limits<long64>::max();
+      if (field.isSigned()) {
+        minIndex = width < 64 ? -(1LL << (width - 1)) : std::numeric_limits<long64>::min();
+        maxIndex = width < 64 ? (1LL << (width - 1)) - 1 : maxIndex;
+      } else if (width < 63) {
+        maxIndex = (1LL << width) - 1;
+      }
+      if (!_indexRanges.empty()) {
+        map<std::string, std::pair<long64, long64> >::const_iterator r = _indexRanges.find(identifier);
+        if (r != _indexRanges.end()) {
+          minIndex = std::max(minIndex, r->second.first);
+          maxIndex = std::min(maxIndex, r->second.second);
+        }
+      }
+    }
+
+    /// Bit mask of all index fields
+    CellID Segmentation::indexMask() const {
+      ulong64 mask = 0;
+      map<std::string, StringParameter>::const_iterator it;
+      for (it = _indexIdentifiers.begin(); it != _indexIdentifiers.end(); ++it) {
+        mask |= (*_decoder)[it->second->typedValue()].mask();
+      }
+      return CellID(mask);
+    }
+
+    /// Restrict the index range of an identifier for the neighbour search
+    void Segmentation::setIndexRange(const std::string& identifier, long64 minIndex, long64 maxIndex) {
+      map<std::string, StringParameter>::const_iterator it;
+      for (it = _indexIdentifiers.begin(); it != _indexIdentifiers.end(); ++it) {
+        if (it->second->typedValue() == identifier)
+          break;
+      }
+      if (it == _indexIdentifiers.end()) {
+        throw runtime_error("Unknown identifier " + identifier + " for segmentation type " + _type);
+      }
+      _indexRanges[identifier] = std::make_pair(minIndex, maxIndex);
+      // a table built for the old ranges is no longer valid
+      if (_neighbourTable) {
+        buildNeighbourTable();
+      }
+    }
+
+    /// Attach a precomputed neighbour table. The segmentation takes ownership
+    void Segmentation::setNeighbourTable(NeighbourTable* table) {
+      if (table != _neighbourTable.get()) {
+        _neighbourTable.reset(table);
+      }
+    }
+
+    /// Build the neighbour table for all cells within the index ranges of the identifiers
+    void Segmentation::buildNeighbourTable() {
+      static const double maxCells = double(1 << 22);
+      if (!_decoder) {
+        throw runtime_error("Cannot build the neighbour table of segmentation " + _name + " without decoder");
+      }
+      vector<const BitFieldValue*> fields;
+      vector<long64> minIndex, maxIndex;
+      double numCells = 1.;
+      map<std::string, StringParameter>::const_iterator it;
+      for (it = _indexIdentifiers.begin(); it != _indexIdentifiers.end(); ++it) {
+        const std::string& identifier = it->second->typedValue();
+        long64 minVal, maxVal;
+        indexRange(identifier, minVal, maxVal);
+        if (maxVal < minVal) {
+          throw runtime_error("Empty index range of identifier " + identifier + " in segmentation " + _name);
+        }
+        numCells *= double(maxVal) - double(minVal) + 1.;
+        fields.push_back(&(*_decoder)[identifier]);
+        minIndex.push_back(minVal);
+        maxIndex.push_back(maxVal);
+      }
+      if (numCells > maxCells) {
+        stringstream err;
+        err << "Segmentation " << _name << ": " << numCells << " cells are too many for a neighbour table. "
+            << "Restrict the index ranges with setIndexRange.";
+        throw runtime_error(err.str());
+      }
+      // enumerate all combinations of the index values
+      vector<CellID> cells;
+      cells.reserve(size_t(numCells));
+      vector<long64> index(minIndex);
+      for (;;) {
+        ulong64 cell = 0;
+        for (size_t i = 0; i < fields.size(); ++i) {
+          cell |= (ulong64(index[i]) << fields[i]->offset()) & fields[i]->mask();
+        }
+        cells.push_back(CellID(cell));
+        size_t i = 0;
+        for (; i < fields.size() && index[i] == maxIndex[i]; ++i) {
+          index[i] = minIndex[i];
+        }
+        if (i == fields.size()) {
+          break;
+        }
+        ++index[i];
+      }
+      std::unique_ptr<NeighbourTable> table(new NeighbourTable());
+      table->build(*this, cells);
+      _neighbourTable = std::move(table);
+    }
+
+    /// Default constructor
+    NeighbourTable::NeighbourTable() : _mask(0) {
+    }
+
+    /// Build the table for the given cells. Only neighbours, which are part of the cell set, are kept
+    void NeighbourTable::build(const Segmentation& segmentation, const std::vector<CellID>& cells) {
+      _mask = segmentation.indexMask();
+      _cells.clear();
+      _cells.reserve(cells.size());
+      for (vector<CellID>::const_iterator c = cells.begin(); c != cells.end(); ++c) {
+        _cells.push_back(CellID(ulong64(*c) & ulong64(_mask)));
+      }
+      std::sort(_cells.begin(), _cells.end());
+      _cells.erase(std::unique(_cells.begin(), _cells.end()), _cells.end());
+      _offsets.clear();
+      _neighbours.clear();
+      _offsets.reserve(_cells.size() + 1);
+      _neighbours.reserve(2 * _cells.size());
+      vector<CellID> buffer(8);
+      for (vector<CellID>::const_iterator c = _cells.begin(); c != _cells.end(); ++c) {
+        _offsets.push_back(_neighbours.size());
+        size_t n = segmentation.indexNeighbours(*c, &buffer[0], buffer.size());
+        if (n > buffer.size()) {
+          buffer.resize(n);
+          n = segmentation.indexNeighbours(*c, &buffer[0], buffer.size());
+        }
+        for (size_t i = 0; i < n; ++i) {
+          if (std::binary_search(_cells.begin(), _cells.end(), buffer[i]))
+            _neighbours.push_back(buffer[i]);
+        }
+      }
+      _offsets.push_back(_neighbours.size());
+    }
+
+    /// Access the neighbours of a cell. Returns false if the cell is not part of the table
+    bool NeighbourTable::neighbours(const CellID& cID, const CellID*& first, const CellID*& last) const {
+      CellID key = CellID(ulong64(cID) & ulong64(_mask));
+      vector<CellID>::const_iterator i = std::lower_bound(_cells.begin(), _cells.end(), key);
+      if (i == _cells.end() || *i != key)
+        return false;
+      size_t idx = i - _cells.begin();
+      first = _neighbours.data() + _offsets[idx];
+      last  = _neighbours.data() + _offsets[idx + 1];
+      return true;
     }
 
     /// Set the underlying decoder
@@ -97,6 +284,10 @@ namespace DD4hep {
         delete _decoder;
       _decoder = newDecoder;
       _ownsDecoder = false;
+      // the field layout may differ: rebuild the neighbour table
+      if (_neighbourTable) {
+        buildNeighbourTable();
+      }
     }
 
     /// Access to parameter by name
@@ -0,0 +1,394 @@
+//==========================================================================
+//  AIDA Detector description implementation for LCD
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+//
+//  Micro benchmarks of the DDCore/DDSegmentation hot paths:
+//    - BitField64 encoding and decoding
+//    - cellID/position/neighbours of the segmentations of all readouts
+//    - VolumeManager::lookupContext
+//    - IDDecoder
+//    - expression evaluation
+//
+//  usage: bench_ddcore -compact <file> [-repeat <n>] [-samples <n>]
+//                      [-output <file>] [-reference <file>] [-threshold <percent>]
+//
+//  The results are written as JSON, one benchmark per line, which allows
+//  to compare two runs (e.g. of two commits) with the -reference option.
+//  Benchmarks slower by more than the threshold w.r.t. the reference
+//  are flagged as regressions.
+//
+//==========================================================================
+#include "DD4hep/DDTest.h"
+
+#include "DD4hep/LCDD.h"
+#include "DD4hep/Handle.h"
+#include "DD4hep/DD4hepUnits.h"
+#include "DD4hep/Segmentations.h"
+#include "DD4hep/VolumeManager.h"
+#include "DD4hep/objects/VolumeManagerInterna.h"
+#include "DDRec/API/IDDecoder.h"
+#include "DDSegmentation/BitField64.h"
+
+#include <map>
+#include <set>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <exception>
+#include <algorithm>
+
+using namespace std ;
+using namespace DD4hep ;
+using namespace DD4hep::Geometry ;
+
+static DDTest test( "bench_ddcore" ) ;
+
+//=============================================================================
+
+namespace {
+
+  /// Result of one benchmark
+  struct BenchResult {
+    string name ;
+    size_t ops ;
+    double seconds ;
+    double nsPerOp() const { return ops ? 1e9*seconds/ops : 0 ; }
+  } ;
+
+  /// Sampled cells of one readout
+  struct ReadoutSample {
+    string               name ;
+    Segmentation         segmentation ;
+    vector<VolumeID>     volumeIDs ;
+    vector<CellID>       cellIDs ;
+    vector<Position>     local, global ;
+  } ;
+
+  vector<BenchResult> results ;
+  int                 repeat = 5 ;
+  /// Accumulated side effects, so that the compiler does not drop the work
+  volatile double     sink = 0 ;
+
+  /// Time the functor: best of 'repeat' runs, each performing 'ops' operations
+  template <typename F> void measure( const string& name, size_t ops, F func ){
+    typedef chrono::steady_clock clock ;
+    double best = 1e300 ;
+    func() ;  // warm up caches and lazy initialization
+    for( int i = 0 ; i < repeat ; ++i ){
+      clock::time_point start = clock::now() ;
+      sink = sink + func() ;
+      best = min( best, chrono::duration<double>( clock::now() - start ).count() ) ;
+    }
+    results.push_back( BenchResult{ name, ops, best } ) ;
+    printf( "%-56s %12zu ops %12.2f ns/op %14.0f ops/s\n", name.c_str(), ops,
+            results.back().nsPerOp(), best > 0 ? ops/best : 0 ) ;
+  }
+
+  /// Collect all volume identifiers known to a volume manager
+  void collectVolumes( VolumeManager mgr, set<VolumeID>& ids ){
+    VolumeManager::Object& o = *mgr.data<VolumeManager::Object>() ;
+    for( const auto& v : o.volumes )      ids.insert( v.first ) ;
+    for( const auto& m : o.managers )     collectVolumes( m.second, ids ) ;
+    for( const auto& s : o.subdetectors ) collectVolumes( s.second, ids ) ;
+  }
+
+  void benchBitField( size_t samples ){
+    DDSegmentation::BitField64 bf( "system:8,barrel:3,module:6,layer:8,slice:5,x:32:-16,y:-16" ) ;
+    const size_t nf = bf.size() ;
+    mt19937_64 rndm( 12345 ) ;
+    vector<long64> values( samples*nf ), ids( samples ) ;
+    for( size_t i = 0 ; i < samples ; ++i ){
+      for( size_t f = 0 ; f < nf ; ++f ){
+        const DDSegmentation::BitFieldValue& fv = bf[f] ;
+        long long range = 1LL << min( fv.width(), 15u ) ;
+        long long v = (long long)( rndm() % range ) ;
+        values[i*nf+f] = fv.isSigned() ? v - range/2 : v ;
+      }
+    }
+    measure( "BitField64/encode", samples*nf, [&](){
+        double s = 0 ;
+        for( size_t i = 0 ; i < samples ; ++i ){
+          bf.reset() ;
+          for( size_t f = 0 ; f < nf ; ++f ) bf[f] = values[i*nf+f] ;
+          ids[i] = bf.getValue() ;
+          s += ids[i] & 0xFF ;
+        }
+        return s ;
+      } ) ;
+    measure( "BitField64/decode", samples*nf, [&](){
+        double s = 0 ;
+        for( size_t i = 0 ; i < samples ; ++i ){
+          bf.setValue( ids[i] ) ;
+          for( size_t f = 0 ; f < nf ; ++f ) s += bf[f].value() ;
+        }
+        return s ;
+      } ) ;
+    measure( "BitField64/decode_external", samples*nf, [&](){
+        double s = 0 ;
+        for( size_t i = 0 ; i < samples ; ++i )
+          for( size_t f = 0 ; f < nf ; ++f ) s += bf[f].value( ids[i] ) ;
+        return s ;
+      } ) ;
+    // Round trip must be exact
+    size_t bad = 0 ;
+    for( size_t i = 0 ; i < samples ; ++i ){
+      bf.setValue( ids[i] ) ;
+      for( size_t f = 0 ; f < nf ; ++f ) bad += bf[f].value() != values[i*nf+f] ;
+    }
+    test( bad, size_t(0), " BitField64 encode/decode round trip" ) ;
+  }
+
+  void benchEvaluator( size_t samples ){
+    static const char* expressions[] = {
+      "3.5*cm", "2*pi/16", "sin(30*deg)*10*mm", "1.5*m + 2*cm - 0.3*mm", "sqrt(2)*tesla", "(12.5*mm)/2 + 0.05*mm"
+    } ;
+    const size_t n = sizeof(expressions)/sizeof(expressions[0]) ;
+    vector<string> exprs ;
+    for( size_t i = 0 ; i < samples ; ++i ) exprs.push_back( expressions[i%n] ) ;
+    measure( "Evaluator/toDouble", samples, [&](){
+        double s = 0 ;
+        for( const string& e : exprs ) s += _toDouble( e ) ;
+        return s ;
+      } ) ;
+    test( fabs( _toDouble( "3.5*cm" ) - 3.5*dd4hep::cm ) < 1e-12, " Evaluator result 3.5*cm" ) ;
+  }
+
+  /// Build the samples of all readouts with segmentation from the volume manager
+  vector<ReadoutSample> sampleReadouts( LCDD& lcdd, VolumeManager mgr, size_t samples ){
+    vector<ReadoutSample> readouts ;
+    mt19937_64 rndm( 4711 ) ;
+    uniform_real_distribution<double> flat( -1*dd4hep::cm, 1*dd4hep::cm ) ;
+    for( const auto& s : mgr.data<VolumeManager::Object>()->subdetectors ){
+      SensitiveDetector sd = lcdd.sensitiveDetector( s.first.name() ) ;
+      if( !sd.isValid() ) continue ;
+      Readout ro = sd.readout() ;
+      if( !ro.isValid() || !ro.segmentation().isValid() ) continue ;
+      set<VolumeID> ids ;
+      collectVolumes( s.second, ids ) ;
+      if( ids.empty() ) continue ;
+      ReadoutSample r ;
+      r.name         = ro.name() ;
+      r.segmentation = ro.segmentation() ;
+      vector<VolumeID> all( ids.begin(), ids.end() ) ;
+      for( size_t i = 0 ; i < samples ; ++i ){
+        VolumeID vid = all[ rndm() % all.size() ] ;
+        VolumeManager::Context* ctx = mgr.lookupContext( vid ) ;
+        if( !ctx ) continue ;
+        double l[3] = { flat(rndm), flat(rndm), flat(rndm) }, g[3] ;
+        ctx->toWorld.LocalToMaster( l, g ) ;
+        r.volumeIDs.push_back( vid ) ;
+        r.local.push_back( Position( l[0], l[1], l[2] ) ) ;
+        r.global.push_back( Position( g[0], g[1], g[2] ) ) ;
+      }
+      readouts.push_back( r ) ;
+    }
+    return readouts ;
+  }
+
+  void benchSegmentations( vector<ReadoutSample>& readouts ){
+    for( ReadoutSample& r : readouts ){
+      Segmentation seg = r.segmentation ;
+      const size_t n = r.volumeIDs.size() ;
+      const string prefix = "Segmentation/" + seg.type() + "/" + r.name ;
+      try{
+        r.cellIDs.resize( n ) ;
+        measure( prefix + "/cellID", n, [&](){
+            double s = 0 ;
+            for( size_t i = 0 ; i < n ; ++i ){
+              r.cellIDs[i] = seg.cellID( r.local[i], r.global[i], r.volumeIDs[i] ) ;
+              s += r.cellIDs[i] & 0xFF ;
+            }
+            return s ;
+          } ) ;
+        measure( prefix + "/position", n, [&](){
+            double s = 0 ;
+            for( size_t i = 0 ; i < n ; ++i ) s += seg.position( r.cellIDs[i] ).X() ;
+            return s ;
+          } ) ;
+        measure( prefix + "/neighbours", n, [&](){
+            CellID buffer[32] ;
+            double s = 0 ;
+            for( size_t i = 0 ; i < n ; ++i ) s += seg.neighbours( r.cellIDs[i], buffer, 32 ) ;
+            return s ;
+          } ) ;
+        size_t bad = 0 ;
+        for( size_t i = 0 ; i < n ; ++i ) bad += seg.volumeID( r.cellIDs[i] ) != r.volumeIDs[i] ;
+        test( bad, size_t(0), " " + prefix + " volume ID of the cell IDs" ) ;
+      }
+      catch( const exception& e ){
+        test.log( prefix + " skipped: " + e.what() ) ;
+      }
+    }
+  }
+
+  void benchVolumeManager( VolumeManager mgr, const vector<ReadoutSample>& readouts ){
+    vector<VolumeID> ids ;
+    for( const ReadoutSample& r : readouts ) ids.insert( ids.end(), r.cellIDs.begin(), r.cellIDs.end() ) ;
+    if( ids.empty() ) return ;
+    shuffle( ids.begin(), ids.end(), mt19937_64( 815 ) ) ;
+    measure( "VolumeManager/lookupContext", ids.size(), [&](){
+        double s = 0 ;
+        for( VolumeID id : ids ) s += mgr.lookupContext( id ) != 0 ;
+        return s ;
+      } ) ;
+    size_t bad = 0 ;
+    for( VolumeID id : ids ) bad += mgr.lookupContext( id ) == 0 ;
+    test( bad, size_t(0), " VolumeManager context found for all cell IDs" ) ;
+  }
+
+  void benchIDDecoder( const vector<ReadoutSample>& readouts, size_t samples ){
+    DDRec::IDDecoder& dec = DDRec::IDDecoder::getInstance() ;
+    vector<CellID>   ids ;
+    vector<Position> pos ;
+    for( const ReadoutSample& r : readouts ){
+      ids.insert( ids.end(), r.cellIDs.begin(), r.cellIDs.end() ) ;
+      pos.insert( pos.end(), r.global.begin(), r.global.end() ) ;
+    }
+    if( ids.empty() ) return ;
+    // The navigation based lookups are much slower: use fewer points
+    const size_t nnav = min( ids.size(), max( size_t(1), samples/10 ) ) ;
+    try{
+      measure( "IDDecoder/position", ids.size(), [&](){
+          double s = 0 ;
+          for( CellID id : ids ) s += dec.position( id ).Z() ;
+          return s ;
+        } ) ;
+      measure( "IDDecoder/volumeID", ids.size(), [&](){
+          double s = 0 ;
+          for( CellID id : ids ) s += dec.volumeID( id ) & 0xFF ;
+          return s ;
+        } ) ;
+      measure( "IDDecoder/detectorElement", ids.size(), [&](){
+          double s = 0 ;
+          for( CellID id : ids ) s += dec.detectorElement( id ).isValid() ;
+          return s ;
+        } ) ;
+      measure( "IDDecoder/cellID(global)", nnav, [&](){
+          double s = 0 ;
+          for( size_t i = 0 ; i < nnav ; ++i ){
+            try{ s += dec.cellID( pos[i] ) & 0xFF ; }
+            catch( const exception& ){ }  // points outside of sensitive volumes
+          }
+          return s ;
+        } ) ;
+    }
+    catch( const exception& e ){
+      test.log( string( "IDDecoder skipped: " ) + e.what() ) ;
+    }
+  }
+
+  /// Write the results: one JSON object per line
+  void writeResults( const string& fname, const string& compact ){
+    FILE* f = fname.empty() ? stdout : fopen( fname.c_str(), "w" ) ;
+    if( !f ){
+      test.error( "Cannot open output file " + fname ) ;
+      return ;
+    }
+    fprintf( f, "{\"compact\": \"%s\", \"repeat\": %d, \"results\": [\n", compact.c_str(), repeat ) ;
+    for( size_t i = 0 ; i < results.size() ; ++i ){
+      const BenchResult& r = results[i] ;
+      fprintf( f, "{\"name\": \"%s\", \"ops\": %zu, \"seconds\": %.9g, \"ns_per_op\": %.6g}%s\n",
+               r.name.c_str(), r.ops, r.seconds, r.nsPerOp(), i+1 < results.size() ? "," : "" ) ;
+    }
+    fprintf( f, "]}\n" ) ;
+    if( f != stdout ) fclose( f ) ;
+  }
+
+  /// Compare with the results of a previous run. Returns the number of regressions
+  size_t compareResults( const string& fname, double threshold ){
+    ifstream in( fname.c_str() ) ;
+    map<string,double> reference ;
+    string line ;
+    while( getline( in, line ) ){
+      size_t p = line.find( "{\"name\": \"" ), q = line.find( "\"ns_per_op\": " ) ;
+      if( p == string::npos || q == string::npos ) continue ;
+      p += 10 ;
+      reference[ line.substr( p, line.find( '"', p ) - p ) ] = atof( line.c_str() + q + 13 ) ;
+    }
+    if( reference.empty() ){
+      test.error( "No reference results found in " + fname ) ;
+      return 0 ;
+    }
+    size_t regressions = 0 ;
+    printf( "\n%-56s %12s %12s %9s\n", "Comparison with reference", "ref ns/op", "ns/op", "change" ) ;
+    for( const BenchResult& r : results ){
+      auto i = reference.find( r.name ) ;
+      if( i == reference.end() || i->second <= 0 ) continue ;
+      double change = 100.*( r.nsPerOp() - i->second ) / i->second ;
+      bool slow = change > threshold ;
+      regressions += slow ;
+      printf( "%-56s %12.2f %12.2f %+8.1f%%%s\n", r.name.c_str(), i->second, r.nsPerOp(), change,
+              slow ? "  REGRESSION" : "" ) ;
+    }
+    return regressions ;
+  }
+}
+
+//=============================================================================
+
+int main(int argc, char** argv ){
+
+  string compact, output, reference ;
+  size_t samples   = 100000 ;
+  double threshold = 10. ;
+  for( int i = 1 ; i < argc ; ++i ){
+    if     ( !strcmp( argv[i], "-compact" )   && i+1 < argc ) compact   = argv[++i] ;
+    else if( !strcmp( argv[i], "-output" )    && i+1 < argc ) output    = argv[++i] ;
+    else if( !strcmp( argv[i], "-reference" ) && i+1 < argc ) reference = argv[++i] ;
+    else if( !strcmp( argv[i], "-samples" )   && i+1 < argc ) samples   = strtoul( argv[++i], 0, 10 ) ;
+    else if( !strcmp( argv[i], "-repeat" )    && i+1 < argc ) repeat    = atoi( argv[++i] ) ;
+    else if( !strcmp( argv[i], "-threshold" ) && i+1 < argc ) threshold = atof( argv[++i] ) ;
+    else {
+      cout << " usage: bench_ddcore -compact <file> [-samples <n>] [-repeat <n>] [-output <file>]"
+           << " [-reference <file>] [-threshold <percent>]" << endl ;
+      exit(1) ;
+    }
+  }
+  if( compact.empty() || samples == 0 || repeat < 1 ){
+    cout << " usage: bench_ddcore -compact <file> ... (see source for options)" << endl ;
+    exit(1) ;
+  }
+
+  try{
+
+    LCDD& lcdd = LCDD::getInstance() ;
+    lcdd.fromCompact( compact ) ;
+    VolumeManager mgr = VolumeManager::getVolumeManager( lcdd ) ;
+
+    benchBitField( samples ) ;
+    benchEvaluator( samples ) ;
+    vector<ReadoutSample> readouts = sampleReadouts( lcdd, mgr, samples ) ;
+    test( !readouts.empty(), " Geometry has readouts with segmentation" ) ;
+    benchSegmentations( readouts ) ;
+    benchVolumeManager( mgr, readouts ) ;
+    benchIDDecoder( readouts, samples ) ;
+
+    writeResults( output, compact ) ;
+    if( !reference.empty() ){
+      size_t regressions = compareResults( reference, threshold ) ;
+      test.log( to_string( regressions ) + " benchmarks slower than the reference by more than "
+                + to_string( threshold ) + " %" ) ;
+    }
+
+  } catch( exception &e ){
+
+    test.log( e.what() );
+    test.error( "exception occurred" );
+  }
+
+  return 0;
+}
+
+//=============================================================================
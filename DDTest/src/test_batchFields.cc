@@ -0,0 +1,168 @@
+#include "DD4hep/DDTest.h"
+#include "DD4hep/Fields.h"
+#include "DD4hep/FieldTypes.h"
+
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <vector>
+
+using namespace std ;
+using namespace DD4hep ;
+using namespace DD4hep::Geometry ;
+
+// this should be the first line in your test
+static DDTest test( "batchFields" ) ;
+
+//=============================================================================
+
+typedef vector<double> Points ;
+
+/// Add the point (x,y,z)
+static void add( Points& p, double x, double y, double z ){
+  p.push_back( x ) ;
+  p.push_back( y ) ;
+  p.push_back( z ) ;
+}
+
+/// Add points on a circle of radius r at many angles, and just inside and outside of it
+static void add_circle( Points& p, double r, double z ){
+  for( int i=0 ; i<64 ; ++i ){
+    double a = 0.1 + i * 0.0981 ;
+    double x = r * std::cos( a ), y = r * std::sin( a ) ;
+    add( p, x, y, z ) ;
+    add( p, std::nextafter( x, 0.0 ), y, z ) ;
+    add( p, std::nextafter( x, 2.0*x ), y, z ) ;
+  }
+  add( p, r, 0.0, z ) ;
+  add( p, 0.0, -r, z ) ;
+}
+
+/// Number of components for which the batch call differs from the single point call
+template <typename SINGLE, typename BATCH>
+static int mismatches( const Points& pos, SINGLE single, BATCH batch ){
+  size_t n = pos.size() / 3 ;
+  vector<double> one( 3*n, 0e0 ), many( 3*n, 0e0 ) ;
+  for( size_t i=0 ; i<n ; ++i ) single( &pos[3*i], &one[3*i] ) ;
+  batch( n, &pos[0], &many[0] ) ;
+  int count = 0 ;
+  for( size_t i=0 ; i<3*n ; ++i ){
+    if( one[i] != many[i] ){
+      if( count < 5 ) cout << "   Mismatch at point " << i/3 << " component " << i%3
+			   << ": " << one[i] << " != " << many[i] << endl ;
+      ++count ;
+    }
+  }
+  return count ;
+}
+
+/// Compare the batch and the single point calls of a field
+static int mismatches( const Points& pos, CartesianField f ){
+  return mismatches( pos,
+		     [&f]( const double* p, double* b ){ f.value( p, b ) ; },
+		     [&f]( size_t n, const double* p, double* b ){ f.values( n, p, b ) ; } ) ;
+}
+
+/// Compare the batch and the single point calls of the magnetic overlay field
+static int mismatches( const Points& pos, OverlayedField f ){
+  return mismatches( pos,
+		     [&f]( const double* p, double* b ){ f.magneticField( p, b ) ; },
+		     [&f]( size_t n, const double* p, double* b ){ f.magneticFields( n, p, b ) ; } ) ;
+}
+
+int main(int /* argc */, char** /* argv */ ){
+
+  try{
+
+    // ----- write your tests in here -------------------------------------
+
+    test.log( "test batch computation of field components" );
+
+    // radii for which comparing squared radii would differ on the boundaries
+    const double r_inner = 173.3, r_outer = 333.3, z_min = -400.1, z_max = 530.3 ;
+
+    CartesianField constant ;
+    ConstantField* c = new ConstantField() ;
+    c->type = CartesianField::MAGNETIC ;
+    c->direction.SetXYZ( 0.1, -0.2, 0.5 ) ;
+    constant.assign( c, "constant", "ConstantField" ) ;
+
+    CartesianField solenoid ;
+    SolenoidField* s = new SolenoidField() ;
+    s->innerField  = 4.0 ;
+    s->outerField  = -1.5 ;
+    s->innerRadius = r_inner ;
+    s->outerRadius = r_outer ;
+    s->minZ        = z_min ;
+    s->maxZ        = z_max ;
+    solenoid.assign( s, "solenoid", "solenoid" ) ;
+
+    Points pos ;
+    // inside the inner and the outer region
+    add( pos, 0.0, 0.0, 0.0 ) ;
+    add( pos, 50.0, -70.0, 100.0 ) ;
+    add( pos, 200.0, 100.0, -200.0 ) ;
+    add( pos, -110.0, -250.0, 400.0 ) ;
+    // on and close to the radial boundaries
+    add_circle( pos, r_inner, 30.0 ) ;
+    add_circle( pos, r_outer, -30.0 ) ;
+    // on and close to the boundaries in z
+    const double z_bounds[] = { z_min, z_max } ;
+    for( double z : z_bounds ){
+      add( pos, 50.0, 50.0, z ) ;
+      add( pos, 250.0, 50.0, z ) ;
+      add( pos, 50.0, 50.0, std::nextafter( z, 0.0 ) ) ;
+      add( pos, 250.0, 50.0, std::nextafter( z, 0.0 ) ) ;
+      add( pos, 50.0, 50.0, std::nextafter( z, 2.0*z ) ) ;
+    }
+    // outside of both regions
+    add( pos, 1000.0, 0.0, 0.0 ) ;
+    add( pos, 50.0, 50.0, 10000.0 ) ;
+    add( pos, 50.0, 50.0, -10000.0 ) ;
+    add( pos, 1000.0, 1000.0, 10000.0 ) ;
+
+    // make sure the points cover all regions
+    size_t n = pos.size() / 3, inner = 0, outer = 0, outside = 0 ;
+    vector<double> b( 3*n, 0e0 ) ;
+    for( size_t i=0 ; i<n ; ++i ){
+      solenoid.value( &pos[3*i], &b[3*i] ) ;
+      if( b[3*i+2] == s->innerField ) ++inner ;
+      else if( b[3*i+2] == s->outerField ) ++outer ;
+      else ++outside ;
+    }
+    test( inner > 0 && outer > 0 && outside > 0 , " points inside the inner and outer region and outside " ) ;
+
+    test( mismatches( pos, constant ) , 0 , " constant field: batch agrees with single points " ) ;
+    test( mismatches( pos, solenoid ) , 0 , " solenoid field: batch agrees with single points " ) ;
+
+    // the field is added: non-zero start values must be kept
+    vector<double> one( 3*n, 1.5 ), many( 3*n, 1.5 ) ;
+    for( size_t i=0 ; i<n ; ++i ) solenoid.value( &pos[3*i], &one[3*i] ) ;
+    solenoid.values( n, &pos[0], &many[0] ) ;
+    test( one == many , " solenoid field: batch adds to the given field " ) ;
+
+    // overlay with a single component
+    OverlayedField single( "single" ) ;
+    single.add( solenoid ) ;
+    test( mismatches( pos, single ) , 0 , " overlay of one field: batch agrees with single points " ) ;
+
+    // overlay with several components
+    OverlayedField overlay( "overlay" ) ;
+    overlay.add( constant ) ;
+    overlay.add( solenoid ) ;
+    test( mismatches( pos, overlay ) , 0 , " overlay of two fields: batch agrees with single points " ) ;
+
+    // --------------------------------------------------------------------
+
+
+  } catch( exception &e ){
+    //} catch( ... ){
+
+    test.log( e.what() );
+    test.error( "exception occurred" );
+  }
+
+  return 0;
+}
+
+//=============================================================================
@@ -0,0 +1,166 @@
+#include "DD4hep/DDTest.h"
+#include "JSON/DocumentHandler.h"
+
+#include <exception>
+#include <iostream>
+#include <cstring>
+#include <string>
+
+using namespace std ;
+using namespace DD4hep ;
+using namespace DD4hep::JSON ;
+
+// this should be the first line in your test
+static DDTest test( "json_parser" ) ;
+
+//=============================================================================
+
+/// Access a member of a JSON object by name
+static const JsonElement* member( const JsonElement* e, const char* tag ){
+  for( const JsonElement* c = e ? e->child : 0 ; c ; c = c->next )
+    if( ::strcmp( c->tag, tag ) == 0 ) return c ;
+  throw runtime_error( string("missing member: ")+tag ) ;
+}
+
+/// Access an array item by index
+static const JsonElement* item( const JsonElement* e, unsigned int idx ){
+  const JsonElement* c = e ? e->child : 0 ;
+  for( unsigned int i=0 ; c && i<idx ; ++i ) c = c->next ;
+  if( !c ) throw runtime_error( "missing array item" ) ;
+  return c ;
+}
+
+/// Parse a document and return the error message (empty if the document is valid)
+static string parse_error( const string& text ){
+  try{
+    DocumentHolder doc( DocumentHandler().parse( text.c_str(), text.length() ) ) ;
+  } catch( const exception& e ){
+    return e.what() ;
+  }
+  return "" ;
+}
+
+/// Check that parsing fails with the given message at the given position "line:column: message"
+static void check_error( const string& text, const string& expected ){
+  string err = parse_error( text ), txt = text.substr( 0, 24 ) ;
+  for( size_t i = txt.find( '\n' ) ; i != string::npos ; i = txt.find( '\n' ) ) txt.replace( i, 1, "\\n" ) ;
+  test( err.find( expected ) != string::npos && err.find( "<string>:" ) != string::npos ,
+        " malformed " + txt + " -> '" + expected + "' got: '" + err + "'" ) ;
+}
+
+/// Nested arrays: depth levels below the top level array
+static string nested( int depth ){
+  return string( depth+1, '[' ) + string( depth+1, ']' ) ;
+}
+
+int main(int argc, char** argv ){
+
+  try{
+
+    // ----- write your tests in here -------------------------------------
+
+    test.log( "test json parser" );
+
+    if( argc < 2 ) {
+      test.fatal_error( "usage: test_json_parser <DDTest source directory>" ) ;
+    }
+    string dir = argv[1] + string( "/inputFiles/" ) ;
+
+    // ---- valid document from file
+    DocumentHolder doc( DocumentHandler().load( dir + "json_valid.json" ) ) ;
+    const JsonElement* root = doc.ptr() ;
+
+    test( root->type , (unsigned int)JsonElement::JSON_OBJECT , " root is an object " ) ;
+    test( root->numChildren , 5u , " root has 5 members " ) ;
+
+    const JsonElement* esc = member( root, "escapes" ) ;
+    test( string( member( esc, "quote"     )->text ) , string( "a\"b" )        , " escape \\\" " ) ;
+    test( string( member( esc, "backslash" )->text ) , string( "a\\b" )        , " escape \\\\ " ) ;
+    test( string( member( esc, "solidus"   )->text ) , string( "a/b" )         , " escape \\/ " ) ;
+    test( string( member( esc, "controls"  )->text ) == "\b\f\n\r\t"     , " escapes \\b\\f\\n\\r\\t " ) ;
+    test( string( member( esc, "latin"     )->text ) , string( "caf\xC3\xA9" ) , " unicode escape 2 byte UTF-8 " ) ;
+    test( string( member( esc, "euro"      )->text ) , string( "\xE2\x82\xAC" ) , " unicode escape 3 byte UTF-8 " ) ;
+    test( string( member( esc, "surrogate" )->text ) , string( "\xF0\x9F\x98\x80" ) , " unicode surrogate pair 4 byte UTF-8 " ) ;
+    test( string( member( esc, "empty"     )->text ) , string( "" )            , " empty string " ) ;
+    test( member( esc, "empty" )->type , (unsigned int)JsonElement::JSON_STRING , " empty string type " ) ;
+
+    // ---- number edge cases: the text is terminated in place, the value converted
+    const JsonElement* num = member( root, "numbers" ) ;
+    test( num->numChildren , 10u , " 10 numbers " ) ;
+    test( string( item( num, 0 )->text ) , string( "0" )            , " number text 0 " ) ;
+    test( string( item( num, 1 )->text ) , string( "-0" )           , " number text -0 " ) ;
+    test( string( item( num, 4 )->text ) , string( "1.5e3" )        , " number text 1.5e3 " ) ;
+    test( string( item( num, 9 )->text ) , string( "123456789012" ) , " number text before blank " ) ;
+    test( item( num, 0 )->number , 0.0     , " number 0 " ) ;
+    test( item( num, 2 )->number , 7.0     , " number 7 " ) ;
+    test( item( num, 3 )->number , -12.0   , " number -12 " ) ;
+    test( item( num, 4 )->number , 1500.0  , " number 1.5e3 " ) ;
+    test( item( num, 5 )->number , -2.25e-2, " number -2.25E-2 " ) ;
+    test( item( num, 6 )->number , 100.0   , " number 1E+2 " ) ;
+    test( item( num, 7 )->number , 0.125   , " number 0.125 " ) ;
+    test( item( num, 8 )->number , 1e308   , " number 1e308 " ) ;
+    test( item( num, 9 )->number , 123456789012.0 , " number 123456789012 " ) ;
+    test( item( num, 2 )->type , (unsigned int)JsonElement::JSON_NUMBER , " number type " ) ;
+    test( member( root, "last" )->number , 1.0 , " number directly before '}' " ) ;
+
+    const JsonElement* lit = member( root, "literals" ) ;
+    test( item( lit, 0 )->type , (unsigned int)JsonElement::JSON_TRUE  , " literal true " ) ;
+    test( item( lit, 1 )->type , (unsigned int)JsonElement::JSON_FALSE , " literal false " ) ;
+    test( item( lit, 2 )->type , (unsigned int)JsonElement::JSON_NULL  , " literal null " ) ;
+
+    const JsonElement* nst = member( member( root, "nested" ), "a" ) ;
+    test( nst->numChildren , 3u , " nested array size " ) ;
+    test( item( nst, 0 )->numChildren , 0u , " empty array " ) ;
+    test( item( nst, 1 )->type , (unsigned int)JsonElement::JSON_OBJECT , " empty object " ) ;
+    test( item( member( item( item( nst, 2 ), 0 ), "b" ), 0 )->number , 1.0 , " deeply nested value " ) ;
+
+    // ---- nesting depth: 512 levels below the top level are accepted
+    test( parse_error( nested( 512 ) ) , string( "" ) , " nesting at the depth limit " ) ;
+    check_error( nested( 513 ) , ":1:515: Maximal nesting depth exceeded" ) ;
+
+    // ---- malformed documents and error positions (line:column)
+    check_error( ""                 , ":1:1: Expected '{' or '['" ) ;
+    check_error( "  \"a\""          , ":1:3: Expected '{' or '['" ) ;
+    check_error( "{\"a\":1,}"       , ":1:8: Expected member name" ) ;
+    check_error( "{\"a\" 1}"        , ":1:6: Expected ':'" ) ;
+    check_error( "{\"a\":1 \"b\":2}", ":1:8: Expected ',' or '}'" ) ;
+    check_error( "[1 2]"            , ":1:4: Expected ',' or ']'" ) ;
+    check_error( "[01]"             , ":1:3: Expected ',' or ']'" ) ;
+    check_error( "[-]"              , ":1:3: Invalid number" ) ;
+    check_error( "[.5]"             , ":1:2: Invalid number" ) ;
+    check_error( "[1.]"             , ":1:4: Invalid number" ) ;
+    check_error( "[1e]"             , ":1:4: Invalid number" ) ;
+    check_error( "[1e+]"            , ":1:5: Invalid number" ) ;
+    check_error( "[tru]"            , ":1:2: Invalid literal" ) ;
+    check_error( "[\"abc"           , ":1:6: Unterminated string" ) ;
+    check_error( "[\"a\\x\"]"       , ":1:5: Invalid escape sequence" ) ;
+    check_error( "[\"\\u12G4\"]"    , ":1:7: Invalid unicode escape sequence" ) ;
+    check_error( "[\"\\ud800\"]"    , ":1:9: Invalid unicode surrogate pair" ) ;
+    check_error( "[\"\\ud800\\u0041\"]", ":1:15: Invalid unicode surrogate pair" ) ;
+    check_error( "{}}"              , ":1:3: Garbage after end of document" ) ;
+    check_error( "[1]\n x"          , ":2:2: Garbage after end of document" ) ;
+
+    // ---- error position in a multi-line file
+    string err ;
+    try{
+      DocumentHolder bad( DocumentHandler().load( dir + "json_malformed.json" ) ) ;
+    } catch( const exception& e ){
+      err = e.what() ;
+    }
+    test( err.find( "json_malformed.json:4:25: Expected ',' or ']'" ) != string::npos ,
+          " error position in file: '" + err + "'" ) ;
+
+    // --------------------------------------------------------------------
+
+
+  } catch( exception &e ){
+    //} catch( ... ){
+
+    test.log( e.what() );
+    test.error( "exception occurred" );
+  }
+
+  return 0;
+}
+
+//=============================================================================
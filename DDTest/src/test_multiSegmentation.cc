@@ -0,0 +1,148 @@
+#include "DD4hep/DDTest.h"
+#include <climits>
+#include <exception>
+#include <iostream>
+#include <vector>
+
+#include "DDSegmentation/CartesianGridXY.h"
+#include "DDSegmentation/MultiSegmentation.h"
+
+
+using namespace std ;
+using namespace DD4hep ;
+using namespace DDSegmentation ;
+
+// this should be the first line in your test
+static DDTest test( "multiSegmentation" ) ;
+
+//=============================================================================
+
+/// Multi-segmentation giving access to the lookup of the sub-segmentations
+class TestMultiSegmentation : public MultiSegmentation {
+public:
+  TestMultiSegmentation() : MultiSegmentation( "system:8,key:-16,x:-8,y:-8" ) {}
+  using MultiSegmentation::lookup ;
+  /// Add a sub-segmentation for the key range [key_min, key_max]
+  Segmentation* add( long key_min, long key_max ){
+    Segmentation* s = new CartesianGridXY( "system:8,key:-16,x:-8,y:-8" ) ;
+    addSubsegmentation( key_min, key_max, s ) ;
+    return s ;
+  }
+  bool dense()  const { return !m_table.empty() ; }
+  bool sparse() const { return !m_intervals.empty() ; }
+  /// The linear search used before the lookup tables: the first matching range wins
+  Segmentation* linear( long seg_id ) const {
+    for( const Entry& e : m_segmentations ){
+      if( e.key_min <= seg_id && e.key_max >= seg_id ) return e.segmentation ;
+    }
+    return 0 ;
+  }
+};
+
+/// Number of keys for which the lookup differs from the linear search
+static int mismatches( const TestMultiSegmentation& seg, const vector<long>& keys ){
+  int count = 0 ;
+  for( long k : keys ){
+    if( seg.lookup( k ) != seg.linear( k ) ) ++count ;
+  }
+  return count ;
+}
+
+/// All keys in [first, last]
+static vector<long> key_range( long first, long last ){
+  vector<long> keys ;
+  for( long k=first ; k<=last ; ++k ) keys.push_back( k ) ;
+  return keys ;
+}
+
+int main(int /* argc */, char** /* argv */ ){
+
+  try{
+
+    // ----- write your tests in here -------------------------------------
+
+    test.log( "test lookup of multi-segmentation sub-segmentations" );
+
+    // ---- dense ranges with a gap: direct lookup table
+    {
+      TestMultiSegmentation seg ;
+      Segmentation* a = seg.add( 0, 3 ) ;
+      Segmentation* b = seg.add( 4, 9 ) ;
+      seg.add( 12, 12 ) ;
+      test( seg.dense() , " dense ranges use the lookup table " ) ;
+      test( mismatches( seg, key_range( -5, 20 ) ) , 0 , " dense lookup agrees with linear search " ) ;
+      test( seg.lookup( 3 ) == a && seg.lookup( 4 ) == b , " dense range boundaries " ) ;
+      test( seg.lookup( 10 ) == 0 && seg.lookup( -1 ) == 0 && seg.lookup( 13 ) == 0 , " dense keys outside the ranges " ) ;
+      test( seg.lookup( LONG_MIN ) == 0 && seg.lookup( LONG_MAX ) == 0 , " dense lookup of extreme keys " ) ;
+    }
+
+    // ---- dense overlapping ranges: the first matching range wins
+    {
+      TestMultiSegmentation seg ;
+      Segmentation* a = seg.add( 0, 10 ) ;
+      Segmentation* b = seg.add( 5, 15 ) ;
+      test( seg.dense() , " dense overlapping ranges use the lookup table " ) ;
+      test( mismatches( seg, key_range( -2, 17 ) ) , 0 , " dense overlapping lookup agrees with linear search " ) ;
+      test( seg.lookup( 7 ) == a && seg.lookup( 11 ) == b , " dense overlap: first match wins " ) ;
+    }
+
+    // ---- sparse ranges: binary search
+    vector<long> sparse_keys ;
+    const long sparse_bounds[] = { -50000, -49990, 0, 5, 100000, 100010 } ;
+    for( long b : sparse_bounds ){
+      for( long k=b-2 ; k<=b+2 ; ++k ) sparse_keys.push_back( k ) ;
+    }
+    {
+      TestMultiSegmentation seg ;
+      seg.add( 0, 5 ) ;
+      seg.add( 100000, 100010 ) ;
+      seg.add( -50000, -49990 ) ;
+      test( !seg.dense() && seg.sparse() , " sparse ranges use the binary search " ) ;
+      test( mismatches( seg, sparse_keys ) , 0 , " sparse lookup agrees with linear search " ) ;
+      test( seg.lookup( 100005 ) != 0 && seg.lookup( 50000 ) == 0 , " sparse lookup inside and between the ranges " ) ;
+    }
+
+    // ---- sparse overlapping ranges: linear search, the first matching range wins
+    {
+      TestMultiSegmentation seg ;
+      Segmentation* a = seg.add( 0, 10 ) ;
+      Segmentation* b = seg.add( 5, 100000 ) ;
+      seg.add( -50000, -49990 ) ;
+      test( !seg.dense() && !seg.sparse() , " sparse overlapping ranges use the linear search " ) ;
+      test( mismatches( seg, sparse_keys ) , 0 , " sparse overlapping lookup agrees with linear search " ) ;
+      test( seg.lookup( 7 ) == a && seg.lookup( 11 ) == b , " sparse overlap: first match wins " ) ;
+    }
+
+    // ---- ranges at the limits of long: the span of the keys does not fit into long
+    {
+      TestMultiSegmentation seg ;
+      Segmentation* a = seg.add( LONG_MIN, LONG_MIN+1 ) ;
+      Segmentation* b = seg.add( LONG_MAX-1, LONG_MAX ) ;
+      test( !seg.dense() , " full span of long does not use the lookup table " ) ;
+      vector<long> keys = { LONG_MIN, LONG_MIN+1, LONG_MIN+2, -1, 0, 1, LONG_MAX-2, LONG_MAX-1, LONG_MAX } ;
+      test( mismatches( seg, keys ) , 0 , " extreme ranges agree with linear search " ) ;
+      test( seg.lookup( LONG_MIN ) == a && seg.lookup( LONG_MAX ) == b , " extreme range boundaries " ) ;
+    }
+    {
+      TestMultiSegmentation seg ;
+      Segmentation* a = seg.add( LONG_MAX-3, LONG_MAX ) ;
+      test( seg.dense() , " small range at the maximum of long uses the lookup table " ) ;
+      vector<long> keys = { LONG_MIN, -1, 0, LONG_MAX-4, LONG_MAX-3, LONG_MAX-1, LONG_MAX } ;
+      test( mismatches( seg, keys ) , 0 , " range at the maximum of long agrees with linear search " ) ;
+      test( seg.lookup( LONG_MAX ) == a , " lookup of the maximum of long " ) ;
+    }
+
+    // --------------------------------------------------------------------
+
+
+  } catch( exception &e ){
+    //} catch( ... ){
+
+    test.log( e.what() );
+    test.error( "exception occurred" );
+  }
+
+  return 0;
+}
+
+//=============================================================================
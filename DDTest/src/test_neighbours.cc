@@ -0,0 +1,170 @@
+#include "DD4hep/DDTest.h"
+#include <exception>
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include "DDSegmentation/BitField64.h"
+#include "DDSegmentation/CartesianGridXY.h"
+
+
+using namespace std ;
+using namespace DD4hep ;
+using namespace DDSegmentation ;
+
+// this should be the first line in your test
+static DDTest test( "neighbours" ) ;
+
+//=============================================================================
+
+/// Encode a cell of the test layout
+static CellID cell( BitField64& bf, int layer, int x, int y ){
+  bf.setValue( 0 ) ;
+  bf["system"] = 3 ;
+  bf["layer"]  = layer ;
+  bf["x"]      = x ;
+  bf["y"]      = y ;
+  return bf.getValue() ;
+}
+
+/// Neighbours of a cell from the buffer interface as a set
+static set<CellID> neighbours( const Segmentation& seg, CellID id ){
+  CellID buffer[8] ;
+  size_t n = seg.neighbours( id, buffer, 8 ) ;
+  return set<CellID>( buffer, buffer + n ) ;
+}
+
+int main(int /* argc */, char** /* argv */ ){
+
+  try{
+
+    // ----- write your tests in here -------------------------------------
+
+    test.log( "test segmentation neighbours" );
+
+    // x: signed 4 bit [-8,7], y: unsigned 4 bit [0,15]
+    const string encoding( "system:8,layer:4,x:-4,y:4" ) ;
+    BitField64 bf( encoding ) ;
+    CartesianGridXY seg( encoding ) ;
+
+    CellID buffer[8] ;
+
+    // ---- interior cell: two neighbours per index, all other fields kept
+    CellID c = cell( bf, 2, 0, 5 ) ;
+    set<CellID> nb = neighbours( seg, c ) ;
+    test( nb.size() , size_t(4) , " interior cell has 4 neighbours " ) ;
+    test( nb.count( cell( bf, 2, -1, 5 ) ) == 1 , " interior cell: x-1 " ) ;
+    test( nb.count( cell( bf, 2,  1, 5 ) ) == 1 , " interior cell: x+1 " ) ;
+    test( nb.count( cell( bf, 2,  0, 4 ) ) == 1 , " interior cell: y-1 " ) ;
+    test( nb.count( cell( bf, 2,  0, 6 ) ) == 1 , " interior cell: y+1 " ) ;
+
+    set<CellID> nbset ;
+    seg.neighbours( c, nbset ) ;
+    test( nbset == nb , " set interface agrees with buffer interface " ) ;
+
+    // ---- field boundaries: no wrap around into the other end of the field
+    nb = neighbours( seg, cell( bf, 2, -8, 5 ) ) ;
+    test( nb.size() , size_t(3) , " signed field minimum has 3 neighbours " ) ;
+    test( nb.count( cell( bf, 2, 7, 5 ) ) == 0 , " signed field minimum does not wrap " ) ;
+
+    nb = neighbours( seg, cell( bf, 2, 7, 5 ) ) ;
+    test( nb.size() , size_t(3) , " signed field maximum has 3 neighbours " ) ;
+    test( nb.count( cell( bf, 2, -8, 5 ) ) == 0 , " signed field maximum does not wrap " ) ;
+
+    nb = neighbours( seg, cell( bf, 2, 0, 0 ) ) ;
+    test( nb.size() , size_t(3) , " unsigned field minimum has 3 neighbours " ) ;
+    test( nb.count( cell( bf, 2, 0, 15 ) ) == 0 , " unsigned field minimum does not wrap " ) ;
+
+    nb = neighbours( seg, cell( bf, 2, 7, 15 ) ) ;
+    test( nb.size() , size_t(2) , " corner cell has 2 neighbours " ) ;
+    test( nb.count( cell( bf, 2, 6, 15 ) ) == 1 && nb.count( cell( bf, 2, 7, 14 ) ) == 1 ,
+	  " corner cell neighbours " ) ;
+
+    // ---- buffer too small: the full count is returned, the buffer is not overrun
+    buffer[2] = -1 ;
+    test( seg.neighbours( c, buffer, 2 ) , size_t(4) , " small buffer returns the full count " ) ;
+    test( buffer[2] , CellID(-1) , " small buffer is not overrun " ) ;
+    test( seg.neighbours( c, buffer, 0 ) , size_t(4) , " empty buffer returns the full count " ) ;
+
+    // ---- restricted index ranges
+    seg.setIndexRange( "x", -2, 2 ) ;
+    seg.setIndexRange( "y", 0, 3 ) ;
+    nb = neighbours( seg, cell( bf, 2, 2, 3 ) ) ;
+    test( nb.size() , size_t(2) , " corner of the restricted range has 2 neighbours " ) ;
+    test( nb.count( cell( bf, 2, 3, 3 ) ) == 0 && nb.count( cell( bf, 2, 2, 4 ) ) == 0 ,
+	  " no neighbours outside the restricted range " ) ;
+
+    bool thrown = false ;
+    try{
+      seg.setIndexRange( "z", 0, 1 ) ;
+    } catch( const exception& ){
+      thrown = true ;
+    }
+    test( thrown , " unknown identifier is rejected " ) ;
+
+    // ---- CSR neighbour table of the restricted ranges
+    CartesianGridXY ref( encoding ) ;
+    ref.setIndexRange( "x", -2, 2 ) ;
+    ref.setIndexRange( "y", 0, 3 ) ;
+
+    test( seg.neighbourTable() == 0 , " no table before the build " ) ;
+    seg.buildNeighbourTable() ;
+    const NeighbourTable* table = seg.neighbourTable() ;
+    test( table != 0 , " table built " ) ;
+    if( table ){
+      test( table->size() , size_t(20) , " table has 5x4 cells " ) ;
+      // x: 4 links per row in 4 rows, y: 3 links per column in 5 columns, both directions
+      test( table->numEntries() , size_t(62) , " table has 62 neighbour entries " ) ;
+      test( table->mask() , CellID( bf["x"].mask() | bf["y"].mask() ) , " table mask covers the index fields " ) ;
+
+      const CellID *first = 0, *last = 0 ;
+      test( table->neighbours( cell( bf, 0, -2, 0 ), first, last ) , " corner cell found in the table " ) ;
+      test( size_t( last - first ) , size_t(2) , " corner cell has 2 entries in the table " ) ;
+      test( table->neighbours( cell( bf, 0, 3, 0 ), first, last ) , false , " cell outside the ranges not in the table " ) ;
+    }
+
+    // the table lookup must give the same result as the index search for all volumes
+    int mismatches = 0 ;
+    for( int layer=0 ; layer<16 ; layer += 5 ){
+      for( int x=-2 ; x<=2 ; ++x ){
+	for( int y=0 ; y<=3 ; ++y ){
+	  CellID id = cell( bf, layer, x, y ) ;
+	  if( neighbours( seg, id ) != neighbours( ref, id ) ) ++mismatches ;
+	}
+      }
+    }
+    test( mismatches , 0 , " table lookup agrees with index search " ) ;
+
+    // cells outside the table fall back to the index search
+    test( neighbours( seg, cell( bf, 1, 6, 9 ) ) == neighbours( ref, cell( bf, 1, 6, 9 ) ) ,
+	  " cell outside the table uses the index search " ) ;
+
+    // changing the ranges rebuilds the table
+    seg.setIndexRange( "y", 0, 1 ) ;
+    test( seg.neighbourTable() != 0 && seg.neighbourTable()->size() == 10 , " table rebuilt after range change " ) ;
+
+    // ---- too many cells for a table
+    CartesianGridXY large( "system:8,x:-16,y:16" ) ;
+    thrown = false ;
+    try{
+      large.buildNeighbourTable() ;
+    } catch( const exception& ){
+      thrown = true ;
+    }
+    test( thrown , " table of unrestricted 16 bit fields is rejected " ) ;
+    test( large.neighbourTable() == 0 , " no table after failed build " ) ;
+
+    // --------------------------------------------------------------------
+
+
+  } catch( exception &e ){
+    //} catch( ... ){
+
+    test.log( e.what() );
+    test.error( "exception occurred" );
+  }
+
+  return 0;
+}
+
+//=============================================================================
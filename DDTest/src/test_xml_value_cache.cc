@@ -0,0 +1,108 @@
+#include "DD4hep/DDTest.h"
+#include "XML/Evaluator.h"
+#include "XML/XMLElements.h"
+#include "XML/DocumentHandler.h"
+
+#include <exception>
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+using namespace std ;
+using namespace DD4hep ;
+using namespace DD4hep::XML ;
+
+namespace DD4hep {
+  XmlTools::Evaluator& evaluator();
+}
+
+// this should be the first line in your test
+static DDTest test( "xml_value_cache" ) ;
+
+//=============================================================================
+
+int main(int /* argc */, char** /* argv */ ){
+
+  try{
+
+    // ----- write your tests in here -------------------------------------
+
+    test.log( "test caching of converted xml values" );
+
+    XmlTools::Evaluator& ev = DD4hep::evaluator() ;
+    ev.setVariable( "cache_width", 2.0 ) ;
+
+    Strng_t expr( "cache_width*3" ) ;
+    test( _toDouble( expr ) , 6.0 , " first evaluation " ) ;
+
+    unsigned long gen = ev.generation() ;
+    test( _toDouble( expr ) , 6.0 , " cached evaluation " ) ;
+    test( _toInt( expr )    , 6   , " cached evaluation as int " ) ;
+    test( ev.generation() , gen , " evaluations do not change the generation " ) ;
+
+    // ---- changing the dictionary invalidates the cached values
+    ev.setVariable( "cache_width", 5.0 ) ;
+    test( ev.generation() != gen , " setVariable changes the generation " ) ;
+    test( _toDouble( expr ) , 15.0 , " re-evaluated after generation change " ) ;
+    test( _toLong( expr )   , 15L  , " re-evaluated as long after generation change " ) ;
+
+    gen = ev.generation() ;
+    _toDictionary( Strng_t( "cache_width" ) , Strng_t( "7" ) ) ;
+    test( ev.generation() != gen , " _toDictionary changes the generation " ) ;
+    test( _toDouble( expr ) , 21.0 , " re-evaluated after _toDictionary " ) ;
+
+    // ---- casts are removed: the cast and the plain value must not share the result
+    Strng_t cast( "(int)cache_width*2" ) ;
+    test( _toInt( cast )  , 14 , " (int) cast as int " ) ;
+    test( _toLong( cast ) , 14L , " (int) cast as long " ) ;
+
+    // ---- equal text in another buffer shares the entry
+    {
+      Strng_t copy( "cache_width*3" ) ;
+      test( _toDouble( copy ) , 21.0 , " same text in a different buffer " ) ;
+    }
+
+    // ---- temporaries with different text, possibly at the same address
+    for( int i=0 ; i<10 ; ++i ){
+      Strng_t tmp( to_string( i ) + "*cache_width" ) ;
+      test( _toDouble( tmp ) , 7.0*i , " temporary " + to_string( i ) + "*cache_width" ) ;
+    }
+
+    // ---- attributes of documents released and re-parsed
+    for( int i=0 ; i<3 ; ++i ){
+      string xml = "<root value=\"cache_width*" + to_string( i ) + "\" name=\"n" + to_string( i ) + "\"/>" ;
+      DocumentHolder doc( DocumentHandler().parse( xml.c_str(), xml.length() ) ) ;
+      Handle_t root = doc.root() ;
+      test( root.attr<double>( Strng_t( "value" ) ) , 7.0*i , " attribute of document " + to_string( i ) ) ;
+      test( root.attr<string>( Strng_t( "name" ) ) , "n" + to_string( i ) , " string attribute of document " + to_string( i ) ) ;
+    }
+
+    // ---- environment references are not cached: ::setenv does not change the generation
+    Strng_t env( "${DD4HEP_XML_VALUE_CACHE_TEST}" ) ;
+    ::setenv( "DD4HEP_XML_VALUE_CACHE_TEST", "3", 1 ) ;
+    test( _toInt( env ) , 3 , " environment reference " ) ;
+    test( _toString( env ) , string( "3" ) , " environment reference as string " ) ;
+    gen = ev.generation() ;
+    ::setenv( "DD4HEP_XML_VALUE_CACHE_TEST", "4", 1 ) ;
+    test( ev.generation() , gen , " setenv does not change the generation " ) ;
+    test( _toInt( env ) , 4 , " environment reference after setenv " ) ;
+    test( _toString( env ) , string( "4" ) , " environment reference as string after setenv " ) ;
+    ::unsetenv( "DD4HEP_XML_VALUE_CACHE_TEST" ) ;
+
+    ev.setVariable( "cache_width", 1.0 ) ;
+    test( _toDouble( expr ) , 3.0 , " re-evaluated after final change " ) ;
+
+    // --------------------------------------------------------------------
+
+
+  } catch( exception &e ){
+    //} catch( ... ){
+
+    test.log( e.what() );
+    test.error( "exception occurred" );
+  }
+
+  return 0;
+}
+
+//=============================================================================
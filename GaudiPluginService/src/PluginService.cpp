@@ -23,6 +23,13 @@
 
 #include <cxxabi.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cstring>
+#include <sstream>
+#include <vector>
+#include <map>
 
 #if  defined(__GXX_EXPERIMENTAL_CXX0X__) || __cplusplus >= 201103L 
 #define REG_SCOPE_LOCK \
@@ -109,6 +116,229 @@ namespace {
   std::string old_style_name(const std::string& name) {
     return std::for_each(name.begin(), name.end(), OldStyleCnv()).name;
   }
+
+  /// Modification time of a file in nanoseconds
+  inline long long modificationTime(const struct stat& buf) {
+#ifdef APPLE
+    return (long long)buf.st_mtimespec.tv_sec*1000000000LL + buf.st_mtimespec.tv_nsec;
+#else
+    return (long long)buf.st_mtim.tv_sec*1000000000LL + buf.st_mtim.tv_nsec;
+#endif
+  }
+
+  /// Cached content of one directory of the library search path.
+  /// The directory entry is valid as long as the directory and all
+  /// contained *.components files keep their modification time and size.
+  struct DirectoryIndex {
+    struct File {
+      std::string name;
+      long long   mtime;
+      long long   size;
+    };
+    typedef std::vector<File> Files;
+    /// Pairs (library, factory) in the order of the components files
+    typedef std::vector<std::pair<std::string, std::string> > Factories;
+    long long   mtime;   ///< -1: directory does not exist, -2: never scanned
+    Files       files;
+    Factories   factories;
+    DirectoryIndex() : mtime(-2) {}
+  };
+  typedef std::map<std::string, DirectoryIndex> DirectoryIndexMap;
+
+  /// Magic word of the binary factory index file
+  const char s_indexMagic[8] = {'D','D','4','P','L','I','D','X'};
+  /// Version of the binary factory index file
+  const unsigned int s_indexVersion = 1;
+
+  /// Check that a cached directory entry is still up to date
+  bool isValid(const std::string& dirName, const DirectoryIndex& dir) {
+    struct stat buf;
+    if (dir.mtime == -2) return false;
+    if (::stat(dirName.c_str(), &buf) != 0) return dir.mtime == -1;
+    if (modificationTime(buf) != dir.mtime) return false;
+    for (DirectoryIndex::Files::const_iterator i = dir.files.begin();
+         i != dir.files.end(); ++i) {
+      if (::stat((dirName + '/' + i->name).c_str(), &buf) != 0) return false;
+      if (modificationTime(buf) != i->mtime || buf.st_size != i->size) return false;
+    }
+    return true;
+  }
+
+  /// Read all "*.components" files of a directory into the directory index
+  void scanDirectory(const std::string& dirName, DirectoryIndex& index) {
+    using Gaudi::PluginService::Details::logger;
+    using Gaudi::PluginService::Details::Logger;
+    struct stat dir_buf;
+    index = DirectoryIndex();
+    if (::stat(dirName.c_str(), &dir_buf) != 0) {
+      index.mtime = -1;
+      return;
+    }
+    index.mtime = modificationTime(dir_buf);
+    // look for files called "*.components" in the directory
+    DIR *dir = opendir(dirName.c_str());
+    if (dir) {
+      struct dirent * entry;
+      while ((entry = readdir(dir))) {
+        std::string name(entry->d_name);
+        // check if the file name ends with ".components"
+        std::string::size_type extpos = name.find(".components");
+        if ((extpos != std::string::npos) &&
+            ((extpos+11) == name.size())) {
+          std::string fullPath = (dirName + '/' + name);
+          struct stat buf;
+          { // check if it is a regular file
+            if (stat(fullPath.c_str(), &buf) != 0) continue;
+            if (!S_ISREG(buf.st_mode)) continue;
+          }
+          DirectoryIndex::File file = {name, modificationTime(buf), (long long)buf.st_size};
+          index.files.push_back(file);
+          // read the file
+          logger().debug(std::string("  reading ") + name);
+          std::ifstream facts(fullPath.c_str());
+          std::string line;
+          int factoriesCount = 0;
+          int lineCount = 0;
+          while (!facts.eof()) {
+            ++lineCount;
+            std::getline(facts, line);
+            trim(line);
+            // skip empty lines and lines starting with '#'
+            if (line.empty() || line[0] == '#') continue;
+            // look for the separator
+            std::string::size_type other_pos = line.find(':');
+            if (other_pos == std::string::npos) {
+              std::ostringstream o;
+              o << "failed to parse line " << fullPath
+                << ':' << lineCount;
+              logger().warning(o.str());
+              continue;
+            }
+            index.factories.push_back(std::make_pair(std::string(line, 0, other_pos),
+                                                     std::string(line, other_pos+1)));
+            ++factoriesCount;
+          }
+          if (logger().level() <= Logger::Debug) {
+            std::ostringstream o;
+            o << "  found " << factoriesCount << " factories";
+            logger().debug(o.str());
+          }
+        }
+      }
+      closedir(dir);
+    }
+  }
+
+  /// Helpers to serialize the factory index
+  inline void putNumber(std::string& buf, long long value) {
+    buf.append((const char*)&value, sizeof(value));
+  }
+  inline void putString(std::string& buf, const std::string& value) {
+    putNumber(buf, value.size());
+    buf.append(value);
+  }
+  /// Helper to deserialize the factory index from the mapped file
+  struct IndexReader {
+    const char* ptr;
+    const char* end;
+    bool getNumber(long long& value) {
+      if (end - ptr < (long)sizeof(value)) return false;
+      ::memcpy(&value, ptr, sizeof(value));
+      ptr += sizeof(value);
+      return true;
+    }
+    bool getString(std::string& value) {
+      long long len;
+      if (!getNumber(len) || len < 0 || end - ptr < len) return false;
+      value.assign(ptr, len);
+      ptr += len;
+      return true;
+    }
+  };
+
+  /// Read the binary factory index. On failure the index is left empty.
+  bool readIndex(const std::string& fname, DirectoryIndexMap& index) {
+    int fd = ::open(fname.c_str(), O_RDONLY);
+    if (fd == -1) return false;
+    struct stat buf;
+    if (::fstat(fd, &buf) != 0 || buf.st_size < (off_t)(sizeof(s_indexMagic)+sizeof(long long))) {
+      ::close(fd);
+      return false;
+    }
+    void* mem = ::mmap(0, buf.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mem == MAP_FAILED) return false;
+    IndexReader rdr = {(const char*)mem, (const char*)mem + buf.st_size};
+    long long version = 0, ndirs = 0;
+    bool ok = ::memcmp(rdr.ptr, s_indexMagic, sizeof(s_indexMagic)) == 0;
+    rdr.ptr += sizeof(s_indexMagic);
+    ok = ok && rdr.getNumber(version) && version == s_indexVersion && rdr.getNumber(ndirs);
+    for (long long i = 0; ok && i < ndirs; ++i) {
+      std::string name;
+      long long nfiles = 0, nfacts = 0;
+      ok = rdr.getString(name);
+      DirectoryIndex& dir = index[name];
+      ok = ok && rdr.getNumber(dir.mtime) && rdr.getNumber(nfiles);
+      for (long long j = 0; ok && j < nfiles; ++j) {
+        DirectoryIndex::File file;
+        ok = rdr.getString(file.name) && rdr.getNumber(file.mtime) && rdr.getNumber(file.size);
+        dir.files.push_back(file);
+      }
+      ok = ok && rdr.getNumber(nfacts);
+      for (long long j = 0; ok && j < nfacts; ++j) {
+        std::pair<std::string, std::string> fact;
+        ok = rdr.getString(fact.first) && rdr.getString(fact.second);
+        dir.factories.push_back(fact);
+      }
+    }
+    ::munmap(mem, buf.st_size);
+    if (!ok) {
+      Gaudi::PluginService::Details::logger().warning("ignoring invalid factory index " + fname);
+      index.clear();
+    }
+    return ok;
+  }
+
+  /// Write the binary factory index. The file is replaced atomically,
+  /// so that concurrent jobs always see a consistent index.
+  bool writeIndex(const std::string& fname, const DirectoryIndexMap& index) {
+    std::string buf(s_indexMagic, sizeof(s_indexMagic));
+    putNumber(buf, s_indexVersion);
+    putNumber(buf, index.size());
+    for (DirectoryIndexMap::const_iterator i = index.begin(); i != index.end(); ++i) {
+      const DirectoryIndex& dir = i->second;
+      putString(buf, i->first);
+      putNumber(buf, dir.mtime);
+      putNumber(buf, dir.files.size());
+      for (DirectoryIndex::Files::const_iterator j = dir.files.begin(); j != dir.files.end(); ++j) {
+        putString(buf, j->name);
+        putNumber(buf, j->mtime);
+        putNumber(buf, j->size);
+      }
+      putNumber(buf, dir.factories.size());
+      for (DirectoryIndex::Factories::const_iterator j = dir.factories.begin(); j != dir.factories.end(); ++j) {
+        putString(buf, j->first);
+        putString(buf, j->second);
+      }
+    }
+    std::ostringstream tmp;
+    tmp << fname << '.' << ::getpid() << ".tmp";
+    int fd = ::open(tmp.str().c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) return false;
+    const char* p = buf.c_str();
+    size_t len = buf.size();
+    while (len > 0) {
+      ssize_t n = ::write(fd, p, len);
+      if (n <= 0) break;
+      p += n;
+      len -= n;
+    }
+    if (::close(fd) != 0 || len != 0 || ::rename(tmp.str().c_str(), fname.c_str()) != 0) {
+      ::unlink(tmp.str().c_str());
+      return false;
+    }
+    return true;
+  }
 }
 
 namespace Gaudi { namespace PluginService {
@@ -174,6 +404,13 @@ namespace Gaudi { namespace PluginService {
       char *search_path = ::getenv(envVar);
       if (search_path) {
         logger().debug(std::string("searching factories in ") + envVar);
+        // optional binary cache of the content of the search path
+        const char* index_file = ::getenv("DD4HEP_PLUGIN_INDEX");
+        DirectoryIndexMap index;
+        bool index_dirty = false;
+        if (index_file && *index_file) {
+          if (!readIndex(index_file, index)) index_dirty = true;
+        }
         std::string path(search_path);
         std::string::size_type pos = 0;
         std::string::size_type newpos = 0;
@@ -189,76 +426,41 @@ namespace Gaudi { namespace PluginService {
             pos = newpos;
           }
           logger().debug(std::string(" looking into ") + dirName);
-          // look for files called "*.components" in the directory
-          DIR *dir = opendir(dirName.c_str());
-          if (dir) {
-            struct dirent * entry;
-            while ((entry = readdir(dir))) {
-              std::string name(entry->d_name);
-              // check if the file name ends with ".components"
-              std::string::size_type extpos = name.find(".components");
-              if ((extpos != std::string::npos) &&
-                  ((extpos+11) == name.size())) {
-                std::string fullPath = (dirName + '/' + name);
-                { // check if it is a regular file
-                  struct stat buf;
-                  stat(fullPath.c_str(), &buf);
-                  if (!S_ISREG(buf.st_mode)) continue;
-                }
-                // read the file
-                logger().debug(std::string("  reading ") + name);
-                std::ifstream facts(fullPath.c_str());
-                std::string line;
-                int factoriesCount = 0;
-                int lineCount = 0;
-                while (!facts.eof()) {
-                  ++lineCount;
-                  std::getline(facts, line);
-                  trim(line);
-                  // skip empty lines and lines starting with '#'
-                  if (line.empty() || line[0] == '#') continue;
-                  // look for the separator
-                  std::string::size_type other_pos = line.find(':');
-                  if (other_pos == std::string::npos) {
-                    std::ostringstream o;
-                    o << "failed to parse line " << fullPath
-                      << ':' << lineCount;
-                    logger().warning(o.str());
-                    continue;
-                  }
-
-                  const std::string lib(line, 0, other_pos);
-                  const std::string fact(line, other_pos+1);
-
+          DirectoryIndex& dir = index[dirName];
+          if (!index_file || !isValid(dirName, dir)) {
+            scanDirectory(dirName, dir);
+            index_dirty = true;
+          }
+          else {
+            logger().debug(std::string("  using index for ") + dirName);
+          }
+          for (DirectoryIndex::Factories::const_iterator i = dir.factories.begin();
+               i != dir.factories.end(); ++i) {
+            const std::string& lib  = i->first;
+            const std::string& fact = i->second;
 #ifdef APPLE
-		  //fg: on macos >10.11 we cannot rely on DYLD_LIBRARY_PATH any more
-		  //    and therefore store the complete path to the lib for the dlopen call
-                  m_factories.insert(std::make_pair(fact, FactoryInfo(  std::string(dirName + "/" + lib ) )));
+            //fg: on macos >10.11 we cannot rely on DYLD_LIBRARY_PATH any more
+            //    and therefore store the complete path to the lib for the dlopen call
+            m_factories.insert(std::make_pair(fact, FactoryInfo(  std::string(dirName + "/" + lib ) )));
 #else
-                  m_factories.insert(std::make_pair(fact, FactoryInfo(lib)));
+            m_factories.insert(std::make_pair(fact, FactoryInfo(lib)));
 #endif
 
 #ifdef GAUDI_REFLEX_COMPONENT_ALIASES
-                  // add an alias for the factory using the Reflex convention
-                  std::string old_name = old_style_name(fact);
-                  if (fact != old_name) {
-                    FactoryInfo old_info(lib);
-                    old_info.properties["ReflexName"] = "true";
-                    m_factories.insert(std::make_pair(old_name, old_info));
-                  }
-#endif
-                  ++factoriesCount;
-                }
-                if (logger().level() <= Logger::Debug) {
-                  std::ostringstream o;
-                  o << "  found " << factoriesCount << " factories";
-                  logger().debug(o.str());
-                }
-              }
+            // add an alias for the factory using the Reflex convention
+            std::string old_name = old_style_name(fact);
+            if (fact != old_name) {
+              FactoryInfo old_info(lib);
+              old_info.properties["ReflexName"] = "true";
+              m_factories.insert(std::make_pair(old_name, old_info));
             }
-            closedir(dir);
+#endif
           }
         }
+        if (index_file && *index_file && index_dirty) {
+          if (!writeIndex(index_file, index))
+            logger().warning(std::string("cannot write factory index ") + index_file);
+        }
       }
     }
 
@@ -10,7 +10,18 @@
 //==========================================================================
 //
 //  Simple program to dump the B-field of the world volume in a cartesian grid
-// 
+//
+//  The field is evaluated row by row (along z) with the batch interface
+//  OverlayedField::magneticFields using several threads.
+//  Optionally the field map is written to a compact binary file:
+//      char[8]     magic "DDBFIELD"
+//      int         version, spare
+//      long long   nx, ny, nz
+//      double      x0, y0, z0, dx, dy, dz        [cm]
+//      float       Bx, By, Bz [Tesla] for nx*ny*nz points (z index runs fastest)
+//  A binary file written earlier may be used as reference to compare
+//  two field configurations point by point.
+//
 //  Author     : F.Gaede, DESY
 //  Date       : 29 Mar 2017
 //==========================================================================
@@ -19,65 +30,240 @@
 #include "DD4hep/LCDD.h"
 #include "DD4hep/DD4hepUnits.h"
 
+// C/C++ include files
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
 using namespace std ;
 using namespace DD4hep ;
 using namespace DD4hep::Geometry;
 
 //=============================================================================
 
+namespace {
 
-static int invoke_dump_B_field(int argc, char** argv ){
-  
-  if( argc != 8 ) {
-    std::cout << " usage: dumpBfield compact.xml x y z dx dy dz [in cm]" << std::endl 
-	      << "    will dump the B-field in volume [-x:x,-y:y,-z,z] with steps [dx,dy,dz] "
-	      << std::endl ;
-    
+  /// Header of the binary field map
+  struct FieldMapHeader  {
+    char      magic[8];
+    int       version;
+    int       spare;
+    long long n[3];
+    double    origin[3];
+    double    step[3];
+  };
+
+  /// Difference statistics of the comparison with a reference map
+  struct FieldDiff  {
+    unsigned long long count = 0, above = 0;
+    double sum = 0, sum2 = 0, max = -1;
+    double where[3] = {0, 0, 0};
+    void add(const FieldDiff& d)  {
+      count += d.count;
+      above += d.above;
+      sum   += d.sum;
+      sum2  += d.sum2;
+      if ( d.max > max )  {
+        max = d.max;
+        ::memcpy(where, d.where, sizeof(where));
+      }
+    }
+  };
+
+  void usage()  {
+    std::cout << " usage: dumpBfield compact.xml x y z dx dy dz [in cm] [options]" << std::endl
+              << "    will dump the B-field in volume [-x:x,-y:y,-z,z] with steps [dx,dy,dz] " << std::endl
+              << "    options:" << std::endl
+              << "      -threads   <n>     number of threads (default: number of cores)" << std::endl
+              << "      -binary    <file>  write the field map to a binary file instead of printing it" << std::endl
+              << "      -compare   <file>  compare the field with a binary map written before" << std::endl
+              << "      -tolerance <t>     tolerance of the comparison in Tesla (default: 1e-6)" << std::endl;
     exit(1) ;
   }
-  
+
+  FILE* open_map(const std::string& fname, const char* mode)  {
+    FILE* f = ::fopen(fname.c_str(), mode);
+    if ( !f )  {
+      std::cout << "Cannot open field map " << fname << ": " << ::strerror(errno) << std::endl;
+      exit(errno);
+    }
+    return f;
+  }
+}
+
+static int invoke_dump_B_field(int argc, char** argv ){
+
+  if( argc < 8 ) usage();
+
   std::string inFile =  argv[1] ;
-  
+
   std::stringstream sstr ;
   sstr << argv[2] << " " << argv[3] << " " << argv[4] << " " << argv[5] << " " << argv[6] << " " << argv[7] ;
-  
-  float xRange , yRange , zRange , dx , dy, dz ;
+
+  double xRange , yRange , zRange , dx , dy, dz ;
   sstr >> xRange ;
   sstr >> yRange ;
   sstr >> zRange ;
   sstr >> dx ;
   sstr >> dy ;
   sstr >> dz ;
-  
-  
-  
+  if ( sstr.fail() || dx <= 0 || dy <= 0 || dz <= 0 ) usage();
+
+  int threads = std::thread::hardware_concurrency();
+  double tolerance = 1e-6;
+  std::string binFile, refFile;
+  for( int i = 8 ; i < argc ; ++i ){
+    if      ( ::strcmp(argv[i],"-threads")   == 0 && i+1 < argc ) threads   = ::atoi(argv[++i]);
+    else if ( ::strcmp(argv[i],"-binary")    == 0 && i+1 < argc ) binFile   = argv[++i];
+    else if ( ::strcmp(argv[i],"-compare")   == 0 && i+1 < argc ) refFile   = argv[++i];
+    else if ( ::strcmp(argv[i],"-tolerance") == 0 && i+1 < argc ) tolerance = ::atof(argv[++i]);
+    else usage();
+  }
+  if ( threads < 1 ) threads = 1;
+
+  // Grid definition: indices instead of accumulated float steps
+  FieldMapHeader hdr;
+  ::memset(&hdr, 0, sizeof(hdr));
+  ::memcpy(hdr.magic, "DDBFIELD", 8);
+  hdr.version   = 1;
+  hdr.n[0]      = (long long)std::floor(2*xRange/dx + 1e-9) + 1;
+  hdr.n[1]      = (long long)std::floor(2*yRange/dy + 1e-9) + 1;
+  hdr.n[2]      = (long long)std::floor(2*zRange/dz + 1e-9) + 1;
+  hdr.origin[0] = -xRange;  hdr.origin[1] = -yRange;  hdr.origin[2] = -zRange;
+  hdr.step[0]   = dx;       hdr.step[1]   = dy;       hdr.step[2]   = dz;
+  const long long nz = hdr.n[2], rows = hdr.n[0]*hdr.n[1];
+
+  FILE* ref = 0;
+  if ( !refFile.empty() )  {
+    FieldMapHeader rh;
+    ref = open_map(refFile, "rb");
+    if ( ::fread(&rh, sizeof(rh), 1, ref) != 1 || ::memcmp(rh.magic, hdr.magic, 8) != 0 ||
+         ::memcmp(rh.n, hdr.n, sizeof(hdr.n)) != 0 ||
+         ::memcmp(rh.origin, hdr.origin, sizeof(hdr.origin)) != 0 ||
+         ::memcmp(rh.step, hdr.step, sizeof(hdr.step)) != 0 )  {
+      std::cout << "Reference map " << refFile << " has a different format or grid." << std::endl;
+      exit(EINVAL);
+    }
+  }
+  FILE* out = 0;
+  if ( !binFile.empty() )  {
+    out = open_map(binFile, "wb");
+    if ( ::fwrite(&hdr, sizeof(hdr), 1, out) != 1 )  {
+      std::cout << "Failed to write field map header to " << binFile << std::endl;
+      exit(EIO);
+    }
+  }
+
   LCDD& lcdd = LCDD::getInstance();
   lcdd.fromCompact( inFile );
-  
-  printf("#######################################################################################################\n");
-  printf("       x[cm]             y[cm]           z[cm]           Bx[Tesla]        By[cm]          Bz[cm]       \n");
+  OverlayedField field = lcdd.field();
 
-  for( float x = -xRange ; x <=xRange ; x += dx ){
-    for( float y = -yRange ; y <=yRange ; y += dy ){
-      for( float z = -zRange ; z <=zRange ; z += dz ){
+  const bool print = !out && !ref;
+  if ( print )  {
+    printf("#######################################################################################################\n");
+    printf("       x[cm]             y[cm]           z[cm]           Bx[Tesla]        By[cm]          Bz[cm]       \n");
+  }
 
-	double posV[3] = { x, y, z }  ;
-	double bfieldV[3] ;
-	lcdd.field().magneticField( posV  , bfieldV  ) ;
+  // Process the grid in blocks of rows to limit the memory footprint
+  const long long block_rows = std::max(1LL, std::min(rows, (1LL<<20)/nz));
+  // Values are kept in double precision; only the binary map is narrowed to float
+  std::vector<double>     values(block_rows*nz*3);
+  std::vector<float>      reference(ref ? block_rows*nz*3 : 0), packed(out ? block_rows*nz*3 : 0);
+  std::vector<FieldDiff>  diffs(threads);
+  FieldDiff               total;
 
-	printf(" %+15.8e  %+15.8e  %+15.8e  %+15.8e  %+15.8e  %+15.8e  \n",
-         posV[0], posV[1],  posV[2],
-         bfieldV[0]/dd4hep::tesla , bfieldV[1]/dd4hep::tesla, bfieldV[2]/dd4hep::tesla ) ; 
+  for( long long first = 0 ; first < rows ; first += block_rows ){
+    const long long n_rows = std::min(block_rows, rows - first);
+    if ( ref && ::fread(&reference[0], sizeof(float)*3*nz, n_rows, ref) != size_t(n_rows) )  {
+      std::cout << "Reference map " << refFile << " is truncated." << std::endl;
+      exit(EIO);
+    }
+    std::atomic<long long> next_row(0);
+    auto work = [&](int id)  {
+      std::vector<double> pos(nz*3), b(nz*3);
+      FieldDiff& diff = diffs[id];
+      for( long long r = next_row++ ; r < n_rows ; r = next_row++ ){
+        long long ix = (first + r) / hdr.n[1], iy = (first + r) % hdr.n[1];
+        for( long long iz = 0 ; iz < nz ; ++iz ){
+          pos[3*iz]   = hdr.origin[0] + ix*dx;
+          pos[3*iz+1] = hdr.origin[1] + iy*dy;
+          pos[3*iz+2] = hdr.origin[2] + iz*dz;
+        }
+        field.magneticFields(nz, &pos[0], &b[0]);
+        double* v = &values[r*nz*3];
+        for( long long k = 0 ; k < nz*3 ; ++k )
+          v[k] = b[k]/dd4hep::tesla;
+        if ( ref )  {
+          const float* rv = &reference[r*nz*3];
+          for( long long iz = 0 ; iz < nz ; ++iz ){
+            // Compare at the precision of the stored map: identical fields give no difference
+            double d0 = float(v[3*iz])   - rv[3*iz];
+            double d1 = float(v[3*iz+1]) - rv[3*iz+1];
+            double d2 = float(v[3*iz+2]) - rv[3*iz+2];
+            double d  = std::sqrt(d0*d0 + d1*d1 + d2*d2);
+            ++diff.count;
+            diff.sum  += d;
+            diff.sum2 += d*d;
+            if ( d > tolerance ) ++diff.above;
+            if ( d > diff.max )  {
+              diff.max = d;
+              ::memcpy(diff.where, &pos[3*iz], sizeof(diff.where));
+            }
+          }
+        }
+      }
+    };
+    std::vector<std::thread> workers;
+    for( int i = 1 ; i < threads ; ++i ) workers.emplace_back(work, i);
+    work(0);
+    for( auto& t : workers ) t.join();
 
+    if ( out )  {
+      for( long long k = 0 ; k < n_rows*nz*3 ; ++k )
+        packed[k] = float(values[k]);
+      if ( ::fwrite(&packed[0], sizeof(float)*3*nz, n_rows, out) != size_t(n_rows) )  {
+        std::cout << "Failed to write field map to " << binFile << std::endl;
+        exit(EIO);
+      }
+    }
+    if ( print )  {
+      for( long long r = 0 ; r < n_rows ; ++r ){
+        long long ix = (first + r) / hdr.n[1], iy = (first + r) % hdr.n[1];
+        for( long long iz = 0 ; iz < nz ; ++iz ){
+          const double* v = &values[(r*nz+iz)*3];
+          printf(" %+15.8e  %+15.8e  %+15.8e  %+15.8e  %+15.8e  %+15.8e  \n",
+                 hdr.origin[0] + ix*dx, hdr.origin[1] + iy*dy, hdr.origin[2] + iz*dz, v[0], v[1], v[2]);
+        }
       }
     }
   }
-  printf("#######################################################################################################\n");  
+  if ( print )  {
+    printf("#######################################################################################################\n");
+  }
+  if ( out && ::fclose(out) != 0 )  {
+    std::cout << "Failed to close field map " << binFile << std::endl;
+    exit(EIO);
+  }
+  if ( ref )  {
+    ::fclose(ref);
+    for( const auto& d : diffs ) total.add(d);
+    double mean = total.count ? total.sum/total.count : 0;
+    double rms  = total.count ? std::sqrt(std::max(0.0, total.sum2/total.count - mean*mean)) : 0;
+    printf("Field comparison with %s: %llu points\n", refFile.c_str(), total.count);
+    printf("   |dB| mean: %.6e  rms: %.6e  max: %.6e Tesla at (%+.4e,%+.4e,%+.4e) cm\n",
+           mean, rms, std::max(0.0, total.max), total.where[0], total.where[1], total.where[2]);
+    printf("   %llu points (%.4f %%) differ by more than %.3e Tesla\n",
+           total.above, total.count ? 100.0*total.above/total.count : 0.0, tolerance);
+    return total.above ? 2 : 0;
+  }
   return 0;
 }
 
 
-
 int main(int argc, char** argv ){
   try {
     return invoke_dump_B_field(argc,argv);
@@ -88,7 +274,7 @@ int main(int argc, char** argv ){
   catch (...)  {
     std::cout << "Got UNKNOWN uncaught exception." << std::endl;
   }
-  return EINVAL;    
+  return EINVAL;
 }
 
 //=============================================================================
@@ -0,0 +1,435 @@
+//==========================================================================
+//  AIDA Detector description implementation for LCD
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+//==========================================================================
+//
+//  Multi-threaded material scan producing eta-phi maps of the
+//  integrated radiation length and nuclear interaction length.
+//
+//  Rays start at a common vertex and end where they leave a cylinder
+//  of given radius and half-length (or the world volume).
+//  Each eta-phi bin is sampled with several stratified rays. The bins
+//  are distributed over the worker threads, each owning its own
+//  TGeoNavigator. Besides the eta-phi maps the material budget
+//  versus eta is accumulated per material and per subdetector
+//  (daughter volume of the world).
+//
+//  Output:
+//  - ROOT file with histograms (-output)
+//  - Optional binary map (-binary). Layout (native byte order):
+//      char[8]   magic "DDMSCAN1"
+//      int       n_eta, n_phi, n_materials, n_subdetectors
+//      double    eta_min, eta_max, phi_min, phi_max
+//      n_materials + n_subdetectors names: int length, chars
+//      double    X0[n_eta*n_phi], lambda[n_eta*n_phi]  (phi index runs fastest)
+//      double    X0 per material[n_materials*n_eta]
+//      double    X0 per subdetector[n_subdetectors*n_eta]
+//    All values are averages over the rays of a bin in units of X0 and lambda.
+//
+//  Author     : M.Frank
+//
+//==========================================================================
+
+// Framework include files
+#include "DD4hep/LCDD.h"
+#include "DD4hep/Printout.h"
+
+// ROOT include files
+#include "TError.h"
+#include "TFile.h"
+#include "TH1D.h"
+#include "TH2D.h"
+#include "TGeoManager.h"
+#include "TGeoNavigator.h"
+#include "TGeoMaterial.h"
+#include "TGeoMedium.h"
+#include "TGeoNode.h"
+#include "TGeoVolume.h"
+
+// C/C++ include files
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "main.h"
+
+using namespace DD4hep;
+
+namespace {
+
+  /// Scan configuration
+  struct ScanConfig  {
+    std::string input, output = "materialScan.root", binary;
+    int         n_eta = 100, n_phi = 36, samples = 4, threads = 0;
+    double      eta_min = -3.0, eta_max = 3.0, phi_min = -M_PI, phi_max = M_PI;
+    double      r_max = 0.0, z_max = 0.0;
+    double      vertex[3] = {0e0, 0e0, 0e0};
+  };
+
+  /// Geometry lookup tables shared (read-only) by all workers
+  struct ScanTables  {
+    std::map<const TGeoMaterial*,int> materials;
+    std::map<const TGeoNode*,int>     subdetectors;
+    std::vector<std::string>          material_names;
+    std::vector<std::string>          subdetector_names;
+    std::vector<double>               rad_len, int_len;
+  };
+
+  /// Per-thread accumulators for the eta profiles
+  struct ScanProfiles  {
+    std::vector<double> material;     // [n_materials*n_eta]
+    std::vector<double> subdetector;  // [(n_subdetectors+1)*n_eta], last row: world volume
+    unsigned long long  rays  = 0;
+    unsigned long long  steps = 0;
+  };
+
+  /// Multi-threaded material scanner
+  /**
+   *  \author  M.Frank
+   *  \version 1.0
+   *  \ingroup DD4HEP_CORE
+   */
+  class MaterialScanner  {
+  public:
+    const ScanConfig&         cfg;
+    TGeoManager*              mgr;
+    ScanTables                tables;
+    std::vector<double>       x0, lambda;
+    std::vector<ScanProfiles> profiles;
+    std::atomic<int>          next_bin, done_bins;
+    std::atomic<bool>         failed;
+    std::mutex                lock;
+    std::string               error;
+
+    /// Initializing constructor
+    MaterialScanner(const ScanConfig& c, TGeoManager* m);
+    /// Path length from the vertex to the scan boundary along a direction
+    double pathLength(const double dir[3])  const;
+    /// Scan one ray and add the integrals to the accumulators
+    void scanRay(TGeoNavigator* nav, const double dir[3], int ieta, ScanProfiles& prof, double& sx0, double& slam)  const;
+    /// Worker thread body
+    void work(int id);
+    /// Run the scan using the configured number of threads
+    void run();
+    /// Write the results to ROOT histograms
+    void writeROOT()  const;
+    /// Write the results to the binary map file
+    void writeBinary()  const;
+  };
+
+  /// Initializing constructor
+  MaterialScanner::MaterialScanner(const ScanConfig& c, TGeoManager* m)
+    : cfg(c), mgr(m), next_bin(0), done_bins(0), failed(false)
+  {
+    TIter next(mgr->GetListOfMaterials());
+    for(TGeoMaterial* mat = (TGeoMaterial*)next(); mat; mat = (TGeoMaterial*)next())  {
+      tables.materials[mat] = tables.material_names.size();
+      tables.material_names.push_back(mat->GetName());
+      tables.rad_len.push_back(mat->GetRadLen());
+      tables.int_len.push_back(mat->GetIntLen());
+    }
+    TGeoVolume* top = mgr->GetTopVolume();
+    for(int i=0, n=top->GetNdaughters(); i<n; ++i)  {
+      TGeoNode* node = top->GetNode(i);
+      tables.subdetectors[node] = tables.subdetector_names.size();
+      tables.subdetector_names.push_back(node->GetName());
+    }
+    x0.assign(cfg.n_eta*cfg.n_phi, 0e0);
+    lambda.assign(cfg.n_eta*cfg.n_phi, 0e0);
+  }
+
+  /// Path length from the vertex to the scan boundary along a direction
+  double MaterialScanner::pathLength(const double dir[3])  const  {
+    const double* v = cfg.vertex;
+    double t = 1e30;
+    if ( cfg.z_max > 0 && std::fabs(dir[2]) > 1e-12 )  {
+      t = ((dir[2] > 0 ? cfg.z_max : -cfg.z_max) - v[2]) / dir[2];
+    }
+    double a = dir[0]*dir[0] + dir[1]*dir[1];
+    if ( cfg.r_max > 0 && a > 1e-24 )  {
+      double b = v[0]*dir[0] + v[1]*dir[1];
+      double c = v[0]*v[0] + v[1]*v[1] - cfg.r_max*cfg.r_max;
+      double d = b*b - a*c;
+      if ( d >= 0 ) t = std::min(t, (-b + std::sqrt(d)) / a);
+    }
+    return t;
+  }
+
+  /// Scan one ray and add the integrals to the accumulators
+  void MaterialScanner::scanRay(TGeoNavigator* nav, const double dir[3], int ieta,
+                                ScanProfiles& prof, double& sx0, double& slam)  const
+  {
+    const double min_step = 1e-5;
+    const int    n_sub    = tables.subdetector_names.size();
+    double total = pathLength(dir), travelled = 0e0;
+    TGeoNode* node = nav->InitTrack(cfg.vertex, dir);
+    while ( node && !nav->IsOutside() && travelled < total )  {
+      // Material and subdetector of the volume we are leaving
+      const TGeoMaterial* mat = node->GetMedium()->GetMaterial();
+      int level = nav->GetLevel();
+      const TGeoNode* det = level > 0 ? nav->GetMother(level-1) : 0;
+      nav->FindNextBoundaryAndStep(total - travelled);
+      double step = nav->GetStep();
+      if ( step < min_step )  {
+        // Protection against stalled navigation on coincident boundaries
+        const double* p = nav->GetCurrentPoint();
+        nav->SetCurrentPoint(p[0]+min_step*dir[0], p[1]+min_step*dir[1], p[2]+min_step*dir[2]);
+        nav->FindNode();
+        step = min_step;
+      }
+      step = std::min(step, total - travelled);
+      travelled += step;
+      ++prof.steps;
+      std::map<const TGeoMaterial*,int>::const_iterator im = tables.materials.find(mat);
+      if ( im == tables.materials.end() ) { node = nav->GetCurrentNode(); continue; }
+      double nx0  = step / tables.rad_len[im->second];
+      double nlam = step / tables.int_len[im->second];
+      std::map<const TGeoNode*,int>::const_iterator id = tables.subdetectors.find(det);
+      int isub = id == tables.subdetectors.end() ? n_sub : id->second;
+      sx0  += nx0;
+      slam += nlam;
+      prof.material[im->second*cfg.n_eta + ieta] += nx0;
+      prof.subdetector[isub*cfg.n_eta + ieta]    += nx0;
+      node = nav->GetCurrentNode();
+    }
+    ++prof.rays;
+  }
+
+  /// Worker thread body
+  void MaterialScanner::work(int id)  {
+    ScanProfiles& prof = profiles[id];
+    try  {
+      TGeoNavigator* nav = mgr->AddNavigator();
+      const int    n_bins = cfg.n_eta*cfg.n_phi;
+      const double d_eta  = (cfg.eta_max - cfg.eta_min) / cfg.n_eta;
+      const double d_phi  = (cfg.phi_max - cfg.phi_min) / cfg.n_phi;
+      const double norm   = 1e0 / cfg.samples;
+      for(int bin = next_bin++; bin < n_bins; bin = next_bin++)  {
+        int ieta = bin / cfg.n_phi, iphi = bin % cfg.n_phi;
+        double sx0 = 0e0, slam = 0e0;
+        for(int s=0; s<cfg.samples; ++s)  {
+          // Stratified in eta, golden ratio sequence in phi: deterministic and thread independent
+          double u   = (s + 0.5) * norm;
+          double w   = std::fmod(0.5 + s * 0.6180339887498949, 1e0);
+          double eta = cfg.eta_min + (ieta + u) * d_eta;
+          double phi = cfg.phi_min + (iphi + w) * d_phi;
+          double theta = 2e0 * std::atan(std::exp(-eta));
+          double dir[3] = { std::sin(theta)*std::cos(phi), std::sin(theta)*std::sin(phi), std::cos(theta) };
+          scanRay(nav, dir, ieta, prof, sx0, slam);
+        }
+        x0[bin]     = sx0 * norm;
+        lambda[bin] = slam * norm;
+        ++done_bins;
+      }
+    }
+    catch(const std::exception& e)  {
+      std::lock_guard<std::mutex> guard(lock);
+      error = e.what();
+      failed = true;
+      next_bin = cfg.n_eta*cfg.n_phi;
+    }
+  }
+
+  /// Run the scan using the configured number of threads
+  void MaterialScanner::run()  {
+    typedef std::chrono::steady_clock clock;
+    int n_threads = cfg.threads > 0 ? cfg.threads : std::max(1u, std::thread::hardware_concurrency());
+    int n_bins    = cfg.n_eta*cfg.n_phi;
+    size_t n_mat  = tables.material_names.size(), n_sub = tables.subdetector_names.size()+1;
+    profiles.resize(n_threads);
+    for(ScanProfiles& p : profiles)  {
+      p.material.assign(n_mat*cfg.n_eta, 0e0);
+      p.subdetector.assign(n_sub*cfg.n_eta, 0e0);
+    }
+    mgr->SetMaxThreads(n_threads);
+    printout(INFO,"MaterialScan","+++ Scanning %d x %d bins with %d rays/bin using %d threads.",
+             cfg.n_eta, cfg.n_phi, cfg.samples, n_threads);
+    clock::time_point start = clock::now();
+    std::vector<std::thread> workers;
+    for(int i=0; i<n_threads; ++i)
+      workers.emplace_back(&MaterialScanner::work, this, i);
+    for(clock::time_point last = start; done_bins < n_bins && !failed; )  {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      clock::time_point now = clock::now();
+      if ( now - last >= std::chrono::seconds(2) )  {
+        double secs = std::chrono::duration<double>(now-start).count();
+        printout(INFO,"MaterialScan","+++ Progress: %6.2f %% of the bins done. %9.0f rays/sec.",
+                 100.0*done_bins/n_bins, double(done_bins)*cfg.samples/secs);
+        last = now;
+      }
+    }
+    for(std::thread& t : workers) t.join();
+    if ( !error.empty() )  {
+      except("MaterialScan","+++ Scan failed: %s",error.c_str());
+    }
+    for(size_t i=1; i<profiles.size(); ++i)  {
+      for(size_t j=0; j<profiles[0].material.size(); ++j)
+        profiles[0].material[j] += profiles[i].material[j];
+      for(size_t j=0; j<profiles[0].subdetector.size(); ++j)
+        profiles[0].subdetector[j] += profiles[i].subdetector[j];
+      profiles[0].rays  += profiles[i].rays;
+      profiles[0].steps += profiles[i].steps;
+    }
+    // Profiles: average over the rays of one eta row
+    double norm = 1e0 / (double(cfg.n_phi) * cfg.samples);
+    for(double& v : profiles[0].material)    v *= norm;
+    for(double& v : profiles[0].subdetector) v *= norm;
+    double secs = std::chrono::duration<double>(clock::now()-start).count();
+    printout(INFO,"MaterialScan","+++ Scanned %llu rays with %llu steps in %.2f sec: %.0f rays/sec %.0f steps/sec.",
+             profiles[0].rays, profiles[0].steps, secs,
+             profiles[0].rays/secs, profiles[0].steps/secs);
+  }
+
+  /// Write the results to ROOT histograms
+  void MaterialScanner::writeROOT()  const  {
+    TFile* f = TFile::Open(cfg.output.c_str(),"RECREATE");
+    if ( !f || f->IsZombie() )  {
+      except("MaterialScan","+++ Cannot open output file %s",cfg.output.c_str());
+    }
+    TH2D* hx0  = new TH2D("X0","Radiation length;#eta;#phi;X/X_{0}",
+                          cfg.n_eta,cfg.eta_min,cfg.eta_max,cfg.n_phi,cfg.phi_min,cfg.phi_max);
+    TH2D* hlam = new TH2D("lambda","Interaction length;#eta;#phi;X/#lambda",
+                          cfg.n_eta,cfg.eta_min,cfg.eta_max,cfg.n_phi,cfg.phi_min,cfg.phi_max);
+    for(int i=0; i<cfg.n_eta; ++i)  {
+      for(int j=0; j<cfg.n_phi; ++j)  {
+        hx0->SetBinContent(i+1, j+1, x0[i*cfg.n_phi+j]);
+        hlam->SetBinContent(i+1, j+1, lambda[i*cfg.n_phi+j]);
+      }
+    }
+    f->mkdir("materials")->cd();
+    const ScanProfiles& p = profiles[0];
+    for(size_t m=0; m<tables.material_names.size(); ++m)  {
+      const double* v = &p.material[m*cfg.n_eta];
+      if ( std::count(v, v+cfg.n_eta, 0e0) == cfg.n_eta ) continue;
+      std::string nam = tables.material_names[m];
+      TH1D* h = new TH1D(("X0_"+nam).c_str(),(nam+";#eta;X/X_{0}").c_str(),cfg.n_eta,cfg.eta_min,cfg.eta_max);
+      for(int i=0; i<cfg.n_eta; ++i) h->SetBinContent(i+1, v[i]);
+    }
+    f->cd();
+    f->mkdir("subdetectors")->cd();
+    for(size_t d=0; d<=tables.subdetector_names.size(); ++d)  {
+      const double* v = &p.subdetector[d*cfg.n_eta];
+      std::string nam = d < tables.subdetector_names.size() ? tables.subdetector_names[d] : std::string("world");
+      TH1D* h = new TH1D(("X0_"+nam).c_str(),(nam+";#eta;X/X_{0}").c_str(),cfg.n_eta,cfg.eta_min,cfg.eta_max);
+      for(int i=0; i<cfg.n_eta; ++i) h->SetBinContent(i+1, v[i]);
+    }
+    f->cd();
+    f->Write();
+    f->Close();
+    delete f;
+    printout(INFO,"MaterialScan","+++ Histograms written to %s",cfg.output.c_str());
+  }
+
+  /// Write the results to the binary map file
+  void MaterialScanner::writeBinary()  const  {
+    FILE* f = ::fopen(cfg.binary.c_str(),"wb");
+    if ( !f )  {
+      except("MaterialScan","+++ Cannot open binary output file %s: %s",
+             cfg.binary.c_str(), ::strerror(errno));
+    }
+    int    hdr[4] = { cfg.n_eta, cfg.n_phi, int(tables.material_names.size()), int(tables.subdetector_names.size()) };
+    double rng[4] = { cfg.eta_min, cfg.eta_max, cfg.phi_min, cfg.phi_max };
+    bool ok = ::fwrite("DDMSCAN1",1,8,f) == 8;
+    ok = ok && ::fwrite(hdr,sizeof(hdr),1,f) == 1;
+    ok = ok && ::fwrite(rng,sizeof(rng),1,f) == 1;
+    std::vector<std::string> names(tables.material_names);
+    names.insert(names.end(), tables.subdetector_names.begin(), tables.subdetector_names.end());
+    for(const std::string& n : names)  {
+      int len = n.length();
+      ok = ok && ::fwrite(&len,sizeof(len),1,f) == 1;
+      ok = ok && ::fwrite(n.c_str(),1,len,f) == size_t(len);
+    }
+    const ScanProfiles& p = profiles[0];
+    ok = ok && ::fwrite(&x0[0],sizeof(double),x0.size(),f) == x0.size();
+    ok = ok && ::fwrite(&lambda[0],sizeof(double),lambda.size(),f) == lambda.size();
+    ok = ok && ::fwrite(&p.material[0],sizeof(double),p.material.size(),f) == p.material.size();
+    // The world volume row is not part of the binary map
+    size_t n_sub = tables.subdetector_names.size()*cfg.n_eta;
+    ok = ok && (n_sub == 0 || ::fwrite(&p.subdetector[0],sizeof(double),n_sub,f) == n_sub);
+    ok = (::fclose(f) == 0) && ok;
+    if ( !ok )  {
+      except("MaterialScan","+++ Failed to write binary output file %s",cfg.binary.c_str());
+    }
+    printout(INFO,"MaterialScan","+++ Binary map written to %s",cfg.binary.c_str());
+  }
+
+  void usage()  {
+    std::cout <<
+      " usage: parallelMaterialScan -input <compact.xml> [options]                                  \n"
+      "     -input    <file>       Geometry description file (compact xml)                      \n"
+      "     -output   <file>       ROOT output file. Default: materialScan.root                 \n"
+      "     -binary   <file>       Additionally write the binary material map                   \n"
+      "     -eta      <n> <min> <max>  Eta binning. Default: 100 -3 3                           \n"
+      "     -phi      <n> <min> <max>  Phi binning [rad]. Default: 36 -pi pi                    \n"
+      "     -samples  <n>          Number of rays per eta-phi bin. Default: 4                   \n"
+      "     -threads  <n>          Number of worker threads. Default: number of cores           \n"
+      "     -rmax     <r>          Stop rays at this radius [cm]. Default: world boundary       \n"
+      "     -zmax     <z>          Stop rays at this |z| [cm]. Default: world boundary          \n"
+      "     -vertex   <x> <y> <z>  Origin of the rays [cm]. Default: 0 0 0                     \n"
+      "        -> produces eta-phi maps of the integrated X0 and lambda                        \n"
+              << std::endl;
+    ::exit(EINVAL);
+  }
+}
+
+int main_wrapper(int argc, char** argv)   {
+  struct Handler  {
+    Handler() { SetErrorHandler(Handler::print); }
+    static void print(int level, Bool_t abort, const char *location, const char *msg)  {
+      if ( level > kInfo || abort ) ::printf("%s: %s\n", location, msg);
+    }
+  } _handler;
+  ScanConfig cfg;
+  for(int i=1; i<argc; ++i)  {
+    int left = argc-i-1;
+    if      ( ::strncmp(argv[i],"-input",4)==0   && left >= 1 ) cfg.input  = argv[++i];
+    else if ( ::strncmp(argv[i],"-output",4)==0  && left >= 1 ) cfg.output = argv[++i];
+    else if ( ::strncmp(argv[i],"-binary",4)==0  && left >= 1 ) cfg.binary = argv[++i];
+    else if ( ::strncmp(argv[i],"-samples",4)==0 && left >= 1 ) cfg.samples = ::atoi(argv[++i]);
+    else if ( ::strncmp(argv[i],"-threads",4)==0 && left >= 1 ) cfg.threads = ::atoi(argv[++i]);
+    else if ( ::strncmp(argv[i],"-rmax",4)==0    && left >= 1 ) cfg.r_max = ::atof(argv[++i]);
+    else if ( ::strncmp(argv[i],"-zmax",4)==0    && left >= 1 ) cfg.z_max = ::atof(argv[++i]);
+    else if ( ::strncmp(argv[i],"-eta",4)==0     && left >= 3 )  {
+      cfg.n_eta   = ::atoi(argv[++i]);
+      cfg.eta_min = ::atof(argv[++i]);
+      cfg.eta_max = ::atof(argv[++i]);
+    }
+    else if ( ::strncmp(argv[i],"-phi",4)==0     && left >= 3 )  {
+      cfg.n_phi   = ::atoi(argv[++i]);
+      cfg.phi_min = ::atof(argv[++i]);
+      cfg.phi_max = ::atof(argv[++i]);
+    }
+    else if ( ::strncmp(argv[i],"-vertex",4)==0  && left >= 3 )  {
+      for(int j=0; j<3; ++j) cfg.vertex[j] = ::atof(argv[++i]);
+    }
+    else
+      usage();
+  }
+  if ( cfg.input.empty() || cfg.n_eta <= 0 || cfg.n_phi <= 0 || cfg.samples <= 0 ||
+       cfg.eta_max <= cfg.eta_min || cfg.phi_max <= cfg.phi_min )  {
+    usage();
+  }
+  setPrintLevel(INFO);
+  Geometry::LCDD& lcdd = Geometry::LCDD::getInstance();
+  lcdd.fromCompact(cfg.input);
+
+  MaterialScanner scanner(cfg, lcdd.world().volume()->GetGeoManager());
+  scanner.run();
+  scanner.writeROOT();
+  if ( !cfg.binary.empty() ) scanner.writeBinary();
+  return 0;
+}
@@ -0,0 +1,91 @@
+#!/bin/python
+#==========================================================================
+#  AIDA Detector description implementation for LCD
+#--------------------------------------------------------------------------
+# Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+# All rights reserved.
+#
+# For the licensing terms see $DD4hepINSTALL/LICENSE.
+# For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+#
+#==========================================================================
+"""
+   Compare the GDML writers of DD4hep
+
+   The geometry is written once with the DOM based writer DD4hepGeometry2GDML
+   and once with the streaming writer DD4hepGeometry2GDMLStream using several
+   formatting threads. Both files are imported into ROOT and must give the
+   same number of volumes, solids and materials.
+
+   Example:
+   python GDMLWriters.py -c file:$DD4hepINSTALL/examples/ClientTests/compact/MiniTel.xml -o MiniTel
+
+   @author  M.Frank
+   @version 1.0
+"""
+import sys, errno, optparse, subprocess
+
+parser = optparse.OptionParser()
+parser.formatter.width = 132
+parser.description = "Compare the DOM based and the streaming GDML writers."
+parser.add_option("-c", "--compact", dest="compact", default=None,
+                  help="Define LCCDD style compact xml input",
+                  metavar="<FILE>")
+parser.add_option("-o", "--output", dest="output", default="geometry",
+                  help="Prefix of the GDML output files (default:geometry)",
+                  metavar="<string>")
+parser.add_option("-t", "--threads", dest="threads", default=4,
+                  help="Number of threads of the streaming writer (default:4)",
+                  metavar="<integer>")
+
+(opts, args) = parser.parse_args()
+
+if opts.compact is None:
+  print "   ",parser.format_help()
+  sys.exit(1)
+
+try:
+  import ROOT
+  from ROOT import gROOT
+  gROOT.SetBatch(1)
+except ImportError,X:
+  print 'PyROOT interface not accessible:',X
+  print parser.format_help()
+  sys.exit(errno.ENOENT)
+
+def write(plugin, output, *args):
+  """ Write the geometry with a GDML writer plugin in a separate process """
+  cmd = ['geoPluginRun', '-input', opts.compact, '-destroy', '-plugin', plugin, output] + list(args)
+  print '+++ Writing %s: %s'%(output, ' '.join(cmd),)
+  return subprocess.call(cmd)
+
+def counts(output):
+  """ Import a GDML file into ROOT and count volumes, solids and materials """
+  ROOT.TGeoManager.Import(output)
+  mgr = ROOT.gGeoManager
+  if not mgr or not mgr.GetTopVolume():
+    return None
+  return (mgr.GetListOfVolumes().GetEntries(),
+          mgr.GetListOfShapes().GetEntries(),
+          mgr.GetListOfMaterials().GetEntries())
+
+dom    = opts.output+'_dom.gdml'
+stream = opts.output+'_stream.gdml'
+if write('DD4hepGeometry2GDML', dom) != 0 or \
+   write('DD4hepGeometry2GDMLStream', stream, str(opts.threads)) != 0:
+  print '+++ GDML writers FAILED: a writer returned an error.'
+  sys.exit(1)
+
+result = {}
+for output in (dom, stream):
+  result[output] = counts(output)
+  if result[output] is None:
+    print '+++ GDML writers FAILED: %s cannot be imported.'%(output,)
+    sys.exit(1)
+  print '+++ %-32s volumes: %6d solids: %6d materials: %4d'%((output,)+result[output])
+
+if result[dom] != result[stream] or result[dom][0] == 0:
+  print '+++ GDML writers FAILED: the imported geometries differ.'
+  sys.exit(1)
+print '+++ GDML writers agree.'
+sys.exit(0)
@@ -0,0 +1,246 @@
+//==========================================================================
+//  AIDA Detector description implementation for LCD
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Frank
+//
+//==========================================================================
+/*
+   Plugin invocation:
+   ==================
+   This plugin behaves like a main program.
+   Invoke the plugin with something like this:
+
+   geoPluginRun -volmgr -destroy -plugin DD4hep_ConditionExample_binaryRepository \
+   -input file:${DD4hep_DIR}/examples/AlignDet/compact/Telescope.xml -output conditions.bin
+
+   Round trip of the binary conditions repository:
+   - populate the conditions store by hand for a set of IOVs,
+   - write the conditions of all IOVs with DD4hep_ConditionsBinaryRepositoryWriter.
+     Each IOV is requested twice to check that the conditions are written only once,
+   - clear the conditions store and reload all conditions of each IOV
+     with the loader DD4hep_Conditions_binary_Loader,
+   - compare the reloaded conditions with the original ones,
+   - check that truncated and corrupted files are rejected.
+
+*/
+// Framework include files
+#include "ConditionExampleObjects.h"
+#include "DD4hep/Factories.h"
+#include "DD4hep/PluginCreators.h"
+#include "DDCond/ConditionsDataLoader.h"
+#include "DDCond/ConditionsBinaryFormat.h"
+
+// C/C++ include files
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <map>
+
+using namespace std;
+using namespace DD4hep;
+using namespace DD4hep::ConditionExamples;
+namespace BF = DD4hep::Conditions::ConditionsBinaryFormat;
+
+namespace {
+  /// Original conditions of one IOV: key -> (name, data)
+  typedef map<Condition::key_type,pair<string,string> > Snapshot;
+
+  /// Write a modified copy of a file
+  void write_copy(const string& output, const string& content)   {
+    ofstream out(output.c_str(), ios::binary);
+    out.write(content.data(), content.length());
+    if ( !out.good() )  {
+      except("BinaryRepository","++ Failed to write file %s",output.c_str());
+    }
+  }
+  /// Check that the binary loader refuses to use a file
+  bool rejected(LCDD& lcdd, ConditionsManager mgr, const string& file, const IOV& iov, Condition::key_type key)  {
+    const void* argv[] = {"BinaryLoader", mgr.ptr(), 0};
+    dd4hep_ptr<Conditions::ConditionsDataLoader>
+      loader(createPlugin<Conditions::ConditionsDataLoader>("DD4hep_Conditions_binary_Loader",lcdd,2,argv));
+    Conditions::RangeConditions conds;
+    loader->addSource(file, iov);
+    try  {
+      loader->load_single(key, iov, conds);
+    }
+    catch(const exception& e)  {
+      printout(INFO,"BinaryRepository","++ File %s rejected: %s",file.c_str(),e.what());
+      return true;
+    }
+    printout(ERROR,"BinaryRepository","++ The invalid file %s was accepted.",file.c_str());
+    return false;
+  }
+}
+
+/// Plugin function: Condition program example
+/**
+ *  Factory: DD4hep_ConditionExample_binaryRepository
+ *
+ *  \author  M.Frank
+ *  \version 1.0
+ *  \date    01/12/2016
+ */
+static int condition_example (Geometry::LCDD& lcdd, int argc, char** argv)  {
+  string input, output = "conditions.bin";
+  int    num_iov = 3;
+  bool   arg_error = false;
+  for(int i=0; i<argc && argv[i]; ++i)  {
+    if ( 0 == ::strncmp("-input",argv[i],4) )
+      input = argv[++i];
+    else if ( 0 == ::strncmp("-output",argv[i],4) )
+      output = argv[++i];
+    else if ( 0 == ::strncmp("-iovs",argv[i],4) )
+      num_iov = ::atol(argv[++i]);
+    else
+      arg_error = true;
+  }
+  if ( arg_error || input.empty() || output.empty() || num_iov < 1 )   {
+    /// Help printout describing the basic command line interface
+    cout <<
+      "Usage: -plugin <name> -arg [-arg]                                             \n"
+      "     name:   factory name     DD4hep_ConditionExample_binaryRepository        \n"
+      "     -input   <string>        Geometry file                                   \n"
+      "     -output  <string>        Binary conditions file to be written.           \n"
+      "     -iovs    <number>        Number of IOV slices to be written.             \n"
+      "\tArguments given: " << arguments(argc,argv) << endl << flush;
+    ::exit(EINVAL);
+  }
+
+  // First we load the geometry
+  lcdd.fromXML(input);
+  installManagers(lcdd);
+
+  /******************** Initialize the conditions manager *****************/
+  ConditionsManager condMgr = ConditionsManager::from(lcdd);
+  condMgr["PoolType"]       = "DD4hep_ConditionsMappedPool";
+  condMgr["UserPoolType"]   = "DD4hep_ConditionsMapUserPool";
+  condMgr["UpdatePoolType"] = "DD4hep_ConditionsLinearUpdatePool";
+  condMgr["LoaderType"]     = "binary";
+  condMgr.initialize();
+
+  const IOVType*  iov_typ  = condMgr.registerIOVType(0,"run").second;
+  if ( 0 == iov_typ )  {
+    except("ConditionsPrepare","++ Unknown IOV type supplied.");
+  }
+
+  /******************** Populate the conditions store *********************/
+  // Have run-slices [1,20] .... with different values each
+  vector<Snapshot> snapshots(num_iov);
+  ConditionsKeys(DEBUG).process(lcdd.world(),0,true);
+  for(int i=0; i<num_iov; ++i)  {
+    ConditionsPool*   iov_pool = condMgr.registerIOV(*iov_typ, IOV::Key(1+i*20,(i+1)*20));
+    ConditionsCreator creator(condMgr, iov_pool, DEBUG);  // Use a generic creator
+    creator.process(lcdd.world(),0,true);                 // Create conditions with all deltas
+    Conditions::RangeConditions conds;
+    iov_pool->select_all(conds);
+    for( Condition& c : conds )  {
+      if ( c.type() == "derived_data" ) c.get<int>()    = 100+i;
+      if ( c.type() == "temperature" )  c.get<double>() = 1.5+i;
+      snapshots[i][c->hash] = make_pair(c->name,c.data().str());
+    }
+  }
+
+  /******************** Write the binary repository ***********************/
+  vector<string> args = { "-iov_type", "run", "-output", output };
+  for(int i=0; i<num_iov; ++i)  {
+    // Two values of the same IOV: the writer must not duplicate the conditions
+    args.push_back("-iov_value");
+    args.push_back(_toString(i*20+5));
+    args.push_back("-iov_value");
+    args.push_back(_toString(i*20+15));
+  }
+  vector<char*> writer_args;
+  for(string& a : args) writer_args.push_back(&a[0]);
+  writer_args.push_back(0);
+  lcdd.apply("DD4hep_ConditionsBinaryRepositoryWriter",int(args.size()),&writer_args[0]);
+
+  long errors = 0;
+  size_t num_conditions = 0;
+  for(const auto& s : snapshots) num_conditions += s.size();
+
+  string content;  {
+    ifstream in(output.c_str(), ios::binary);
+    stringstream str;
+    str << in.rdbuf();
+    content = str.str();
+  }
+  const BF::Header* hdr = (const BF::Header*)content.data();
+  if ( content.length() < sizeof(BF::Header) || hdr->num_entries != num_conditions )  {
+    printout(ERROR,"BinaryRepository","++ %s contains %lld entries, expected %ld",
+             output.c_str(), content.length() < sizeof(BF::Header) ? -1LL : (long long)hdr->num_entries,
+             long(num_conditions));
+    ++errors;
+  }
+
+  /******************** Reload the conditions from the repository *********/
+  condMgr.clear();
+  condMgr.loader()->addSource(output, IOV(iov_typ, IOV::Key(1,num_iov*20)));
+  dd4hep_ptr<ConditionsSlice> slice(new ConditionsSlice(condMgr));
+  for(const auto& c : snapshots[0])
+    slice->insert(ConditionKey(c.second.first,c.first),ConditionsSlice::NoLoadInfo());
+
+  for(int i=0; i<num_iov; ++i)  {
+    IOV req_iov(iov_typ,i*20+10);
+    ConditionsManager::Result r = condMgr.prepare(req_iov,*slice);
+    printout(INFO,"Prepare","Total %ld conditions (S:%ld,L:%ld,C:%ld,M:%ld) of IOV %s",
+             r.total(), r.selected, r.loaded, r.computed, r.missing, req_iov.str().c_str());
+    if ( r.missing != 0 || r.loaded != snapshots[i].size() )  {
+      printout(ERROR,"BinaryRepository","++ IOV %s: %ld conditions loaded, %ld missing. Expected %ld.",
+               req_iov.str().c_str(), r.loaded, r.missing, long(snapshots[i].size()));
+      ++errors;
+    }
+    for(const auto& s : snapshots[i])  {
+      Condition c = slice->pool->get(s.first);
+      if ( !c.isValid() )  {
+        printout(ERROR,"BinaryRepository","++ IOV %s: condition %s not loaded.",
+                 req_iov.str().c_str(), s.second.first.c_str());
+        ++errors;
+      }
+      else if ( c->name != s.second.first || c.data().str() != s.second.second )  {
+        printout(ERROR,"BinaryRepository","++ IOV %s: condition %s differs: '%s' expected '%s'",
+                 req_iov.str().c_str(), s.second.first.c_str(),
+                 c.data().str().c_str(), s.second.second.c_str());
+        ++errors;
+      }
+      else if ( c->iov->keyData != IOV::Key(1+i*20,(i+1)*20) )  {
+        printout(ERROR,"BinaryRepository","++ IOV %s: condition %s has the validity %s",
+                 req_iov.str().c_str(), c.name(), c->iov->str().c_str());
+        ++errors;
+      }
+    }
+  }
+
+  /******************** Invalid files must be rejected ********************/
+  IOV                 iov(iov_typ,10);
+  Condition::key_type key = snapshots[0].begin()->first;
+  write_copy(output+".truncated", content.substr(0,content.length()/2));
+  if ( !rejected(lcdd, condMgr, output+".truncated", iov, key) ) ++errors;
+
+  if ( content.length() >= sizeof(BF::Header) && hdr->num_entries > 0 )  {
+    string    corrupt = content;
+    BF::Entry* e = (BF::Entry*)&corrupt[hdr->entries];
+    e->data_offset = hdr->size + 1;
+    write_copy(output+".corrupt", corrupt);
+    if ( !rejected(lcdd, condMgr, output+".corrupt", iov, key) ) ++errors;
+  }
+  ::remove((output+".truncated").c_str());
+  ::remove((output+".corrupt").c_str());
+
+  printout(errors ? ERROR : INFO,"Statistics",
+           "+======= Summary: # of IOV: %3d  # of conditions: %ld  # of errors: %ld",
+           num_iov, long(num_conditions), errors);
+  if ( errors )  {
+    except("BinaryRepository","++ Binary repository round trip FAILED with %ld errors.",errors);
+  }
+  // All done.
+  return 1;
+}
+
+// first argument is the type from the xml file
+DECLARE_APPLY(DD4hep_ConditionExample_binaryRepository,condition_example)
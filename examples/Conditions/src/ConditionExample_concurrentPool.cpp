@@ -0,0 +1,216 @@
+//==========================================================================
+//  AIDA Detector description implementation for LCD
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Frank
+//
+//==========================================================================
+/*
+   Plugin invocation:
+   ==================
+   This plugin behaves like a main program.
+   Invoke the plugin with something like this:
+
+   geoPluginRun -volmgr -destroy -plugin DD4hep_ConditionExample_concurrentPool \
+   -input file:${DD4hep_DIR}/examples/AlignDet/compact/Telescope.xml -threads 8
+
+   Stress the conditions pool supporting concurrent access:
+   - several threads register conditions using the manager while
+     other threads look them up and select the pool content,
+   - several threads insert the same conditions: exactly one must win,
+   - the pool is cleared and re-filled for a number of rounds.
+
+*/
+// Framework include files
+#include "ConditionExampleObjects.h"
+#include "DD4hep/Factories.h"
+#include "DDCond/ConditionsPool.h"
+
+// C/C++ include files
+#include <typeinfo>
+#include <cstdio>
+#include <atomic>
+#include <thread>
+
+using namespace std;
+using namespace DD4hep;
+using namespace DD4hep::ConditionExamples;
+
+namespace {
+  /// Name of the condition number 'i' of writer thread 'id'
+  string cond_name(int id, int i)  {
+    char text[64];
+    ::snprintf(text,sizeof(text),"/world/concurrent_%d#value_%d",id,i);
+    return text;
+  }
+  /// Create unregistered condition
+  Condition make_condition(int id, int i)  {
+    Condition c(cond_name(id,i),"int");
+    c.bind<int>() = id*1000000+i;
+    c->hash = ConditionKey::hashCode(c->name);
+    return c;
+  }
+}
+
+/// Plugin function: Condition program example
+/**
+ *  Factory: DD4hep_ConditionExample_concurrentPool
+ *
+ *  \author  M.Frank
+ *  \version 1.0
+ *  \date    01/12/2016
+ */
+static int condition_example (Geometry::LCDD& lcdd, int argc, char** argv)  {
+  string input;
+  int    num_threads = 4, num_cond = 20000, num_rounds = 3;
+  bool   arg_error = false;
+  for(int i=0; i<argc && argv[i]; ++i)  {
+    if ( 0 == ::strncmp("-input",argv[i],4) )
+      input = argv[++i];
+    else if ( 0 == ::strncmp("-threads",argv[i],4) )
+      num_threads = ::atol(argv[++i]);
+    else if ( 0 == ::strncmp("-conditions",argv[i],4) )
+      num_cond = ::atol(argv[++i]);
+    else if ( 0 == ::strncmp("-rounds",argv[i],4) )
+      num_rounds = ::atol(argv[++i]);
+    else
+      arg_error = true;
+  }
+  if ( arg_error || input.empty() || num_threads < 1 )   {
+    /// Help printout describing the basic command line interface
+    cout <<
+      "Usage: -plugin <name> -arg [-arg]                                             \n"
+      "     name:   factory name     DD4hep_ConditionExample_concurrentPool          \n"
+      "     -input       <string>    Geometry file                                   \n"
+      "     -threads     <number>    Number of writer and reader threads.            \n"
+      "     -conditions  <number>    Number of conditions per writer thread.         \n"
+      "     -rounds      <number>    Number of fill/clear cycles.                    \n"
+      "\tArguments given: " << arguments(argc,argv) << endl << flush;
+    ::exit(EINVAL);
+  }
+
+  // First we load the geometry
+  lcdd.fromXML(input);
+  installManagers(lcdd);
+
+  /******************** Initialize the conditions manager *****************/
+  ConditionsManager condMgr = ConditionsManager::from(lcdd);
+  condMgr["PoolType"]       = "DD4hep_ConditionsConcurrentPool";
+  condMgr["UserPoolType"]   = "DD4hep_ConditionsMapUserPool";
+  condMgr["UpdatePoolType"] = "DD4hep_ConditionsLinearUpdatePool";
+  condMgr.initialize();
+
+  const IOVType*  iov_typ  = condMgr.registerIOVType(0,"run").second;
+  if ( 0 == iov_typ )  {
+    except("ConditionsPrepare","++ Unknown IOV type supplied.");
+  }
+  ConditionsPool* pool = condMgr.registerIOV(*iov_typ, IOV::Key(1,100));
+  if ( !pool->isConcurrent() )  {
+    except("ConcurrentPool","++ The pool %s does not support concurrent access.",
+           typeid(*pool).name());
+  }
+
+  atomic<long> errors(0);
+  for(int round=0; round<num_rounds; ++round)  {
+    atomic<int>    writers_done(0);
+    atomic<long>   found(0), selected(0), wins(0);
+    vector<thread> threads;
+
+    // ++++++++++++++++++++++++ Concurrent registration and lookup
+    for(int t=0; t<num_threads; ++t)  {
+      threads.emplace_back([&condMgr, pool, t, num_cond, &writers_done]()  {
+          for(int i=0; i<num_cond; ++i)
+            condMgr.registerUnlocked(pool, make_condition(t,i));
+          ++writers_done;
+        });
+      threads.emplace_back([pool, t, num_cond, num_threads, &writers_done, &found, &selected, &errors]()  {
+          // Look up the conditions of another writer while it is still busy
+          int id = (t+1)%num_threads;
+          while( writers_done.load() < num_threads )  {
+            for(int i=0; i<num_cond; i += 97)  {
+              Condition c = pool->exists(ConditionKey::hashCode(cond_name(id,i)));
+              if ( !c.isValid() ) continue;
+              ++found;
+              if ( c.get<int>() != id*1000000+i || c->pool != pool )  {
+                printout(ERROR,"ConcurrentPool","++ Corrupted condition %s",c.name());
+                ++errors;
+              }
+            }
+            Conditions::RangeConditions all;
+            pool->select_all(all);
+            selected += all.size();
+          }
+        });
+    }
+    for(auto& t : threads) t.join();
+    threads.clear();
+
+    // ++++++++++++++++++++++++ Check the content
+    size_t expected = size_t(num_threads)*size_t(num_cond);
+    if ( pool->size() != expected )  {
+      printout(ERROR,"ConcurrentPool","++ Round %d: %ld conditions in the pool, expected %ld",
+               round, long(pool->size()), long(expected));
+      ++errors;
+    }
+    Conditions::RangeConditions all;
+    pool->select_all(all);
+    if ( all.size() != expected )  {
+      printout(ERROR,"ConcurrentPool","++ Round %d: selected %ld conditions, expected %ld",
+               round, long(all.size()), long(expected));
+      ++errors;
+    }
+    for(int t=0; t<num_threads; ++t)  {
+      for(int i=0; i<num_cond; ++i)  {
+        Condition c = pool->exists(ConditionKey::hashCode(cond_name(t,i)));
+        if ( !c.isValid() || c.get<int>() != t*1000000+i )  {
+          printout(ERROR,"ConcurrentPool","++ Round %d: condition %s missing",
+                   round, cond_name(t,i).c_str());
+          ++errors;
+        }
+      }
+    }
+
+    // ++++++++++++++++++++++++ Concurrent insertion of identical keys: one insertion wins
+    for(int t=0; t<num_threads; ++t)  {
+      threads.emplace_back([pool, num_cond, &wins]()  {
+          for(int i=0; i<num_cond; i += 10)  {
+            Condition c = make_condition(-1,i);
+            if ( pool->insert(c) ) ++wins;
+            else delete c.ptr();
+          }
+        });
+    }
+    for(auto& t : threads) t.join();
+    threads.clear();
+    if ( wins.load() != (num_cond+9)/10 )  {
+      printout(ERROR,"ConcurrentPool","++ Round %d: %ld insertions of identical keys succeeded, expected %d",
+               round, wins.load(), (num_cond+9)/10);
+      ++errors;
+    }
+
+    // ++++++++++++++++++++++++ Clear requires exclusive access
+    pool->clear();
+    if ( pool->size() != 0 || pool->exists(ConditionKey::hashCode(cond_name(0,0))).isValid() )  {
+      printout(ERROR,"ConcurrentPool","++ Round %d: pool not empty after clear",round);
+      ++errors;
+    }
+    printout(INFO,"ConcurrentPool","++ Round %d: %ld conditions registered by %d threads. "
+             "%ld concurrent lookups and %ld selections succeeded.",
+             round, long(expected), num_threads, found.load(), selected.load());
+  }
+  printout(errors ? ERROR : INFO,"Statistics",
+           "+======= Summary: # of rounds: %3d  # of errors: %ld", num_rounds, errors.load());
+  if ( errors )  {
+    except("ConcurrentPool","++ Concurrent pool test FAILED with %ld errors.",errors.load());
+  }
+  // All done.
+  return 1;
+}
+
+// first argument is the type from the xml file
+DECLARE_APPLY(DD4hep_ConditionExample_concurrentPool,condition_example)
@@ -0,0 +1,181 @@
+//==========================================================================
+//  AIDA Detector description implementation for LCD
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Frank
+//
+//==========================================================================
+/*
+   Plugin invocation:
+   ==================
+   This plugin behaves like a main program.
+   Invoke the plugin with something like this:
+
+   geoPluginRun -volmgr -destroy -plugin DD4hep_ConditionExample_incremental \
+   -input file:${DD4hep_DIR}/examples/AlignDet/compact/Telescope.xml
+
+   Populate the conditions store by hand for a set of IOVs and prepare
+   the user pool with the incremental refresh enabled:
+   - within the validity of the inputs nothing may be loaded or recomputed,
+   - once the inputs expired all derived conditions must be recomputed
+     from the new inputs.
+
+*/
+// Framework include files
+#include "ConditionExampleObjects.h"
+#include "DD4hep/Factories.h"
+
+using namespace std;
+using namespace DD4hep;
+using namespace DD4hep::ConditionExamples;
+
+namespace {
+
+  /// Check the derived conditions of a detector element against their input
+  /**
+   *  \author  M.Frank
+   *  \version 1.0
+   *  \date    01/12/2016
+   */
+  struct IncrementalCheck : public Conditions::ConditionsProcessor  {
+    /// Expected value of the input condition
+    int expected;
+    /// Error counter
+    int errors = 0;
+    /// Constructor
+    IncrementalCheck(UserPool* p, int value) : ConditionsProcessor(p), expected(value) {}
+    /// Callback to process a single detector element
+    virtual int processElement(DetElement de)  override  {
+      string    path  = de.path();
+      Condition input = m_pool->get(ConditionKey(path+"#derived_data"));
+      Condition d1    = m_pool->get(ConditionKey(path+"#derived_data/derived_1"));
+      Condition d3    = m_pool->get(ConditionKey(path+"#derived_data/derived_3"));
+      if ( !input.isValid() || !d1.isValid() || !d3.isValid() )  {
+        printout(ERROR,"Incremental","++ Missing conditions for %s",path.c_str());
+        ++errors;
+      }
+      else if ( input.get<int>() != expected ||
+                d1.get<vector<int> >().at(0) != expected ||
+                d3.get<vector<int> >().at(0) != expected )  {
+        printout(ERROR,"Incremental","++ Stale derived conditions for %s: %d %d %d expected %d",
+                 path.c_str(), input.get<int>(), d1.get<vector<int> >().at(0),
+                 d3.get<vector<int> >().at(0), expected);
+        ++errors;
+      }
+      return 1;
+    }
+  };
+}
+
+/// Plugin function: Condition program example
+/**
+ *  Factory: DD4hep_ConditionExample_incremental
+ *
+ *  \author  M.Frank
+ *  \version 1.0
+ *  \date    01/12/2016
+ */
+static int condition_example (Geometry::LCDD& lcdd, int argc, char** argv)  {
+  string input;
+  int    num_iov = 5;
+  bool   arg_error = false;
+  for(int i=0; i<argc && argv[i]; ++i)  {
+    if ( 0 == ::strncmp("-input",argv[i],4) )
+      input = argv[++i];
+    else if ( 0 == ::strncmp("-iovs",argv[i],4) )
+      num_iov = ::atol(argv[++i]);
+    else
+      arg_error = true;
+  }
+  if ( arg_error || input.empty() )   {
+    /// Help printout describing the basic command line interface
+    cout <<
+      "Usage: -plugin <name> -arg [-arg]                                             \n"
+      "     name:   factory name     DD4hep_ConditionExample_incremental             \n"
+      "     -input   <string>        Geometry file                                   \n"
+      "     -iovs    <number>        Number of IOV slices to be traversed.           \n"
+      "\tArguments given: " << arguments(argc,argv) << endl << flush;
+    ::exit(EINVAL);
+  }
+
+  // First we load the geometry
+  lcdd.fromXML(input);
+  installManagers(lcdd);
+
+  /******************** Initialize the conditions manager *****************/
+  ConditionsManager condMgr = ConditionsManager::from(lcdd);
+  condMgr["PoolType"]          = "DD4hep_ConditionsMappedPool";
+  condMgr["UserPoolType"]      = "DD4hep_ConditionsMapUserPool";
+  condMgr["UpdatePoolType"]    = "DD4hep_ConditionsLinearUpdatePool";
+  condMgr["IncrementalUpdate"] = true;
+  condMgr.initialize();
+
+  const IOVType*  iov_typ  = condMgr.registerIOVType(0,"run").second;
+  if ( 0 == iov_typ )  {
+    except("ConditionsPrepare","++ Unknown IOV type supplied.");
+  }
+
+  /******************** Now as usual: create the slice ********************/
+  dd4hep_ptr<ConditionsSlice> slice(Conditions::createSlice(condMgr,*iov_typ));
+  ConditionsKeys(DEBUG).process(lcdd.world(),0,true);
+  ConditionsDependencyCreator(*slice,DEBUG).process(lcdd.world(),0,true);
+
+  /******************** Populate the conditions store *********************/
+  // Have run-slices [1,20] .... [81,100] with a different input value each
+  for(int i=0; i<num_iov; ++i)  {
+    IOV iov(iov_typ, IOV::Key(1+i*20,(i+1)*20));
+    ConditionsPool*   iov_pool = condMgr.registerIOV(*iov.iovType, iov.key());
+    ConditionsCreator creator(condMgr, iov_pool, DEBUG);  // Use a generic creator
+    creator.process(lcdd.world(),0,true);                 // Create conditions with all deltas
+    Conditions::RangeConditions conds;
+    iov_pool->select_all(conds);
+    for( Condition& c : conds )
+      if ( c.type() == "derived_data" ) c.get<int>() = 100+i;
+  }
+
+  // ++++++++++++++++++++++++ Traverse each run-slice twice
+  size_t num_derived = slice->derived().size();
+  int    errors = 0;
+  for(int i=0; i<num_iov; ++i)  {
+    for(int j=0; j<2; ++j)  {
+      IOV req_iov(iov_typ,i*20+5+j*10);
+      ConditionsManager::Result r = condMgr.prepare(req_iov,*slice);
+      IncrementalCheck check(slice->pool.get(), 100+i);
+      Scanner().scan(check,lcdd.world());
+      errors += check.errors;
+      printout(INFO,"Prepare","Total %ld conditions (S:%ld,L:%ld,C:%ld,M:%ld) of IOV %s",
+               r.total(), r.selected, r.loaded, r.computed, r.missing, req_iov.str().c_str());
+      if ( r.missing != 0 )  {
+        printout(ERROR,"Incremental","++ %ld conditions missing.",r.missing);
+        ++errors;
+      }
+      // First access of a run-slice: the inputs expired, all derived conditions are new
+      if ( j == 0 && r.computed != num_derived )  {
+        printout(ERROR,"Incremental","++ Expired inputs: %ld derived conditions computed, expected %ld.",
+                 r.computed, long(num_derived));
+        ++errors;
+      }
+      // Second access: everything is still valid and must be kept
+      else if ( j == 1 && (r.computed != 0 || r.loaded != 0) )  {
+        printout(ERROR,"Incremental","++ Valid inputs: %ld conditions loaded, %ld computed, expected none.",
+                 r.loaded, r.computed);
+        ++errors;
+      }
+    }
+  }
+  printout(errors ? ERROR : INFO,"Statistics",
+           "+======= Summary: # of IOV: %3d  # of errors: %d", num_iov, errors);
+  if ( errors )  {
+    except("Incremental","++ Incremental refresh test FAILED with %d errors.",errors);
+  }
+  // All done.
+  return 1;
+}
+
+// first argument is the type from the xml file
+DECLARE_APPLY(DD4hep_ConditionExample_incremental,condition_example)
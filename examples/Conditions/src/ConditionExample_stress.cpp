@@ -29,6 +29,7 @@
 #include "TStatistic.h"
 #include "TTimeStamp.h"
 #include "TRandom3.h"
+#include "TSystem.h"
 
 using namespace std;
 using namespace DD4hep;
@@ -90,6 +91,9 @@ static int condition_example (Geometry::LCDD& lcdd, int argc, char** argv)  {
   ConditionsDependencyCreator(*slice,DEBUG).process(lcdd.world(),0,true);
 
   TStatistic cr_stat("Creation"), acc_stat("Access");
+  ProcInfo_t mem_start, mem_stop;
+  size_t     num_cond = 0;
+  gSystem->GetProcInfo(&mem_start);
   /******************** Populate the conditions store *********************/
   // Have 10 run-slices [11,20] .... [91,100]
   for(int i=0; i<num_iov; ++i)  {
@@ -100,10 +104,12 @@ static int condition_example (Geometry::LCDD& lcdd, int argc, char** argv)  {
     creator.process(lcdd.world(),0,true);                 // Create conditions with all deltas
     TTimeStamp stop;
     cr_stat.Fill(stop.AsDouble()-start.AsDouble());
+    num_cond += creator.conditionCount;
     printout(INFO,"Example", "Setup %ld conditions for IOV:%s [%8.3f sec]",
              creator.conditionCount, iov.str().c_str(),
              stop.AsDouble()-start.AsDouble());
   }
+  gSystem->GetProcInfo(&mem_stop);
 
   // ++++++++++++++++++++++++ Now compute the conditions for each of these IOVs
   TRandom3 random;
@@ -125,6 +131,11 @@ static int condition_example (Geometry::LCDD& lcdd, int argc, char** argv)  {
            cr_stat.GetName(), cr_stat.GetMean(), cr_stat.GetMeanErr(), cr_stat.GetRMS(), cr_stat.GetN());
   printout(INFO,"Statistics","+  %-12s:  %11.5g +- %11.4g  RMS = %11.5g  N = %lld",
            acc_stat.GetName(), acc_stat.GetMean(), acc_stat.GetMeanErr(), acc_stat.GetRMS(), acc_stat.GetN());
+  if ( num_cond > 0 )  {
+    long mem_used = mem_stop.fMemResident - mem_start.fMemResident;  // kB
+    printout(INFO,"Statistics","+  %-12s:  %11ld kB for %ld conditions: %8.1f bytes/condition",
+             "Memory", mem_used, long(num_cond), double(mem_used)*1024.0/double(num_cond));
+  }
   printout(INFO,"Statistics","+=========================================================================");
   // All done.
   return 1;